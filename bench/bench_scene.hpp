@@ -0,0 +1,106 @@
+#pragma once
+
+#include "SDL.h"
+#include "SDL_image.h"
+#include "SDL_vulkan.h"
+#include "bench_utils.hpp"
+#include "sktr/sktr.hpp"
+
+namespace bench {
+
+// 编码成bmp的size*size棋盘格，可以直接LoadFromMemory或写成文件
+inline std::vector<uint8_t> MakeCheckerBmp(int size) {
+  SDL_Surface* surface =
+      SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGBA32);
+  auto pixels = static_cast<uint32_t*>(surface->pixels);
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      pixels[y * surface->pitch / 4 + x] =
+          ((x / 8 + y / 8) % 2) ? 0xFFFFFFFF : 0xFF404040;
+    }
+  }
+  std::vector<uint8_t> bmp(size * size * 4 + 1024);
+  SDL_RWops* rw = SDL_RWFromMem(bmp.data(), static_cast<int>(bmp.size()));
+  SDL_SaveBMP_RW(surface, rw, 0);
+  bmp.resize(static_cast<size_t>(SDL_RWtell(rw)));
+  SDL_RWclose(rw);
+  SDL_FreeSurface(surface);
+  return bmp;
+}
+
+// 需要GPU的基准场景：创建窗口并初始化sktr，析构时退出
+// 场景中创建的模型必须在Scene析构之前销毁
+class Scene final {
+ public:
+  // occlusionCulling: 深度附件可以被采样，GpuScene可以做遮挡剔除
+  Scene(const char* title, int width = 1024, int height = 720,
+        bool occlusionCulling = false) {
+    SDL_Init(SDL_INIT_EVERYTHING);
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG);
+    window_ = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED,
+                               SDL_WINDOWPOS_CENTERED, width, height,
+                               SDL_WINDOW_SHOWN | SDL_WINDOW_VULKAN);
+    if (!window_) {
+      throw std::runtime_error("create window failed");
+    }
+    unsigned int count;
+    SDL_Vulkan_GetInstanceExtensions(window_, &count, nullptr);
+    std::vector<const char*> extensions(count);
+    SDL_Vulkan_GetInstanceExtensions(window_, &count, extensions.data());
+    sktr::Init(
+        extensions,
+        [&](vk::Instance instance) {
+          VkSurfaceKHR surface;
+          if (!SDL_Vulkan_CreateSurface(window_, instance, &surface)) {
+            throw std::runtime_error("can't create surface");
+          }
+          return surface;
+        },
+        width, height, occlusionCulling);
+    auto& renderer = sktr::getRenderer();
+    renderer.SetDrawColor(sktr::Color{1, 1, 1});
+    renderer.SetLight({3, 3, 5}, 250);
+  }
+
+  ~Scene() {
+    sktr::Quit();
+    SDL_DestroyWindow(window_);
+    IMG_Quit();
+    SDL_Quit();
+  }
+
+  sktr::Renderer& Renderer() { return sktr::getRenderer(); }
+
+  // 先跑几帧预热，再返回frameCount帧的平均帧时间(ms)
+  // 交换链为FIFO时结果会被垂直同步限制
+  double RunFrames(int frameCount,
+                   const std::function<void(sktr::Renderer&)>& draw,
+                   int warmupCount = 10) {
+    auto& renderer = Renderer();
+    auto renderFrame = [&]() {
+      SDL_Event event;
+      while (SDL_PollEvent(&event)) {
+      }
+      if (!renderer.StartRender()) {
+        return;
+      }
+      draw(renderer);
+      renderer.EndRender();
+    };
+    for (int i = 0; i < warmupCount; i++) {
+      renderFrame();
+    }
+    sktr::Context::GetInstance().device.waitIdle();
+    auto start = Clock::now();
+    for (int i = 0; i < frameCount; i++) {
+      renderFrame();
+    }
+    sktr::Context::GetInstance().device.waitIdle();
+    return ElapsedMs(start) / frameCount;
+  }
+
+ private:
+  SDL_Window* window_ = nullptr;
+};
+
+}  // namespace bench
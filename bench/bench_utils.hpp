@@ -0,0 +1,171 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// 生成一个 n*n 格子的起伏平面，每个格子两个三角形
+inline void WriteGridObj(const std::string& path, int n) {
+  std::ofstream file(path);
+  for (int y = 0; y <= n; y++) {
+    for (int x = 0; x <= n; x++) {
+      file << "v " << x / float(n) << " " << y / float(n) << " "
+           << 0.05f * std::sin(x * 0.1f) * std::cos(y * 0.1f) << "\n";
+    }
+  }
+  for (int y = 0; y <= n; y++) {
+    for (int x = 0; x <= n; x++) {
+      file << "vt " << x / float(n) << " " << y / float(n) << "\n";
+    }
+  }
+  file << "vn 0 0 1\n";
+  for (int y = 0; y < n; y++) {
+    for (int x = 0; x < n; x++) {
+      int i0 = y * (n + 1) + x + 1;
+      int i1 = i0 + 1;
+      int i2 = i0 + n + 1;
+      int i3 = i2 + 1;
+      file << "f " << i0 << "/" << i0 << "/1 " << i1 << "/" << i1 << "/1 "
+           << i3 << "/" << i3 << "/1\n";
+      file << "f " << i0 << "/" << i0 << "/1 " << i3 << "/" << i3 << "/1 "
+           << i2 << "/" << i2 << "/1\n";
+    }
+  }
+}
+
+// 和WriteGridObj相同的网格写成.glb，interleaved时位置、法线、UV交错存放
+inline void WriteGridGlb(const std::string& path, int n, bool interleaved) {
+  const uint32_t vertexCount = (n + 1) * (n + 1);
+  const uint32_t indexCount = n * n * 6;
+  std::vector<float> positions, normals, texCoords, vertices;
+  for (int y = 0; y <= n; y++) {
+    for (int x = 0; x <= n; x++) {
+      float p[3] = {x / float(n), y / float(n),
+                    0.05f * std::sin(x * 0.1f) * std::cos(y * 0.1f)};
+      // obj的v轴朝上，glTF朝下
+      float uv[2] = {x / float(n), 1.0f - y / float(n)};
+      positions.insert(positions.end(), p, p + 3);
+      normals.insert(normals.end(), {0.0f, 0.0f, 1.0f});
+      texCoords.insert(texCoords.end(), uv, uv + 2);
+      vertices.insert(vertices.end(), p, p + 3);
+      vertices.insert(vertices.end(), {0.0f, 0.0f, 1.0f});
+      vertices.insert(vertices.end(), uv, uv + 2);
+    }
+  }
+  std::vector<uint32_t> indices;
+  for (int y = 0; y < n; y++) {
+    for (int x = 0; x < n; x++) {
+      uint32_t i0 = y * (n + 1) + x;
+      uint32_t i1 = i0 + 1;
+      uint32_t i2 = i0 + n + 1;
+      uint32_t i3 = i2 + 1;
+      indices.insert(indices.end(), {i0, i1, i3, i0, i3, i2});
+    }
+  }
+
+  std::string bin;
+  auto append = [&](const void* data, size_t size) {
+    size_t offset = bin.size();
+    bin.append(static_cast<const char*>(data), size);
+    return offset;
+  };
+  std::string views;
+  if (interleaved) {
+    auto offset = append(vertices.data(), vertices.size() * sizeof(float));
+    views = "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) +
+            ",\"byteLength\":" + std::to_string(vertices.size() * 4) +
+            ",\"byteStride\":32},";
+  } else {
+    auto p = append(positions.data(), positions.size() * sizeof(float));
+    auto nm = append(normals.data(), normals.size() * sizeof(float));
+    auto t = append(texCoords.data(), texCoords.size() * sizeof(float));
+    views = "{\"buffer\":0,\"byteOffset\":" + std::to_string(p) +
+            ",\"byteLength\":" + std::to_string(positions.size() * 4) + "}," +
+            "{\"buffer\":0,\"byteOffset\":" + std::to_string(nm) +
+            ",\"byteLength\":" + std::to_string(normals.size() * 4) + "}," +
+            "{\"buffer\":0,\"byteOffset\":" + std::to_string(t) +
+            ",\"byteLength\":" + std::to_string(texCoords.size() * 4) + "},";
+  }
+  auto indexOffset = append(indices.data(), indices.size() * sizeof(uint32_t));
+  views += "{\"buffer\":0,\"byteOffset\":" + std::to_string(indexOffset) +
+           ",\"byteLength\":" + std::to_string(indices.size() * 4) + "}";
+  bin.resize((bin.size() + 3) & ~size_t(3), '\0');
+
+  // 交错时三个属性共用bufferView 0，按byteOffset区分
+  auto attribute = [&](int view, int offset, const char* type) {
+    return "{\"bufferView\":" + std::to_string(view) +
+           ",\"byteOffset\":" + std::to_string(offset) +
+           ",\"componentType\":5126,\"count\":" + std::to_string(vertexCount) +
+           ",\"type\":\"" + type + "\"";
+  };
+  std::string accessors =
+      attribute(0, 0, "VEC3") + ",\"min\":[0,0,-0.05],\"max\":[1,1,0.05]}," +
+      attribute(interleaved ? 0 : 1, interleaved ? 12 : 0, "VEC3") + "}," +
+      attribute(interleaved ? 0 : 2, interleaved ? 24 : 0, "VEC2") + "}," +
+      "{\"bufferView\":" + std::to_string(interleaved ? 1 : 3) +
+      ",\"componentType\":5125,\"count\":" + std::to_string(indexCount) +
+      ",\"type\":\"SCALAR\"}";
+  std::string json =
+      "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,"
+      "\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+      "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,"
+      "\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+      "\"buffers\":[{\"byteLength\":" +
+      std::to_string(bin.size()) + "}],\"bufferViews\":[" + views +
+      "],\"accessors\":[" + accessors + "]}";
+  json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+  std::ofstream file(path, std::ios::binary);
+  auto writeUint32 = [&](uint32_t value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  writeUint32(0x46546C67);
+  writeUint32(2);
+  writeUint32(static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+  writeUint32(static_cast<uint32_t>(json.size()));
+  writeUint32(0x4E4F534A);
+  file.write(json.data(), json.size());
+  writeUint32(static_cast<uint32_t>(bin.size()));
+  writeUint32(0x004E4942);
+  file.write(bin.data(), bin.size());
+}
+
+// 生成一个单位UV球，rings条纬线、2*rings条经线，三角形朝外
+inline void WriteSphereObj(const std::string& path, int rings) {
+  std::ofstream file(path);
+  const float pi = 3.14159265358979f;
+  for (int i = 0; i <= rings; i++) {
+    float theta = pi * i / rings;
+    for (int j = 0; j <= rings * 2; j++) {
+      float phi = pi * j / rings;
+      float x = std::sin(theta) * std::cos(phi);
+      float y = std::sin(theta) * std::sin(phi);
+      float z = std::cos(theta);
+      file << "v " << x << " " << y << " " << z << "\n";
+      file << "vn " << x << " " << y << " " << z << "\n";
+      file << "vt " << j / float(rings * 2) << " " << i / float(rings) << "\n";
+    }
+  }
+  auto vertex = [&](int i, int j) {
+    int index = i * (rings * 2 + 1) + j + 1;
+    return std::to_string(index) + "/" + std::to_string(index) + "/" +
+           std::to_string(index);
+  };
+  for (int i = 0; i < rings; i++) {
+    for (int j = 0; j < rings * 2; j++) {
+      file << "f " << vertex(i, j) << " " << vertex(i + 1, j) << " "
+           << vertex(i + 1, j + 1) << "\n";
+      file << "f " << vertex(i, j) << " " << vertex(i + 1, j + 1) << " "
+           << vertex(i, j + 1) << "\n";
+    }
+  }
+}
+
+}  // namespace bench
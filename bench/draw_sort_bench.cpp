@@ -0,0 +1,83 @@
+// 立即录制与按状态排序后录制的绑定次数和CPU耗时对比
+// 提交顺序在模型之间交错，是排序前最差的情况
+// usage: draw_sort_bench [draw count] [frame count]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int drawCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+  int frameCount = argc > 2 ? std::atoi(argv[2]) : 100;
+  const int modelCount = 16;
+  const int textureCount = 8;
+  const int warmupCount = 10;
+
+  bench::WriteGridObj("draw_sort_cell.obj", 2);
+  bench::Scene scene("draw_sort_bench");
+  auto& renderer = scene.Renderer();
+  renderer.SetMeshletCulling(false);
+  const int side = static_cast<int>(std::ceil(std::sqrt(drawCount)));
+  renderer.SetProjection(glm::radians(60.0f), 1024 / 720.0f, 0.1f,
+                         side * 4.0f);
+  renderer.SetView(glm::vec3(side * 0.5f, -side * 0.5f, side * 0.8f),
+                   glm::vec3(side * 0.5f, side * 0.5f, 0.0f), {0, 0, 1});
+  {
+    auto bmp = bench::MakeCheckerBmp(64);
+    std::vector<sktr::Texture*> textures;
+    for (int i = 0; i < textureCount; i++) {
+      textures.push_back(sktr::TextureManager::GetInstance().LoadFromMemory(
+          bmp.data(), bmp.size()));
+    }
+    // 一半模型使用压缩顶点，对应另一条pipeline
+    std::vector<std::unique_ptr<sktr::Model>> models;
+    for (int i = 0; i < modelCount; i++) {
+      sktr::ModelLoadOptions options;
+      options.useCache = false;
+      options.vertexFormat =
+          i % 2 ? sktr::VertexFormat::ePacked : sktr::VertexFormat::eFull;
+      models.emplace_back(new sktr::Model{"cell" + std::to_string(i),
+                                          "draw_sort_cell.obj", "", options});
+      models.back()->texture = textures[i % textureCount];
+    }
+
+    auto drawAll = [&](sktr::Renderer& r) {
+      for (int i = 0; i < drawCount; i++) {
+        auto& model = *models[i % modelCount];
+        model.SetModelM(glm::translate(
+            glm::mat4(1.0f),
+            glm::vec3(float(i % side), float(i / side), 0.0f)));
+        r.DrawModel(model);
+      }
+    };
+
+    printf("%-9s | %6s %9s %11s %9s %9s | %9s\n", "mode", "draws",
+           "pipelines", "descriptors", "buffers", "saved", "cpu ms");
+    for (bool sorted : {false, true}) {
+      renderer.SetDrawSorting(sorted);
+      // 从DrawModel到提交完成，不包括等待交换链图像
+      double cpuMs = 0;
+      int measured = 0;
+      for (int frame = 0; frame < warmupCount + frameCount; frame++) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+        }
+        if (!renderer.StartRender()) {
+          continue;
+        }
+        auto start = bench::Clock::now();
+        drawAll(renderer);
+        renderer.EndRender();
+        if (frame >= warmupCount) {
+          cpuMs += bench::ElapsedMs(start);
+          measured++;
+        }
+      }
+      sktr::Context::GetInstance().device.waitIdle();
+      const auto& stats = renderer.GetFrameStats();
+      printf("%-9s | %6u %9u %11u %9u %9u | %9.3f\n",
+             sorted ? "sorted" : "immediate", stats.drawCalls,
+             stats.pipelineBinds, stats.descriptorBinds, stats.bufferBinds,
+             stats.bindsSaved, measured ? cpuMs / measured : 0.0);
+    }
+  }
+  std::remove("draw_sort_cell.obj");
+  return 0;
+}
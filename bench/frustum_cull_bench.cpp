@@ -0,0 +1,61 @@
+// CPU视锥剔除：AoS逐个判断、SoA标量和SoA SIMD的对比
+// usage: frustum_cull_bench [sphere count] [repeat count]
+#include "bench_utils.hpp"
+#include "sktr/utils/frustum.hpp"
+
+int main(int argc, char** argv) {
+  size_t sphereCount = argc > 1 ? std::atoll(argv[1]) : 1000000;
+  int repeatCount = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  // 和渲染时相同的投影，大约一半的球在视锥外
+  glm::mat4 proj =
+      glm::perspective(glm::radians(60.0f), 1024 / 720.0f, 0.1f, 200.0f);
+  proj[1][1] *= -1;
+  glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f),
+                               glm::vec3(1.0f, 0.0f, 0.0f), {0, 0, 1});
+  auto frustum = sktr::Frustum::FromMatrix(proj * view);
+
+  std::vector<glm::vec4> aos(sphereCount);
+  sktr::SphereBoundsSoA soa;
+  srand(1);
+  auto random = [](float lo, float hi) {
+    return lo + (hi - lo) * (rand() / float(RAND_MAX));
+  };
+  for (auto& sphere : aos) {
+    sphere = {random(-100, 200), random(-150, 150), random(-100, 100),
+              random(0.1f, 2.0f)};
+    soa.Push(glm::vec3(sphere), sphere.w);
+  }
+  std::vector<uint8_t> visible(sphereCount);
+
+  // 每种方法重复多次取平均，visible用最后一次的结果
+  auto run = [&](const char* name, auto&& cull) {
+    uint32_t count = 0;
+    auto start = bench::Clock::now();
+    for (int i = 0; i < repeatCount; i++) {
+      count = cull();
+    }
+    double ms = bench::ElapsedMs(start) / repeatCount;
+    printf("%-8s spheres %9zu | %8.3f ms | %8.1f Mspheres/s | visible %zu\n",
+           name, sphereCount, ms, sphereCount / ms / 1000.0, size_t(count));
+    return ms;
+  };
+
+  double aosMs = run("aos", [&]() {
+    uint32_t count = 0;
+    for (size_t i = 0; i < aos.size(); i++) {
+      visible[i] = frustum.Intersects(aos[i]);
+      count += visible[i];
+    }
+    return count;
+  });
+  double scalarMs = run("scalar", [&]() {
+    return sktr::CullSpheresScalar(frustum, soa, visible.data());
+  });
+  double simdMs = run(sktr::CullSpheresIsa(), [&]() {
+    return sktr::CullSpheres(frustum, soa, visible.data());
+  });
+  printf("%s speedup: x%.1f over aos, x%.1f over scalar\n",
+         sktr::CullSpheresIsa(), aosMs / simdMs, scalarMs / simdMs);
+  return 0;
+}
@@ -0,0 +1,77 @@
+// 对比同一网格 .obj 与 .glb(分开/交错存放) 从加载到写入staging的耗时
+// usage: gltf_bench [grid size] [repeat]
+#include "bench_utils.hpp"
+#include "sktr/mesh/gltf_loader.hpp"
+#include "sktr/mesh/obj_loader.hpp"
+
+// 模拟staging buffer，只分配一次
+static std::vector<uint8_t> staging;
+
+static double loadObj(const std::string& path, size_t& vertexCount,
+                      size_t& indexCount) {
+  auto start = bench::Clock::now();
+  auto mesh = sktr::LoadObjMesh(path, "");
+  staging.resize(mesh.vertices.size() * sizeof(sktr::Vertex) +
+                 mesh.indices.size() * sizeof(uint32_t));
+  memcpy(staging.data(), mesh.vertices.data(),
+         mesh.vertices.size() * sizeof(sktr::Vertex));
+  memcpy(staging.data() + mesh.vertices.size() * sizeof(sktr::Vertex),
+         mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+  double elapsed = bench::ElapsedMs(start);
+  vertexCount = mesh.vertices.size();
+  indexCount = mesh.indices.size();
+  return elapsed;
+}
+
+static double loadGlb(const std::string& path, double& writeMs) {
+  auto start = bench::Clock::now();
+  auto asset = sktr::LoadGltf(path);
+  auto parsed = bench::Clock::now();
+  // 不经过中间的std::vector<Vertex>
+  staging.resize(asset.vertexCount * sizeof(sktr::Vertex) +
+                 asset.indexCount * sizeof(uint32_t));
+  sktr::WriteGltfVertices(asset,
+                          reinterpret_cast<sktr::Vertex*>(staging.data()));
+  sktr::WriteGltfIndices(
+      asset, staging.data() + asset.vertexCount * sizeof(sktr::Vertex), false);
+  writeMs = bench::ElapsedMs(parsed);
+  return bench::ElapsedMs(start);
+}
+
+int main(int argc, char** argv) {
+  int gridSize = argc > 1 ? std::atoi(argv[1]) : 1000;
+  int repeat = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  const std::string objPath = "grid_bench.obj";
+  const std::string glbPath = "grid_bench.glb";
+  const std::string interleavedPath = "grid_bench_interleaved.glb";
+  bench::WriteGridObj(objPath, gridSize);
+  bench::WriteGridGlb(glbPath, gridSize, false);
+  bench::WriteGridGlb(interleavedPath, gridSize, true);
+
+  size_t vertexCount = 0, indexCount = 0;
+  double obj = std::numeric_limits<double>::max();
+  double glb = obj, glbWrite = obj, interleaved = obj, interleavedWrite = obj;
+  // 取多次中最快的一次，排除文件缓存的影响
+  for (int i = 0; i < repeat; i++) {
+    obj = std::min(obj, loadObj(objPath, vertexCount, indexCount));
+    double write;
+    glb = std::min(glb, loadGlb(glbPath, write));
+    glbWrite = std::min(glbWrite, write);
+    interleaved = std::min(interleaved, loadGlb(interleavedPath, write));
+    interleavedWrite = std::min(interleavedWrite, write);
+  }
+
+  printf("grid %d: verts %zu  tris %zu\n", gridSize, vertexCount,
+         indexCount / 3);
+  printf("  obj                 %9.2f ms\n", obj);
+  printf("  glb                 %9.2f ms  (write %.2f ms, x%.1f)\n", glb,
+         glbWrite, obj / glb);
+  printf("  glb interleaved     %9.2f ms  (write %.2f ms, x%.1f)\n",
+         interleaved, interleavedWrite, obj / interleaved);
+
+  std::remove(objPath.c_str());
+  std::remove(glbPath.c_str());
+  std::remove(interleavedPath.c_str());
+  return 0;
+}
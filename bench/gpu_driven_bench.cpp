@@ -0,0 +1,71 @@
+// 逐个DrawModel与GpuScene的GPU剔除+间接绘制在不同对象数量下的帧时间
+// usage: gpu_driven_bench [max object count] [frame count]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int maxObjectCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+  int frameCount = argc > 2 ? std::atoi(argv[2]) : 50;
+
+  bench::WriteSphereObj("gpu_driven_sphere.obj", 6);
+  bench::Scene scene("gpu_driven_bench");
+  auto& renderer = scene.Renderer();
+  renderer.SetMeshletCulling(false);
+  const auto& ctx = sktr::Context::GetInstance();
+  printf("drawIndirectCount: %s\n",
+         ctx.drawIndirectCountEnabled ? "enabled" : "fallback");
+  {
+    sktr::ModelLoadOptions options;
+    options.useCache = false;
+    sktr::Model sphere{"sphere", "gpu_driven_sphere.obj", "", options};
+    sphere.texture =
+        sktr::TextureManager::GetInstance().Load("resources/viking_room.png");
+
+    printf("%8s | %9s %10s | %9s %10s %9s\n", "objects", "cpu ms",
+           "draw calls", "gpu ms", "draw calls", "visible");
+    for (int objectCount = 1000; objectCount <= maxObjectCount;
+         objectCount *= 4) {
+      // 相机看向格子的中心，边缘的一部分在视锥外
+      const int side = static_cast<int>(std::ceil(std::sqrt(objectCount)));
+      renderer.SetProjection(glm::radians(60.0f), 1024 / 720.0f, 0.1f,
+                             side * 4.0f);
+      renderer.SetView({side * 0.5f, -side * 0.2f, side * 0.6f},
+                       {side * 0.5f, side * 0.5f, 0.0f}, {0, 0, 1});
+      std::vector<glm::mat4> transforms;
+      for (int i = 0; i < objectCount; i++) {
+        transforms.push_back(glm::scale(
+            glm::translate(glm::mat4(1.0f),
+                           glm::vec3(float(i % side), float(i / side), 0.0f)),
+            glm::vec3(0.4f)));
+      }
+
+      double cpuMs = scene.RunFrames(frameCount, [&](sktr::Renderer& r) {
+        for (const auto& transform : transforms) {
+          sphere.SetModelM(transform);
+          r.DrawModel(sphere);
+        }
+      });
+      uint32_t cpuDraws = renderer.GetFrameStats().drawCalls;
+
+      double gpuMs;
+      uint32_t gpuDraws;
+      sktr::GpuScene::CullStats cullStats;
+      {
+        sktr::GpuScene gpuScene;
+        for (const auto& transform : transforms) {
+          gpuScene.Add(sphere, transform);
+        }
+        gpuMs = scene.RunFrames(frameCount, [&](sktr::Renderer& r) {
+          r.DrawGpuScene(gpuScene);
+        });
+        gpuDraws = renderer.GetFrameStats().drawCalls;
+        // 场景不变，几帧之前的剔除结果和最后一帧相同
+        cullStats = gpuScene.GetCullStats();
+      }
+
+      printf("%8d | %9.3f %10u | %9.3f %10u %9u\n", objectCount, cpuMs,
+             cpuDraws, gpuMs, gpuDraws, cullStats.visible);
+    }
+  }
+  std::remove("gpu_driven_sphere.obj");
+  return 0;
+}
@@ -0,0 +1,55 @@
+// 逐个DrawModel与一次DrawModelInstanced绘制同样多副本的帧时间对比
+// usage: instancing_bench [instance count] [frame count]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int instanceCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+  int frameCount = argc > 2 ? std::atoi(argv[2]) : 50;
+
+  bench::Scene scene("instancing_bench");
+  auto& renderer = scene.Renderer();
+  const int side = static_cast<int>(std::ceil(std::sqrt(instanceCount)));
+  renderer.SetView({side * 1.2f, side * 1.2f, side * 0.8f},
+                   {side * 0.5f, side * 0.5f, 0.0f}, {0, 0, 1});
+  renderer.SetProjection(glm::radians(45.0f), 1024 / 720.0f, 0.1f,
+                         side * 4.0f);
+  {
+    sktr::Model viking{"viking", "models/viking_room.obj", "models/",
+                       sktr::ModelLoadOptions{}};
+    viking.texture =
+        sktr::TextureManager::GetInstance().Load("resources/viking_room.png");
+
+    std::vector<glm::mat4> transforms;
+    std::vector<sktr::Color> colors;
+    for (int i = 0; i < instanceCount; i++) {
+      transforms.push_back(glm::translate(
+          glm::mat4(1.0f), glm::vec3(float(i % side), float(i / side), 0.0f)));
+      colors.push_back(sktr::Color{(i % 7) / 6.0f, (i % 5) / 4.0f, 1.0f});
+    }
+
+    auto loop = [&](sktr::Renderer& r) {
+      for (const auto& transform : transforms) {
+        viking.SetModelM(transform);
+        r.DrawModel(viking);
+      }
+    };
+    auto instanced = [&](sktr::Renderer& r) {
+      r.DrawModelInstanced(viking, transforms, colors);
+    };
+
+    printf("%d instances, tris/frame %zu\n", instanceCount,
+           size_t(instanceCount) * viking.indexCount / 3);
+    printf("%-14s | %10s %9s\n", "mode", "draw calls", "ms/frame");
+    for (bool sorted : {false, true}) {
+      renderer.SetDrawSorting(sorted);
+      double loopMs = scene.RunFrames(frameCount, loop);
+      uint32_t loopDraws = renderer.GetFrameStats().drawCalls;
+      printf("%-14s | %10u %9.3f\n", sorted ? "loop (sorted)" : "loop",
+             loopDraws, loopMs);
+    }
+    double instancedMs = scene.RunFrames(frameCount, instanced);
+    printf("%-14s | %10u %9.3f\n", "instanced",
+           renderer.GetFrameStats().drawCalls, instancedMs);
+  }
+  return 0;
+}
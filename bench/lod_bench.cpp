@@ -0,0 +1,47 @@
+// 不同相机距离下选中的LOD、三角形数和帧时间
+// usage: lod_bench [grid size] [frame count]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int gridSize = argc > 1 ? std::atoi(argv[1]) : 512;
+  int frameCount = argc > 2 ? std::atoi(argv[2]) : 200;
+
+  bench::WriteGridObj("grid.obj", gridSize);
+  bench::Scene scene("lod_bench");
+  auto& renderer = scene.Renderer();
+  renderer.SetProjection(glm::radians(45.0f), 1024 / 720.0f, 0.1f, 500.0f);
+  {
+    sktr::ModelLoadOptions options;
+    options.lodCount = 8;
+    sktr::Model grid{"grid", "grid.obj", "", options};
+    grid.texture =
+        sktr::TextureManager::GetInstance().Load("resources/viking_room.png");
+    // 格子在[0, 1]，移到原点
+    grid.SetModelM(
+        glm::translate(glm::mat4(1.0f), glm::vec3(-0.5f, -0.5f, 0.0f)));
+
+    auto draw = [&grid](sktr::Renderer& r) { r.DrawModel(grid); };
+    printf("%10s | %5s %10s %9s | %10s %9s\n", "distance", "lod", "tris",
+           "ms/frame", "lod0 tris", "ms/frame");
+    for (float distance : {1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f}) {
+      const glm::vec3 eye = glm::normalize(glm::vec3(1.0f, 1.0f, 0.8f)) *
+                            distance;
+      renderer.SetView(eye, glm::vec3(0.0f), {0, 0, 1});
+
+      renderer.SetLodThreshold(1.0f);
+      double lodMs = scene.RunFrames(frameCount, draw);
+      auto lodStats = renderer.GetFrameStats();
+      uint32_t lod = renderer.SelectLod(grid);
+
+      // 阈值为0时总是LOD0
+      renderer.SetLodThreshold(0.0f);
+      double fullMs = scene.RunFrames(frameCount, draw);
+      auto fullStats = renderer.GetFrameStats();
+
+      printf("%10.1f | %5u %10llu %9.3f | %10llu %9.3f\n", distance, lod,
+             (unsigned long long)lodStats.triangles, lodMs,
+             (unsigned long long)fullStats.triangles, fullMs);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,58 @@
+// 对比 .obj 冷加载 与 二进制缓存热加载 的耗时
+// usage: mesh_cache_bench [grid size]
+#include "bench_utils.hpp"
+#include "sktr/mesh/mesh_cache.hpp"
+#include "sktr/mesh/obj_loader.hpp"
+
+static void benchModel(const std::string& path, const std::string& mtlPath) {
+  const auto cachePath = sktr::MeshCache::CachePath(path);
+  std::remove(cachePath.c_str());
+  std::vector<uint8_t> staging;
+
+  auto start = bench::Clock::now();
+  auto mesh = sktr::LoadObjMesh(path, mtlPath);
+  staging.resize(mesh.vertices.size() * sizeof(sktr::Vertex) +
+                 mesh.indices.size() * sizeof(uint32_t));
+  memcpy(staging.data(), mesh.vertices.data(),
+         mesh.vertices.size() * sizeof(sktr::Vertex));
+  memcpy(staging.data() + mesh.vertices.size() * sizeof(sktr::Vertex),
+         mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+  double cold = bench::ElapsedMs(start);
+
+  auto hash = sktr::MeshCache::HashSource(path, mtlPath);
+  start = bench::Clock::now();
+  sktr::MeshCache::Write(cachePath, mesh, hash, 0);
+  double write = bench::ElapsedMs(start);
+
+  start = bench::Clock::now();
+  hash = sktr::MeshCache::HashSource(path, mtlPath);
+  auto cached = sktr::MeshCache::Load(cachePath, hash, 0);
+  if (!cached) {
+    std::cout << path << ": cache load failed" << std::endl;
+    return;
+  }
+  memcpy(staging.data(), cached->vertices,
+         cached->vertexCount * sizeof(sktr::Vertex));
+  memcpy(staging.data() + cached->vertexCount * sizeof(sktr::Vertex),
+         cached->indices, cached->indexCount * sizeof(uint32_t));
+  double warm = bench::ElapsedMs(start);
+
+  printf("%-28s verts %9zu  tris %9zu  cold %9.2f ms  write %8.2f ms  warm "
+         "%8.2f ms  (x%.1f)\n",
+         path.c_str(), mesh.vertices.size(), mesh.indices.size() / 3, cold,
+         write, warm, cold / warm);
+}
+
+int main(int argc, char** argv) {
+  int gridSize = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+  benchModel("models/viking_room.obj", "models/");
+
+  const std::string gridPath = "grid_bench.obj";
+  bench::WriteGridObj(gridPath, gridSize);
+  benchModel(gridPath, "");
+
+  std::remove(gridPath.c_str());
+  std::remove(sktr::MeshCache::CachePath(gridPath).c_str());
+  return 0;
+}
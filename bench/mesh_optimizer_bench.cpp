@@ -0,0 +1,73 @@
+// 加载时网格优化：顶点缓存、overdraw、顶点获取顺序
+// usage: mesh_optimizer_bench [grid size]
+#include <random>
+
+#include "bench_utils.hpp"
+#include "sktr/mesh/mesh_optimizer.hpp"
+#include "sktr/mesh/obj_loader.hpp"
+
+// 三角形按位置排序后比较，确认优化只改变了顺序
+static std::vector<std::array<sktr::Vertex, 3>> sortedTriangles(
+    const sktr::MeshData& mesh) {
+  std::vector<std::array<sktr::Vertex, 3>> triangles;
+  for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+    std::array<sktr::Vertex, 3> tri = {mesh.vertices[mesh.indices[i]],
+                                       mesh.vertices[mesh.indices[i + 1]],
+                                       mesh.vertices[mesh.indices[i + 2]]};
+    // 旋转到最小的顶点在前，保持环绕方向
+    auto less = [](const sktr::Vertex& a, const sktr::Vertex& b) {
+      return memcmp(&a, &b, sizeof(sktr::Vertex)) < 0;
+    };
+    std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end(), less),
+                tri.end());
+    triangles.push_back(tri);
+  }
+  std::sort(triangles.begin(), triangles.end(),
+            [](const auto& a, const auto& b) {
+              return memcmp(a.data(), b.data(), sizeof(a)) < 0;
+            });
+  return triangles;
+}
+
+static void shuffleTriangles(sktr::MeshData& mesh) {
+  std::mt19937 rng(42);
+  size_t triangleCount = mesh.indices.size() / 3;
+  for (size_t i = triangleCount - 1; i > 0; i--) {
+    size_t j = rng() % (i + 1);
+    std::swap_ranges(mesh.indices.begin() + i * 3,
+                     mesh.indices.begin() + i * 3 + 3,
+                     mesh.indices.begin() + j * 3);
+  }
+}
+
+static void benchMesh(const char* name, sktr::MeshData mesh) {
+  auto reference = sortedTriangles(mesh);
+
+  auto start = bench::Clock::now();
+  auto stats = sktr::OptimizeMesh(mesh);
+  double optimizeMs = bench::ElapsedMs(start);
+
+  bool identical = sortedTriangles(mesh) == reference;
+  printf("%-16s tris %8zu | ACMR %.3f -> %.3f | ATVR %.3f -> %.3f | "
+         "%8.2f ms | %s\n",
+         name, mesh.indices.size() / 3, stats.before.acmr, stats.after.acmr,
+         stats.before.atvr, stats.after.atvr, optimizeMs,
+         identical ? "same triangles" : "TRIANGLES CHANGED");
+}
+
+int main(int argc, char** argv) {
+  int gridSize = argc > 1 ? std::atoi(argv[1]) : 512;
+  printf("simulated FIFO cache size %u\n", sktr::SimulatedCacheSize);
+
+  auto viking = sktr::LoadObjMesh("models/viking_room.obj", "models/");
+  benchMesh("viking_room", viking);
+  shuffleTriangles(viking);
+  benchMesh("viking_shuffled", viking);
+
+  bench::WriteGridObj("grid.obj", gridSize);
+  auto grid = sktr::LoadObjMesh("grid.obj", "");
+  benchMesh("grid", grid);
+  shuffleTriangles(grid);
+  benchMesh("grid_shuffled", grid);
+  return 0;
+}
@@ -0,0 +1,52 @@
+// meshlet视锥/法线锥剔除：不同视角下可见的meshlet比例和帧时间
+// usage: meshlet_bench [sphere rings] [frame count]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int rings = argc > 1 ? std::atoi(argv[1]) : 256;
+  int frameCount = argc > 2 ? std::atoi(argv[2]) : 200;
+
+  bench::WriteSphereObj("sphere.obj", rings);
+  bench::Scene scene("meshlet_bench");
+  auto& renderer = scene.Renderer();
+  renderer.SetProjection(glm::radians(45.0f), 1024 / 720.0f, 0.01f, 100.0f);
+  {
+    sktr::ModelLoadOptions options;
+    options.optimize = true;
+    options.buildMeshlets = true;
+    sktr::Model sphere{"sphere", "sphere.obj", "", options};
+    sphere.texture =
+        sktr::TextureManager::GetInstance().Load("resources/viking_room.png");
+
+    auto draw = [&sphere](sktr::Renderer& r) { r.DrawModel(sphere); };
+    struct View {
+      const char* name;
+      glm::vec3 eye;
+      glm::vec3 center;
+    };
+    // 远处只有背面剔除起作用，贴近表面时大部分meshlet在视锥外
+    const View views[] = {
+        {"far", {0.0f, -4.0f, 1.0f}, {0.0f, 0.0f, 0.0f}},
+        {"near", {0.0f, -1.3f, 0.0f}, {0.0f, 0.0f, 0.0f}},
+        {"surface", {0.0f, -1.05f, 0.0f}, {1.0f, -1.0f, 0.0f}}};
+
+    printf("%zu tris, %u meshlets\n", size_t(sphere.indexCount / 3),
+           sphere.meshletCount);
+    printf("%10s | %8s %8s %9s | %9s\n", "view", "meshlets", "visible",
+           "ms/frame", "no cull");
+    for (const auto& view : views) {
+      renderer.SetView(view.eye, view.center, {0, 0, 1});
+
+      renderer.SetMeshletCulling(true);
+      double cullMs = scene.RunFrames(frameCount, draw);
+      auto stats = renderer.GetMeshletCullStats();
+
+      renderer.SetMeshletCulling(false);
+      double fullMs = scene.RunFrames(frameCount, draw);
+
+      printf("%10s | %8u %8u %9.3f | %9.3f\n", view.name, stats.total,
+             stats.visible, cullMs, fullMs);
+    }
+  }
+  return 0;
+}
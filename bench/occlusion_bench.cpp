@@ -0,0 +1,67 @@
+// GpuScene只做视锥剔除与两个阶段遮挡剔除的帧时间和剔除结果
+// 一面墙挡住后面大量的小球，只有墙上方的一部分可见
+// usage: occlusion_bench [object count] [frame count]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int objectCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+  int frameCount = argc > 2 ? std::atoi(argv[2]) : 50;
+
+  bench::WriteSphereObj("occlusion_sphere.obj", 6);
+  bench::Scene scene("occlusion_bench", 1024, 720, true);
+  auto& renderer = scene.Renderer();
+  renderer.SetMeshletCulling(false);
+  const auto& ctx = sktr::Context::GetInstance();
+  printf("drawIndirectCount: %s\n",
+         ctx.drawIndirectCountEnabled ? "enabled" : "fallback");
+  {
+    sktr::ModelLoadOptions options;
+    options.useCache = false;
+    sktr::Model sphere{"sphere", "occlusion_sphere.obj", "", options};
+    sphere.texture =
+        sktr::TextureManager::GetInstance().Load("resources/viking_room.png");
+
+    // 相机在墙前面平视，墙后的小球铺在地面上向远处延伸
+    const int side = static_cast<int>(std::ceil(std::sqrt(objectCount)));
+    renderer.SetProjection(glm::radians(60.0f), 1024 / 720.0f, 0.1f,
+                           side * 4.0f);
+    renderer.SetView({side * 0.5f, -8.0f, 2.0f}, {side * 0.5f, side, 2.0f},
+                     {0, 0, 1});
+
+    sktr::GpuScene gpuScene;
+    // 墙由放大的球拼成，宽度覆盖整个视野，高度挡住大约3/4的画面
+    for (int x = -side; x < side * 2; x += 4) {
+      for (int z = 0; z < 6; z += 2) {
+        gpuScene.Add(sphere,
+                     glm::scale(glm::translate(glm::mat4(1.0f),
+                                               glm::vec3(float(x), 0.0f,
+                                                         float(z))),
+                                glm::vec3(3.0f)));
+      }
+    }
+    for (int i = 0; i < objectCount; i++) {
+      gpuScene.Add(sphere,
+                   glm::scale(glm::translate(glm::mat4(1.0f),
+                                             glm::vec3(float(i % side),
+                                                       float(i / side) + 4.0f,
+                                                       0.0f)),
+                              glm::vec3(0.4f)));
+    }
+
+    printf("%10s | %9s %10s | %9s %9s %11s\n", "occlusion", "gpu ms",
+           "draw calls", "visible", "occluded", "disoccluded");
+    for (bool occlusion : {false, true}) {
+      renderer.SetOcclusionCulling(occlusion);
+      double ms = scene.RunFrames(frameCount, [&](sktr::Renderer& r) {
+        r.DrawGpuScene(gpuScene);
+      });
+      // 场景不变，几帧之前的剔除结果和最后一帧相同
+      const auto& stats = gpuScene.GetCullStats();
+      printf("%10s | %9.3f %10u | %9u %9u %11u\n", occlusion ? "on" : "off",
+             ms, renderer.GetFrameStats().drawCalls, stats.visible,
+             stats.occluded, stats.disoccluded);
+    }
+  }
+  std::remove("occlusion_sphere.obj");
+  return 0;
+}
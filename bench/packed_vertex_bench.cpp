@@ -0,0 +1,53 @@
+// PackedVertex 与 Vertex 的显存占用和帧时间对比
+// usage: packed_vertex_bench [grid size] [frame count]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int gridSize = argc > 1 ? std::atoi(argv[1]) : 20;
+  int frameCount = argc > 2 ? std::atoi(argv[2]) : 300;
+
+  bench::Scene scene("packed_vertex_bench");
+  auto& renderer = scene.Renderer();
+  renderer.SetView({gridSize * 1.2f, gridSize * 1.2f, gridSize * 0.8f},
+                   {gridSize * 0.5f, gridSize * 0.5f, 0.0f}, {0, 0, 1});
+  renderer.SetProjection(glm::radians(45.0f), 1024 / 720.0f, 0.1f,
+                         gridSize * 4.0f);
+  {
+    sktr::ModelLoadOptions options;
+    sktr::Model full{"viking_full", "models/viking_room.obj", "models/",
+                     options};
+    options.vertexFormat = sktr::VertexFormat::ePacked;
+    sktr::Model packed{"viking_packed", "models/viking_room.obj", "models/",
+                       options};
+    auto* texture =
+        sktr::TextureManager::GetInstance().Load("resources/viking_room.png");
+    full.texture = texture;
+    packed.texture = texture;
+
+    // 同一个模型在gridSize*gridSize个位置各画一次
+    auto drawGrid = [gridSize](sktr::Model* model) {
+      return [model, gridSize](sktr::Renderer& r) {
+        for (int y = 0; y < gridSize; y++) {
+          for (int x = 0; x < gridSize; x++) {
+            model->SetModelM(glm::translate(glm::mat4(1.0f),
+                                            glm::vec3(x, y, 0.0f)));
+            r.DrawModel(*model);
+          }
+        }
+      };
+    };
+
+    double fullMs = scene.RunFrames(frameCount, drawGrid(&full));
+    double packedMs = scene.RunFrames(frameCount, drawGrid(&packed));
+
+    printf("draws/frame %d, tris/frame %zu\n", gridSize * gridSize,
+           size_t(gridSize) * gridSize * full.indexCount / 3);
+    printf("%-14s vertex buffer %8llu bytes (%2u B/vert) | %7.3f ms/frame\n",
+           full.name.c_str(), (unsigned long long)full.VertexBufferSize(),
+           sktr::VertexStride(full.vertexFormat), fullMs);
+    printf("%-14s vertex buffer %8llu bytes (%2u B/vert) | %7.3f ms/frame\n",
+           packed.name.c_str(), (unsigned long long)packed.VertexBufferSize(),
+           sktr::VertexStride(packed.vertexFormat), packedMs);
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+// 顶点去重的多线程扩展性，只用CPU
+// usage: parallel_load_bench [grid size] [max threads]
+#include "bench_utils.hpp"
+#include "sktr/mesh/obj_loader.hpp"
+#include "sktr/utils/thread_pool.hpp"
+
+static bool sameMesh(const sktr::MeshData& a, const sktr::MeshData& b) {
+  return a.vertices.size() == b.vertices.size() && a.indices == b.indices &&
+         memcmp(a.vertices.data(), b.vertices.data(),
+                a.vertices.size() * sizeof(sktr::Vertex)) == 0;
+}
+
+int main(int argc, char** argv) {
+  int gridSize = argc > 1 ? std::atoi(argv[1]) : 1500;
+  uint32_t maxThreads = argc > 2 ? std::atoi(argv[2])
+                                 : sktr::ThreadPool::HardwareThreads();
+
+  const std::string gridPath = "grid_bench.obj";
+  bench::WriteGridObj(gridPath, gridSize);
+
+  sktr::ObjLoadOptions options;
+  sktr::ObjLoadStats stats;
+  options.threadCount = 1;
+  auto reference = sktr::LoadObjMesh(gridPath, "", options, &stats);
+  const double baseline = stats.weldMs;
+  printf("grid %d: verts %zu  tris %zu  parse %.2f ms (single threaded)\n",
+         gridSize, reference.vertices.size(), reference.indices.size() / 3,
+         stats.parseMs);
+  printf("%8s %8s %12s %9s %s\n", "threads", "chunks", "weld(ms)", "speedup",
+         "identical");
+
+  for (uint32_t threads = 1; threads <= maxThreads;
+       threads = threads < maxThreads ? std::min(threads * 2, maxThreads)
+                                      : threads + 1) {
+    options.threadCount = threads;
+    auto mesh = sktr::LoadObjMesh(gridPath, "", options, &stats);
+    printf("%8u %8u %12.2f %8.2fx %s\n", threads, stats.chunkCount,
+           stats.weldMs, baseline / stats.weldMs,
+           sameMesh(reference, mesh) ? "yes" : "NO");
+  }
+
+  std::remove(gridPath.c_str());
+  return 0;
+}
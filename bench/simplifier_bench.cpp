@@ -0,0 +1,38 @@
+// QEM简化生成的LOD链：每级三角形数、误差和耗时
+// usage: simplifier_bench [grid size] [lod count]
+#include "bench_utils.hpp"
+#include "sktr/mesh/mesh_simplifier.hpp"
+#include "sktr/mesh/obj_loader.hpp"
+
+static void benchMesh(const char* name, sktr::MeshData mesh,
+                      uint32_t lodCount) {
+  auto start = bench::Clock::now();
+  sktr::GenerateLods(mesh, lodCount);
+  double ms = bench::ElapsedMs(start);
+
+  const glm::vec3 extent = mesh.bounds.max - mesh.bounds.min;
+  const float size = std::max(std::max(extent.x, extent.y), extent.z);
+  printf("%s: %zu verts, %zu lods, %.2f ms\n", name, mesh.vertices.size(),
+         mesh.lods.size(), ms);
+  for (size_t i = 0; i < mesh.lods.size(); i++) {
+    const auto& lod = mesh.lods[i];
+    size_t indexCount = 0;
+    for (uint32_t s = 0; s < lod.subMeshCount; s++) {
+      indexCount += mesh.subMeshes[lod.firstSubMesh + s].indexCount;
+    }
+    printf("  lod %zu  tris %9zu  error %.6f (%.4f%% of size)\n", i,
+           indexCount / 3, lod.error, 100.0f * lod.error / size);
+  }
+}
+
+int main(int argc, char** argv) {
+  int gridSize = argc > 1 ? std::atoi(argv[1]) : 256;
+  uint32_t lodCount = argc > 2 ? std::atoi(argv[2]) : 6;
+
+  benchMesh("viking_room",
+            sktr::LoadObjMesh("models/viking_room.obj", "models/"), lodCount);
+
+  bench::WriteGridObj("grid.obj", gridSize);
+  benchMesh("grid", sktr::LoadObjMesh("grid.obj", ""), lodCount);
+  return 0;
+}
@@ -0,0 +1,60 @@
+// 批量加载小模型和贴图，对比每次上传单独创建staging并等待与使用StagingRing
+// usage: staging_bench [model count] [texture count] [grid size]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int modelCount = argc > 1 ? std::atoi(argv[1]) : 1000;
+  int textureCount = argc > 2 ? std::atoi(argv[2]) : 1000;
+  int gridSize = argc > 3 ? std::atoi(argv[3]) : 8;
+
+  const std::string path = "staging_bench_grid.glb";
+  bench::WriteGridGlb(path, gridSize, false);
+
+  bench::Scene scene("staging_bench");
+  auto& ctx = sktr::Context::GetInstance();
+  auto bmp = bench::MakeCheckerBmp(64);
+  sktr::ModelLoadOptions options;
+  options.useCache = false;
+
+  auto run = [&](bool enabled) {
+    ctx.stagingRing->SetEnabled(enabled);
+    ctx.device.waitIdle();
+    std::vector<std::unique_ptr<sktr::Model>> models;
+    models.reserve(modelCount);
+    auto start = bench::Clock::now();
+    for (int i = 0; i < modelCount; i++) {
+      models.emplace_back(new sktr::Model{"grid", path, "", options});
+    }
+    ctx.stagingRing->Flush();
+    double modelMs = bench::ElapsedMs(start);
+
+    std::vector<sktr::Texture*> textures;
+    start = bench::Clock::now();
+    for (int i = 0; i < textureCount; i++) {
+      textures.push_back(sktr::TextureManager::GetInstance().LoadFromMemory(
+          bmp.data(), bmp.size()));
+    }
+    ctx.stagingRing->Flush();
+    double textureMs = bench::ElapsedMs(start);
+
+    printf("%-8s %d models %9.2f ms (%6.3f ms each) | %d textures %9.2f ms "
+           "(%6.3f ms each)\n",
+           enabled ? "ring" : "per-copy", modelCount, modelMs,
+           modelMs / modelCount, textureCount, textureMs,
+           textureMs / textureCount);
+
+    ctx.device.waitIdle();
+    for (auto texture : textures) {
+      sktr::TextureManager::GetInstance().Destroy(texture);
+    }
+    models.clear();
+  };
+
+  run(false);
+  run(true);
+  printf("ring %llu MB, retired %u, stalls %u\n",
+         (unsigned long long)(ctx.stagingRing->Capacity() >> 20),
+         ctx.stagingRing->RetiredCount(), ctx.stagingRing->StallCount());
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,51 @@
+// 逐个Load与LoadBatch加载同样数量贴图的耗时对比
+// usage: texture_batch_bench [texture count] [texture size]
+#include "bench_scene.hpp"
+
+int main(int argc, char** argv) {
+  int textureCount = argc > 1 ? std::atoi(argv[1]) : 500;
+  int textureSize = argc > 2 ? std::atoi(argv[2]) : 256;
+
+  bench::Scene scene("texture_batch_bench");
+  auto& ctx = sktr::Context::GetInstance();
+  auto& textureManager = sktr::TextureManager::GetInstance();
+
+  // 同一张图片写成多个文件，和实际批量加载一样逐个读取解码
+  auto bmp = bench::MakeCheckerBmp(textureSize);
+  std::vector<std::string> paths;
+  for (int i = 0; i < textureCount; i++) {
+    paths.push_back("texture_batch_bench_" + std::to_string(i) + ".bmp");
+    std::ofstream file(paths.back(), std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bmp.data()), bmp.size());
+  }
+
+  auto run = [&](const char* name, bool batch) {
+    ctx.device.waitIdle();
+    auto start = bench::Clock::now();
+    std::vector<sktr::Texture*> textures;
+    if (batch) {
+      textures = textureManager.LoadBatch(paths);
+    } else {
+      for (const auto& path : paths) {
+        textures.push_back(textureManager.Load(path));
+      }
+    }
+    ctx.stagingRing->Flush();
+    double ms = bench::ElapsedMs(start);
+    printf("%-8s %d textures %dx%d %9.2f ms (%6.3f ms each)\n", name,
+           textureCount, textureSize, textureSize, ms, ms / textureCount);
+    for (auto texture : textures) {
+      textureManager.Destroy(texture);
+    }
+  };
+
+  run("single", false);
+  run("batch", true);
+  printf("transfer queue: %s\n",
+         ctx.stagingRing->DedicatedQueue() ? "dedicated" : "graphics");
+
+  for (const auto& path : paths) {
+    std::remove(path.c_str());
+  }
+  return 0;
+}
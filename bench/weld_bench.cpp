@@ -0,0 +1,88 @@
+// 顶点焊接：std::unordered_map 与 WeldTable 的对比
+// usage: weld_bench [index count of the synthetic mesh]
+#include "bench_utils.hpp"
+#include "sktr/mesh/obj_loader.hpp"
+#include "sktr/mesh/weld_table.hpp"
+
+// 展开成未去重的三角形顶点流，和解析.obj后得到的一样
+static std::vector<sktr::Vertex> expandCorners(const sktr::MeshData& mesh) {
+  std::vector<sktr::Vertex> corners;
+  corners.reserve(mesh.indices.size());
+  for (auto index : mesh.indices) {
+    corners.push_back(mesh.vertices[index]);
+  }
+  return corners;
+}
+
+// n*n的格子，每个格子6个顶点，法线在折痕处不同
+static std::vector<sktr::Vertex> gridCorners(size_t indexCount) {
+  int n = static_cast<int>(std::sqrt(indexCount / 6.0));
+  std::vector<sktr::Vertex> corners;
+  corners.reserve(size_t(n) * n * 6);
+  auto makeVertex = [&](int x, int y, int cell) {
+    sktr::Vertex v{};
+    v.pos = {x / float(n), y / float(n), 0.0f};
+    v.color = {1.0f, 1.0f, 1.0f};
+    v.normal = cell % 7 == 0 ? glm::vec3{0.0f, 0.6f, 0.8f}
+                             : glm::vec3{0.0f, 0.0f, 1.0f};
+    v.texCoord = {x / float(n), y / float(n)};
+    return v;
+  };
+  for (int y = 0; y < n; y++) {
+    for (int x = 0; x < n; x++) {
+      int cell = y * n + x;
+      corners.push_back(makeVertex(x, y, cell));
+      corners.push_back(makeVertex(x + 1, y, cell));
+      corners.push_back(makeVertex(x + 1, y + 1, cell));
+      corners.push_back(makeVertex(x, y, cell));
+      corners.push_back(makeVertex(x + 1, y + 1, cell));
+      corners.push_back(makeVertex(x, y + 1, cell));
+    }
+  }
+  return corners;
+}
+
+static void benchCorners(const char* name,
+                         const std::vector<sktr::Vertex>& corners) {
+  std::vector<uint32_t> indices(corners.size());
+
+  auto start = bench::Clock::now();
+  std::unordered_map<sktr::Vertex, uint32_t> uniqueVertices{};
+  std::vector<sktr::Vertex> vertices;
+  for (size_t i = 0; i < corners.size(); i++) {
+    if (uniqueVertices.count(corners[i]) == 0) {
+      uniqueVertices[corners[i]] = static_cast<uint32_t>(vertices.size());
+      vertices.push_back(corners[i]);
+    }
+    indices[i] = uniqueVertices[corners[i]];
+  }
+  double mapMs = bench::ElapsedMs(start);
+
+  start = bench::Clock::now();
+  sktr::WeldTable exact(corners.size());
+  for (size_t i = 0; i < corners.size(); i++) {
+    indices[i] = exact.Insert(corners[i]).first;
+  }
+  double exactMs = bench::ElapsedMs(start);
+
+  start = bench::Clock::now();
+  sktr::WeldTable quantized(corners.size(), sktr::WeldMode::eQuantized, 1e-4f);
+  for (size_t i = 0; i < corners.size(); i++) {
+    indices[i] = quantized.Insert(corners[i]).first;
+  }
+  double quantizedMs = bench::ElapsedMs(start);
+
+  printf("%-12s indices %9zu | unordered_map %9.2f ms (%zu verts) | "
+         "exact %8.2f ms (%zu verts, x%.1f) | quantized %8.2f ms (%zu verts)\n",
+         name, corners.size(), mapMs, vertices.size(), exactMs, exact.Size(),
+         mapMs / exactMs, quantizedMs, quantized.Size());
+}
+
+int main(int argc, char** argv) {
+  size_t indexCount = argc > 1 ? std::atoll(argv[1]) : 5000000;
+
+  auto viking = sktr::LoadObjMesh("models/viking_room.obj", "models/");
+  benchCorners("viking_room", expandCorners(viking));
+  benchCorners("grid", gridCorners(indexCount));
+  return 0;
+}
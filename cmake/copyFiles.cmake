@@ -11,9 +11,27 @@ macro(CopyShader target_name)
     add_custom_command(
         TARGET ${target_name} POST_BUILD
         COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/vert.spv $<TARGET_FILE_DIR:${target_name}>/shaders/vert.spv)
+    add_custom_command(
+        TARGET ${target_name} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/vert_instanced.spv $<TARGET_FILE_DIR:${target_name}>/shaders/vert_instanced.spv)
     add_custom_command(
         TARGET ${target_name} POST_BUILD
         COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/frag.spv $<TARGET_FILE_DIR:${target_name}>/shaders/frag.spv)
+    add_custom_command(
+        TARGET ${target_name} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/meshlet_cull.spv $<TARGET_FILE_DIR:${target_name}>/shaders/meshlet_cull.spv)
+    add_custom_command(
+        TARGET ${target_name} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/object_cull.spv $<TARGET_FILE_DIR:${target_name}>/shaders/object_cull.spv)
+    add_custom_command(
+        TARGET ${target_name} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/object_cull_occlusion.spv $<TARGET_FILE_DIR:${target_name}>/shaders/object_cull_occlusion.spv)
+    add_custom_command(
+        TARGET ${target_name} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/depth_reduce.spv $<TARGET_FILE_DIR:${target_name}>/shaders/depth_reduce.spv)
+    add_custom_command(
+        TARGET ${target_name} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E copy ${PROJECT_SOURCE_DIR}/shaders/depth_reduce_ms.spv $<TARGET_FILE_DIR:${target_name}>/shaders/depth_reduce_ms.spv)
 endmacro(CopyShader)
 
 macro(CopyTexture target_name)
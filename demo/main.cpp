@@ -81,6 +81,13 @@ int main(int argc, char** argv) {
       sktr::Model{"viking", "models/viking_room.obj", "models/"};
   viking.texture =
       sktr::TextureManager::GetInstance().Load("resources/viking_room.png");
+  std::cout << "[memory] " << sktr::getMemoryStats() << std::endl;
+  for (const auto& report : sktr::getMemoryUsageReport()) {
+    std::cout << "[memory] " << report << std::endl;
+  }
+  for (const auto& budget : sktr::getMemoryBudgets()) {
+    std::cout << "[memory] " << budget << std::endl;
+  }
 
   bool shouldClose = false;
   SDL_Event event;
@@ -153,11 +160,10 @@ int main(int argc, char** argv) {
   }
 
   sktr::TextureManager::GetInstance().Destroy(viking.texture);
-  viking.vertexBuffer.reset();
-  viking.indicesBuffer.reset();
+  viking.Release();
 
   // todo: Material manager
-  viking.material.reset();
+  viking.materials.clear();
 
   sktr::Quit();
   SDL_DestroyWindow(window);
@@ -26,7 +26,7 @@ layout(push_constant) uniform PushConstant {
 } pc;
 
 void main() {
-  vec3 color =pow(texture(texSampler, fragTexCoord).rgb, vec3(2.2));   
+  vec3 color =pow(texture(texSampler, fragTexCoord).rgb, vec3(2.2)) * fragColor;
   vec3 ambient = 0.05 * color;
   vec3 lightDir = normalize(light.position - fragPos);
   vec3 normal = normalize(fragNormal);
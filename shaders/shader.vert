@@ -5,10 +5,19 @@ layout(set=0, binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
+// 为true时输入是PackedVertex: unorm16位置, 八面体法线, half uv
+layout(constant_id = 0) const bool PackedVertex = false;
+
+// color恒为白色，不再从顶点读取
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec2 inTexCoord;
+// 编译两次，INSTANCED时模型矩阵和颜色按实例从binding 1读取，
+// 不使用push constant。只有实例化的pipeline提供，mat4占4到7
+#ifdef INSTANCED
+layout(location = 4) in mat4 inInstanceModel;
+layout(location = 8) in vec4 inInstanceColor;
+#endif
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
@@ -17,14 +26,36 @@ layout(location = 3) out vec3 fragNormal;
 
 layout(push_constant) uniform PushConstant{
     mat4 model;
+    layout(offset = 80) vec4 posOffset;
+    vec4 posScale;
 }pc;
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 void main() {
     // float myfloat = 3.1415f;
     // debugPrintfEXT("My float is %f", myfloat);
-    gl_Position = ubo.proj * ubo.view * pc.model *  vec4(inPosition,  1.0);
-    fragPos = inPosition;
-    fragColor = inColor;
+    vec3 position = inPosition;
+    vec3 normal = inNormal;
+    if (PackedVertex) {
+        position = pc.posOffset.xyz + inPosition * pc.posScale.xyz;
+        normal = octDecode(inNormal.xy);
+    }
+#ifdef INSTANCED
+    mat4 model = inInstanceModel;
+    fragColor = inInstanceColor.rgb;
+#else
+    mat4 model = pc.model;
+    fragColor = vec3(1.0);
+#endif
+    gl_Position = ubo.proj * ubo.view * model *  vec4(position,  1.0);
+    fragPos = position;
     fragTexCoord = inTexCoord;
-    fragNormal = inNormal;
-}
\ No newline at end of file
+    fragNormal = normal;
+}
@@ -144,6 +144,7 @@ void Context::pickupPhysicalDevice() {
   for (const auto& device : devices) {
     if (isDeviceSuitable(device)) {
       phyDevice = device;
+      memoryProperties = device.getMemoryProperties();
       queueFamilyIndices = queryQueueFamilyIndices(device);
       sampler.msaaSamples = getMaxUsableSampleCount();
       break;
@@ -182,15 +183,38 @@ void Context::createDevice() {
         .setQueueFamilyIndex(queueFamilyIndices.presentQueue.value());
     deviceQueueInfos.push_back(deviceQueueInfo);
   }
+  if (queueFamilyIndices.transferQueue) {
+    vk::DeviceQueueCreateInfo deviceQueueInfo;
+    deviceQueueInfo.setPQueuePriorities(&prior)
+        .setQueueCount(1)
+        .setQueueFamilyIndex(queueFamilyIndices.transferQueue.value());
+    deviceQueueInfos.push_back(deviceQueueInfo);
+  }
 
   // 采样
   vk::PhysicalDeviceFeatures deviceFeatures{};
   deviceFeatures.samplerAnisotropy = vk::True;
   // enable sample shading feature for the device
   deviceFeatures.sampleRateShading = vk::True;
+  // meshlet剔除后一次drawIndexedIndirect提交多条命令，不支持时逐条提交
+  deviceFeatures.multiDrawIndirect = phyDevice.getFeatures().multiDrawIndirect;
+  enabledFeatures = deviceFeatures;
+
+  // 上传批次用timeline semaphore通知完成，1.2的核心特性
+  vk::PhysicalDeviceVulkan12Features features12;
+  features12.timelineSemaphore = vk::True;
+  // GPU剔除后用drawIndexedIndirectCount读取可见数量，不支持时提交所有命令
+  drawIndirectCountEnabled =
+      phyDevice
+          .getFeatures2<vk::PhysicalDeviceFeatures2,
+                        vk::PhysicalDeviceVulkan12Features>()
+          .get<vk::PhysicalDeviceVulkan12Features>()
+          .drawIndirectCount;
+  features12.drawIndirectCount = drawIndirectCountEnabled;
 
   deviceInfo.setQueueCreateInfos(deviceQueueInfos)
-      .setPEnabledFeatures(&deviceFeatures);
+      .setPEnabledFeatures(&deviceFeatures)
+      .setPNext(&features12);
 
   // 加入Swapchain的拓展
   std::vector<const char*> extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
@@ -199,6 +223,12 @@ void Context::createDevice() {
     extensions.insert(extensions.end(), DeviceExtensions.begin(),
                       DeviceExtensions.end());
   }
+  // 可选：查询各堆的预算，没有时按堆大小估计
+  memoryBudgetEnabled =
+      isDeviceExtensionAvailable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  if (memoryBudgetEnabled) {
+    extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  }
   deviceInfo.setPEnabledExtensionNames(extensions);
 
   device = phyDevice.createDevice(deviceInfo);
@@ -206,6 +236,10 @@ void Context::createDevice() {
   // 从硬件中获取queue，并且队列只有一个则下标为0
   graphicsQueue = device.getQueue(queueFamilyIndices.graphicsQueue.value(), 0);
   presentQueue = device.getQueue(queueFamilyIndices.presentQueue.value(), 0);
+  transferQueue = queueFamilyIndices.transferQueue
+                      ? device.getQueue(queueFamilyIndices.transferQueue.value(),
+                                        0)
+                      : graphicsQueue;
 }
 
 QueueFamilyIndices Context::queryQueueFamilyIndices(
@@ -228,6 +262,15 @@ QueueFamilyIndices Context::queryQueueFamilyIndices(
       break;
     }
   }
+  // 只有传输能力的队列族一般对应独立的DMA引擎，拷贝不占用图形队列
+  for (int i = 0; i < properties.size(); i++) {
+    const auto& flags = properties[i].queueFlags;
+    auto general = vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute;
+    if ((flags & vk::QueueFlagBits::eTransfer) && !(flags & general)) {
+      queueFamilyIndices_.transferQueue = i;
+      break;
+    }
+  }
   return queueFamilyIndices_;
 }
 
@@ -299,6 +342,15 @@ bool Context::checkDeviceExtensionSupport(vk::PhysicalDevice physicalDevice) {
   return requiredExtensions.empty();
 }
 
+bool Context::isDeviceExtensionAvailable(const char* name) {
+  for (const auto& extension : phyDevice.enumerateDeviceExtensionProperties()) {
+    if (strcmp(extension.extensionName, name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 SwapChainSupportDetails Context::QuerySwapChainSupport(
     vk::PhysicalDevice device) {
   SwapChainSupportDetails details;
@@ -3,9 +3,13 @@
 #include "renderer.hpp"
 #include "sktr/pch.hpp"
 #include "sktr/system/command_manager.hpp"
+#include "sktr/system/deletion_queue.hpp"
+#include "sktr/system/geometry_pool.hpp"
+#include "sktr/system/memory_allocator.hpp"
 #include "sktr/system/render_process.hpp"
 #include "sktr/system/sampler.hpp"
 #include "sktr/system/shader.hpp"
+#include "sktr/system/staging_ring.hpp"
 #include "sktr/system/swapchain.hpp"
 #include "sktr/utils/common.hpp"
 #include "sktr/utils/singlton.hpp"
@@ -16,15 +20,35 @@ class Context final : public Singlton<Context> {
  public:
   vk::Instance instance;
   vk::PhysicalDevice phyDevice = nullptr;
+  // 选择物理设备时查询一次，之后不会变化
+  vk::PhysicalDeviceMemoryProperties memoryProperties;
   vk::Device device;
   vk::Queue graphicsQueue;
   vk::Queue presentQueue;
+  // 没有独立的传输队列族时和graphicsQueue相同
+  vk::Queue transferQueue;
   vk::SurfaceKHR surface = nullptr;
   std::unique_ptr<Swapchain> swapchain;
   std::unique_ptr<RenderProcess> renderProcess;
   std::unique_ptr<Renderer> renderer;
   std::unique_ptr<CommandManager> commandManager;
+  // Buffer和image的设备内存都从这里分配，要最后销毁
+  std::unique_ptr<MemoryAllocator> memoryAllocator;
+  // 上传数据用的staging，在commandManager之后创建、之前销毁
+  std::unique_ptr<StagingRing> stagingRing;
+  // 卸载的资源在引用它的帧执行完之后销毁
+  std::unique_ptr<DeletionQueue> deletionQueue;
+  // 模型的顶点和索引从这里分配
+  std::unique_ptr<GeometryPool> geometryPool;
   QueueFamilyIndices queueFamilyIndices;
+  // 创建逻辑设备时开启的特性
+  vk::PhysicalDeviceFeatures enabledFeatures;
+  // 开启了VK_EXT_memory_budget，可以查询驱动给出的各堆预算
+  bool memoryBudgetEnabled = false;
+  // 开启了Vulkan 1.2的drawIndirectCount
+  bool drawIndirectCountEnabled = false;
+  // 初始化时选择，深度附件可以保存和采样，用于GpuScene的遮挡剔除
+  bool occlusionCullingEnabled = false;
   Sampler sampler;
   bool windowMinimized = false;
   bool frameBufferResized = false;
@@ -37,6 +61,10 @@ class Context final : public Singlton<Context> {
   void InitSwapchain(int w, int h) { swapchain.reset(new Swapchain{w, h}); }
   void InitRenderer(int w, int h) { renderer.reset(new Renderer{w, h}); }
   void InitCommandPool() { commandManager.reset(new CommandManager); }
+  void InitMemoryAllocator() { memoryAllocator.reset(new MemoryAllocator); }
+  void InitStagingRing() { stagingRing.reset(new StagingRing); }
+  void InitDeletionQueue() { deletionQueue.reset(new DeletionQueue); }
+  void InitGeometryPool() { geometryPool.reset(new GeometryPool); }
   void InitRenderProcess(int w, int h) {
     renderProcess.reset(new RenderProcess{w, h});
   }
@@ -46,6 +74,10 @@ class Context final : public Singlton<Context> {
   void DestroySwapchain() { swapchain.reset(); }
   void DestroyRenderer() { renderer.reset(); }
   void DestroyCommandPool() { commandManager.reset(); }
+  void DestroyMemoryAllocator() { memoryAllocator.reset(); }
+  void DestroyStagingRing() { stagingRing.reset(); }
+  void DestroyDeletionQueue() { deletionQueue.reset(); }
+  void DestroyGeometryPool() { geometryPool.reset(); }
   void DestroyRenderProcess() { renderProcess.reset(); }
   void DestroySampler() { device.destroySampler(sampler.sampler); }
 
@@ -62,6 +94,7 @@ class Context final : public Singlton<Context> {
 
   QueueFamilyIndices queryQueueFamilyIndices(vk::PhysicalDevice physicalDevice);
   bool checkDeviceExtensionSupport(vk::PhysicalDevice);
+  bool isDeviceExtensionAvailable(const char *name);
   bool isDeviceSuitable(vk::PhysicalDevice);
   vk::SampleCountFlagBits getMaxUsableSampleCount();
 };
@@ -0,0 +1,210 @@
+#include "gpu_scene.hpp"
+
+#include "context.hpp"
+
+namespace sktr {
+
+GpuScene::~GpuScene() {
+  auto& ctx = Context::GetInstance();
+  for (auto& frame : frames_) {
+    if (!frame.inputSet.set) {
+      continue;
+    }
+    auto sets = {frame.inputSet, frame.outputSet};
+    if (!ctx.deletionQueue) {
+      for (const auto& set : sets) {
+        DescriptorSetManager::GetInstance().FreeStorageBufferSet(set);
+      }
+      continue;
+    }
+    // 正在执行的帧可能还在使用
+    for (const auto& set : sets) {
+      ctx.deletionQueue->Push([set]() {
+        DescriptorSetManager::GetInstance().FreeStorageBufferSet(set);
+      });
+    }
+    ctx.deletionQueue->Push(std::move(frame.instances));
+    ctx.deletionQueue->Push(std::move(frame.draws));
+    ctx.deletionQueue->Push(std::move(frame.commands));
+    ctx.deletionQueue->Push(std::move(frame.counts));
+    ctx.deletionQueue->Push(std::move(frame.occluded));
+  }
+}
+
+uint32_t GpuScene::Add(const Model& model, const glm::mat4& transform,
+                       const Color& color) {
+  const uint32_t object = static_cast<uint32_t>(instances_.size());
+  instances_.push_back({transform, glm::vec4(color, 1.0f)});
+
+  DrawEntry draw{};
+  const glm::vec3 center = (model.bounds.min + model.bounds.max) * 0.5f;
+  draw.sphere = glm::vec4(
+      center, glm::length(model.bounds.max - model.bounds.min) * 0.5f);
+  draw.object = object;
+  auto addDraw = [&](const Material& material, uint32_t indexCount,
+                     uint32_t firstIndex, int32_t vertexOffset) {
+    draw.indexCount = indexCount;
+    draw.firstIndex = model.firstIndex + firstIndex;
+    draw.vertexOffset = model.baseVertex + vertexOffset;
+    draw.bucket = findBucket(model, material);
+    draw.slot = buckets_[draw.bucket].drawCount++;
+    draws_.push_back(draw);
+  };
+  if (model.subMeshes.empty()) {
+    addDraw(*model.materials.back(), model.indexCount, 0, 0);
+  } else {
+    const auto& lod = model.lods[0];
+    for (uint32_t i = 0; i < lod.subMeshCount; i++) {
+      const auto& subMesh = model.subMeshes[lod.firstSubMesh + i];
+      addDraw(model.MaterialOf(subMesh), subMesh.indexCount,
+              subMesh.firstIndex, subMesh.vertexOffset);
+    }
+  }
+  layoutDirty_ = true;
+  version_++;
+  return object;
+}
+
+void GpuScene::SetTransform(uint32_t object, const glm::mat4& transform) {
+  instances_[object].model = transform;
+  version_++;
+}
+
+void GpuScene::Clear() {
+  instances_.clear();
+  draws_.clear();
+  buckets_.clear();
+  version_++;
+}
+
+uint32_t GpuScene::findBucket(const Model& model, const Material& material) {
+  // 通常连续加入同一个模型，从后往前找
+  for (size_t i = buckets_.size(); i > 0; i--) {
+    if (buckets_[i - 1].model == &model &&
+        buckets_[i - 1].material == &material) {
+      return static_cast<uint32_t>(i - 1);
+    }
+  }
+  buckets_.push_back({&model, &material, 0, 0});
+  return static_cast<uint32_t>(buckets_.size() - 1);
+}
+
+GpuScene::FrameResources& GpuScene::prepare(uint32_t frameIndex) {
+  if (frames_.size() <= frameIndex) {
+    frames_.resize(frameIndex + 1);
+  }
+  auto& frame = frames_[frameIndex];
+  auto& cullPipeline =
+      *Context::GetInstance().renderProcess->objectCullPipeline;
+  if (!frame.inputSet.set) {
+    frame.inputSet = DescriptorSetManager::GetInstance().AllocStorageBufferSet(
+        cullPipeline.setLayouts[0]);
+    frame.outputSet =
+        DescriptorSetManager::GetInstance().AllocStorageBufferSet(
+            cullPipeline.setLayouts[1]);
+  }
+
+  // fence之后这一帧上次的剔除结果已经写完，多出来的计数都是0
+  if (frame.counts) {
+    auto counts = static_cast<uint32_t*>(frame.counts->map);
+    const uint32_t buckets = frame.dispatchedBuckets;
+    cullStats_ = CullStats{};
+    cullStats_.total = frame.dispatched;
+    for (uint32_t i = 0; i < buckets; i++) {
+      cullStats_.visible += counts[i] + counts[buckets + i];
+      cullStats_.disoccluded += counts[buckets + i];
+    }
+    cullStats_.occluded = counts[buckets * 2];
+  }
+
+  if (layoutDirty_) {
+    uint32_t offset = 0;
+    for (auto& bucket : buckets_) {
+      bucket.commandOffset = offset;
+      offset += bucket.drawCount;
+    }
+    for (auto& draw : draws_) {
+      draw.commandOffset = buckets_[draw.bucket].commandOffset;
+    }
+    layoutDirty_ = false;
+  }
+
+  if (frame.version != version_) {
+    bool recreated = false;
+    recreated |= reserve(
+        frame.instances, sizeof(InstanceData) * instances_.size(),
+        vk::BufferUsageFlagBits::eVertexBuffer |
+            vk::BufferUsageFlagBits::eStorageBuffer,
+        MemoryUsage::eCpuToGpu);
+    recreated |= reserve(frame.draws, sizeof(DrawEntry) * draws_.size(),
+                         vk::BufferUsageFlagBits::eStorageBuffer,
+                         MemoryUsage::eCpuToGpu);
+    recreated |= reserve(frame.commands,
+                         sizeof(vk::DrawIndexedIndirectCommand) *
+                             draws_.size() * 2,
+                         vk::BufferUsageFlagBits::eStorageBuffer |
+                             vk::BufferUsageFlagBits::eIndirectBuffer,
+                         MemoryUsage::eGpuOnly);
+    recreated |= reserve(frame.counts,
+                         sizeof(uint32_t) * (buckets_.size() * 2 + 1),
+                         vk::BufferUsageFlagBits::eStorageBuffer |
+                             vk::BufferUsageFlagBits::eIndirectBuffer,
+                         MemoryUsage::eGpuToCpu);
+    recreated |= reserve(frame.occluded, sizeof(uint32_t) * draws_.size(),
+                         vk::BufferUsageFlagBits::eStorageBuffer,
+                         MemoryUsage::eGpuOnly);
+    memcpy(frame.instances->map, instances_.data(),
+           sizeof(InstanceData) * instances_.size());
+    memcpy(frame.draws->map, draws_.data(), sizeof(DrawEntry) * draws_.size());
+    if (recreated) {
+      updateDescriptorSets(frame);
+    }
+    frame.version = version_;
+  }
+  memset(frame.counts->map, 0, frame.counts->size);
+  frame.dispatched = DrawCount();
+  frame.dispatchedBuckets = BucketCount();
+  return frame;
+}
+
+bool GpuScene::reserve(std::unique_ptr<Buffer>& buffer, size_t size,
+                       vk::BufferUsageFlags usage, MemoryUsage memoryUsage) {
+  if (buffer && buffer->size >= size) {
+    return false;
+  }
+  size_t capacity = buffer ? buffer->size * 2 : 4096;
+  while (capacity < size) {
+    capacity *= 2;
+  }
+  // 这一帧之前录制的命令可能还在引用旧的buffer
+  Context::GetInstance().deletionQueue->Push(std::move(buffer));
+  buffer.reset(new Buffer{capacity, usage, memoryUsage});
+  return true;
+}
+
+void GpuScene::updateDescriptorSets(FrameResources& frame) {
+  std::array<vk::DescriptorBufferInfo, 5> bufferInfos;
+  bufferInfos[0].setBuffer(frame.instances->buffer).setOffset(0).setRange(
+      VK_WHOLE_SIZE);
+  bufferInfos[1].setBuffer(frame.draws->buffer).setOffset(0).setRange(
+      VK_WHOLE_SIZE);
+  bufferInfos[2].setBuffer(frame.commands->buffer).setOffset(0).setRange(
+      VK_WHOLE_SIZE);
+  bufferInfos[3].setBuffer(frame.counts->buffer).setOffset(0).setRange(
+      VK_WHOLE_SIZE);
+  bufferInfos[4].setBuffer(frame.occluded->buffer).setOffset(0).setRange(
+      VK_WHOLE_SIZE);
+  std::array<vk::WriteDescriptorSet, 5> writeInfos;
+  for (uint32_t i = 0; i < writeInfos.size(); i++) {
+    writeInfos[i]
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(bufferInfos[i])
+        .setDstBinding(i < 2 ? i : i - 2)
+        .setDstSet(i < 2 ? frame.inputSet.set : frame.outputSet.set)
+        .setDstArrayElement(0)
+        .setDescriptorCount(1);
+  }
+  Context::GetInstance().device.updateDescriptorSets(writeInfos, {});
+}
+
+}  // namespace sktr
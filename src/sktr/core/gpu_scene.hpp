@@ -0,0 +1,116 @@
+#pragma once
+
+#include "model.hpp"
+#include "sktr/pch.hpp"
+#include "sktr/system/buffer.hpp"
+#include "sktr/system/descriptor_manager.hpp"
+#include "sktr/utils/math.hpp"
+
+namespace sktr {
+
+/*
+ * GPU驱动绘制的对象集合
+ *
+ * 对象的模型矩阵、包围球和每个subMesh的绘制项放在storage buffer中，
+ * Renderer::DrawGpuScene用compute做视锥剔除，写出间接绘制命令，
+ * 每个材质桶只录制一次drawIndexedIndirectCount。CPU的开销和对象数量无关。
+ * 开启遮挡剔除时分两个阶段，每个阶段每个桶各一次间接绘制。
+ * 模型矩阵同时作为实例化pipeline的binding 1，firstInstance就是对象编号。
+ * 修改后在下一次绘制时复制到这一帧的buffer中，模型要在GpuScene销毁之后才能释放
+ */
+class GpuScene final {
+ public:
+  // 剔除结果要等GPU执行完才能读回，是maxFlightCount帧之前的结果
+  struct CullStats {
+    uint32_t total = 0;
+    uint32_t visible = 0;
+    // 两个阶段都被遮挡而没有绘制的
+    uint32_t occluded = 0;
+    // 按上一帧被遮挡，第二阶段重新测试后可见的，包含在visible中
+    uint32_t disoccluded = 0;
+  };
+
+  GpuScene() = default;
+  ~GpuScene();
+
+  GpuScene(const GpuScene&) = delete;
+  GpuScene& operator=(const GpuScene&) = delete;
+
+  // 绘制LOD0，返回对象编号
+  uint32_t Add(const Model& model, const glm::mat4& transform,
+               const Color& color = {1, 1, 1});
+  void SetTransform(uint32_t object, const glm::mat4& transform);
+  void Clear();
+
+  uint32_t ObjectCount() const {
+    return static_cast<uint32_t>(instances_.size());
+  }
+  // 剔除前的绘制命令数
+  uint32_t DrawCount() const { return static_cast<uint32_t>(draws_.size()); }
+  uint32_t BucketCount() const {
+    return static_cast<uint32_t>(buckets_.size());
+  }
+  const CullStats& GetCullStats() const { return cullStats_; }
+
+ private:
+  friend class Renderer;
+
+  // 和object_cull.comp一致
+  struct DrawEntry {
+    // 模型坐标下的包围球
+    glm::vec4 sphere;
+    uint32_t object;
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t bucket;
+    // 桶在命令buffer中的起点
+    uint32_t commandOffset;
+    // 在桶中的位置，不紧凑写入时使用
+    uint32_t slot;
+    uint32_t padding;
+  };
+  // 同一个模型和材质的绘制项，一次间接绘制
+  struct Bucket {
+    const Model* model;
+    const Material* material;
+    uint32_t commandOffset;
+    uint32_t drawCount;
+  };
+  // 每个正在执行的帧一份，CPU直接写入。
+  // commands和counts有两个阶段各一段，counts最后是被遮挡的数量
+  struct FrameResources {
+    std::unique_ptr<Buffer> instances;
+    std::unique_ptr<Buffer> draws;
+    std::unique_ptr<Buffer> commands;
+    std::unique_ptr<Buffer> counts;
+    // 每个绘制项在第一阶段是否被遮挡
+    std::unique_ptr<Buffer> occluded;
+    DescriptorSetManager::SetInfo inputSet;
+    DescriptorSetManager::SetInfo outputSet;
+    // 和version_相同时不需要复制
+    uint64_t version = 0;
+    // 上次绘制的命令数和桶数，用于读回剔除结果
+    uint32_t dispatched = 0;
+    uint32_t dispatchedBuckets = 0;
+  };
+
+  std::vector<InstanceData> instances_;
+  std::vector<DrawEntry> draws_;
+  std::vector<Bucket> buckets_;
+  std::vector<FrameResources> frames_;
+  uint64_t version_ = 1;
+  // 加入新的绘制项后要重新计算桶的commandOffset
+  bool layoutDirty_ = false;
+  CullStats cullStats_;
+
+  uint32_t findBucket(const Model& model, const Material& material);
+  // 读回上次的剔除结果，复制修改过的数据并清零计数
+  FrameResources& prepare(uint32_t frameIndex);
+  // buffer不够大时换成更大的，返回是否重新创建
+  static bool reserve(std::unique_ptr<Buffer>& buffer, size_t size,
+                      vk::BufferUsageFlags usage, MemoryUsage memoryUsage);
+  void updateDescriptorSets(FrameResources& frame);
+};
+
+}  // namespace sktr
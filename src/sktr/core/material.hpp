@@ -1,20 +1,16 @@
 #pragma once
 
 #include "sktr/pch.hpp"
-#include "sktr/system/buffer.hpp"
-#include "sktr/system/descriptor_manager.hpp"
 #include "sktr/utils/common.hpp"
 
 namespace sktr {
+class Texture;
+
 class Material {
  public:
-  Material();
-  ~Material();
-  DescriptorSetManager::SetInfo set;
-  std::unique_ptr<Buffer> buffer;
-
- private:
-  void createBuffer();
-  void updateDescriptorSet();
+  // 绘制时写入Renderer当前帧的uniform，修改后下一帧生效
+  MaterialInfo info;
+  // 材质自己的贴图(如glTF的baseColor)，由TextureManager持有，为空时使用模型的贴图
+  Texture* texture = nullptr;
 };
-}  // namespace sktr
\ No newline at end of file
+}  // namespace sktr
@@ -1,128 +1,435 @@
 #include "model.hpp"
-#define TINYOBJLOADER_IMPLEMENTATION
-
-#include <tiny_obj_loader.h>
 
 #include "context.hpp"
+#include "sktr/mesh/gltf_loader.hpp"
+#include "sktr/mesh/index_chunks.hpp"
+#include "sktr/mesh/mesh_cache.hpp"
+#include "sktr/mesh/meshlet_builder.hpp"
+#include "sktr/mesh/obj_loader.hpp"
 namespace sktr {
+
+// 影响顶点数据的加载参数都要写进缓存，参数变化后缓存自动失效
+static uint64_t meshCacheFlags(const ModelLoadOptions& options) {
+  uint64_t flags = 0;
+  if (options.normalized) {
+    flags |= 1u << 0;
+  }
+  if (options.optimize) {
+    flags |= 1u << 1;
+  }
+  if (options.splitIndexChunks) {
+    flags |= 1u << 3;
+  }
+  if (options.lodCount > 1) {
+    uint64_t lodCount = std::min(options.lodCount, 15u);
+    uint64_t reduction = static_cast<uint64_t>(
+        std::clamp(options.lodReduction, 0.0f, 1.0f) * 255.0f);
+    flags |= (lodCount << 4) | (reduction << 8);
+  }
+  if (options.buildMeshlets) {
+    flags |= 1u << 16;
+  }
+  if (options.weldMode == WeldMode::eQuantized) {
+    uint32_t epsilonBits;
+    memcpy(&epsilonBits, &options.weldEpsilon, sizeof(epsilonBits));
+    // 高32位存放量化精度
+    flags |= (1u << 2) | (uint64_t(epsilonBits) << 32);
+  }
+  return flags;
+}
+
 Model::Model(const std::string name, const std::string modelPath,
              const std::string mtlPath, bool normalized)
-    : name(name), modelMatrix(glm::identity<glm::mat4>()) {
-  tinyobj::attrib_t attrib;
-  std::vector<tinyobj::shape_t> shapes;
-  std::vector<tinyobj::material_t> materials_t;
-  std::string warn;
-  std::string err;
-
-  const char* mtlPathC =
-      mtlPath.empty() ? (const char*)__null : mtlPath.c_str();
-  if (!tinyobj::LoadObj(&attrib, &shapes, &materials_t, &err, modelPath.c_str(),
-                        mtlPathC)) {
-    throw std::runtime_error(warn + err);
-  }
-
-  if (materials_t.size() > 0) {
-    materialInfos.resize(materials_t.size());
-    for (auto i = 0; i < materials_t.size(); ++i) {
-      auto& material = materialInfos.at(i);
-      materialInfos[0].diffuse = {material.diffuse[0], material.diffuse[1],
-                                  material.diffuse[2]};
-      materialInfos[i].specular = {material.specular[0], material.specular[1],
-                                   material.specular[2]};
+    : Model(name, modelPath, mtlPath, ModelLoadOptions{normalized}) {}
+
+Model::Model(const std::string name, const std::string modelPath,
+             const std::string mtlPath, const ModelLoadOptions& options)
+    : name(name),
+      vertexFormat(options.vertexFormat),
+      modelMatrix(glm::identity<glm::mat4>()),
+      useGeometryPool_(options.useGeometryPool) {
+  if (IsGltfPath(modelPath)) {
+    loadGltf(modelPath, options);
+    return;
+  }
+
+  const uint64_t cacheFlags = meshCacheFlags(options);
+  const auto cachePath = MeshCache::CachePath(modelPath);
+  uint64_t sourceHash = 0;
+
+  if (options.useCache) {
+    // 材质也在缓存中，.mtl或mtlPath变化时缓存失效
+    sourceHash = MeshCache::HashSource(modelPath, mtlPath);
+    if (auto cached = MeshCache::Load(cachePath, sourceHash, cacheFlags)) {
+      bounds = cached->bounds;
+      subMeshes = std::move(cached->subMeshes);
+      materialInfos = std::move(cached->materialInfos);
+      initLods(std::move(cached->lods));
+      createMaterials();
+      vertexCount = cached->vertexCount;
+      chooseIndexType(cached->indices, options);
+      // 直接从映射的文件拷贝到staging buffer
+      createVertexBuffer(cached->vertices, cached->vertexCount);
+      createIndicesBuffer(cached->indices, cached->indexCount);
+      createMeshletBuffer(cached->meshlets.data(),
+                          static_cast<uint32_t>(cached->meshlets.size()));
+      return;
     }
+  }
+
+  ObjLoadOptions objOptions;
+  objOptions.normalized = options.normalized;
+  objOptions.threadCount = options.loadThreads;
+  objOptions.weldMode = options.weldMode;
+  objOptions.weldEpsilon = options.weldEpsilon;
+  MeshData mesh = LoadObjMesh(modelPath, mtlPath, objOptions);
+  processMesh(mesh, options);
+  if (options.useCache &&
+      !MeshCache::Write(cachePath, mesh, sourceHash, cacheFlags)) {
+    std::cout << "write mesh cache " << cachePath << " failed" << std::endl;
+  }
+
+  uploadMesh(mesh, options);
+}
+
+Model::~Model() { Release(); }
 
-    material.reset(new Material{});
-    memcpy(material->buffer->map, &materialInfos[0], sizeof(MaterialInfo));
-  }
-
-  std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-
-  float maxX = -std::numeric_limits<float>::max(),
-        maxY = -std::numeric_limits<float>::max(),
-        maxZ = -std::numeric_limits<float>::max(),
-        minX = std::numeric_limits<float>::max(),
-        minY = std::numeric_limits<float>::max(),
-        minZ = std::numeric_limits<float>::max();
-
-  for (const auto& shape : shapes) {
-    for (const auto& index : shape.mesh.indices) {
-      Vertex vertex{};
-      vertex.pos = {attrib.vertices[3 * index.vertex_index + 0],
-                    attrib.vertices[3 * index.vertex_index + 1],
-                    attrib.vertices[3 * index.vertex_index + 2]};
-
-      vertex.normal = {attrib.normals[3 * index.normal_index + 0],
-                       attrib.normals[3 * index.normal_index + 1],
-                       attrib.normals[3 * index.normal_index + 2]};
-
-      vertex.texCoord = {attrib.texcoords[2 * index.texcoord_index + 0],
-                         1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
-
-      vertex.color = {1.0f, 1.0f, 1.0f};
-      if (uniqueVertices.count(vertex) == 0) {
-        maxX = std::max(maxX, vertex.pos.x);
-        maxY = std::max(maxY, vertex.pos.y);
-        maxZ = std::max(maxZ, vertex.pos.z);
-        minX = std::min(minX, vertex.pos.x);
-        minY = std::min(minY, vertex.pos.y);
-        minZ = std::min(minZ, vertex.pos.z);
-        uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-        vertices.push_back(vertex);
+glm::vec4 Model::WorldSphere(const glm::mat4& transform) const {
+  if (!bounds.Valid()) {
+    return glm::vec4(glm::vec3(transform[3]),
+                     std::numeric_limits<float>::infinity());
+  }
+  const glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+  const float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+  const float scale =
+      std::max(std::max(glm::length(glm::vec3(transform[0])),
+                        glm::length(glm::vec3(transform[1]))),
+               glm::length(glm::vec3(transform[2])));
+  return glm::vec4(glm::vec3(transform * glm::vec4(center, 1.0f)),
+                   radius * scale);
+}
+
+void Model::Release() {
+  if (!vertexBuffer && !indicesBuffer && !meshletBuffer && !vertexRange &&
+      !indexRange) {
+    return;
+  }
+  auto& ctx = Context::GetInstance();
+  auto& deletionQueue = ctx.deletionQueue;
+  if (!deletionQueue) {
+    if (meshletBuffer) {
+      DescriptorSetManager::GetInstance().FreeStorageBufferSet(meshletSet);
+    }
+    vertexBuffer.reset();
+    indicesBuffer.reset();
+    meshletBuffer.reset();
+    ctx.geometryPool->Free(vertexRange);
+    ctx.geometryPool->Free(indexRange);
+    return;
+  }
+  // 正在执行的帧可能还在使用，上传也可能没有完成
+  deletionQueue->Push(std::move(vertexBuffer), upload);
+  deletionQueue->Push(std::move(indicesBuffer), upload);
+  if (meshletBuffer) {
+    auto set = meshletSet;
+    deletionQueue->Push([set]() {
+      DescriptorSetManager::GetInstance().FreeStorageBufferSet(set);
+    });
+    deletionQueue->Push(std::move(meshletBuffer), upload);
+  }
+  if (vertexRange || indexRange) {
+    deletionQueue->Push(
+        [vertices = vertexRange, indices = indexRange]() mutable {
+          auto& pool = Context::GetInstance().geometryPool;
+          pool->Free(vertices);
+          pool->Free(indices);
+        },
+        upload);
+    vertexRange = {};
+    indexRange = {};
+  }
+}
+
+void Model::processMesh(MeshData& mesh, const ModelLoadOptions& options) {
+  if (options.optimize) {
+    optimizationStats = OptimizeMesh(mesh);
+    std::cout << "[" << name << "] ACMR " << optimizationStats->before.acmr
+              << " -> " << optimizationStats->after.acmr << ", ATVR "
+              << optimizationStats->before.atvr << " -> "
+              << optimizationStats->after.atvr << std::endl;
+  }
+  if (options.lodCount > 1) {
+    GenerateLods(mesh, options.lodCount, options.lodReduction);
+    std::cout << "[" << name << "] lods:";
+    for (const auto& lod : mesh.lods) {
+      uint32_t lodIndexCount = 0;
+      for (uint32_t i = 0; i < lod.subMeshCount; i++) {
+        lodIndexCount += mesh.subMeshes[lod.firstSubMesh + i].indexCount;
       }
+      std::cout << " " << lodIndexCount / 3 << " tris (error " << lod.error
+                << ")";
+    }
+    std::cout << std::endl;
+  }
+  if (options.splitIndexChunks) {
+    auto originalCount = mesh.vertices.size();
+    SplitIndexChunks(mesh);
+    if (mesh.vertices.size() != originalCount) {
+      std::cout << "[" << name << "] split into " << mesh.subMeshes.size()
+                << " 16-bit index chunks, "
+                << mesh.vertices.size() - originalCount
+                << " vertices duplicated" << std::endl;
+    }
+  }
+  if (options.buildMeshlets) {
+    BuildMeshlets(mesh);
+    std::cout << "[" << name << "] " << mesh.meshlets.size() << " meshlets"
+              << std::endl;
+  }
+}
+
+void Model::uploadMesh(MeshData& mesh, const ModelLoadOptions& options) {
+  bounds = mesh.bounds;
+  subMeshes = std::move(mesh.subMeshes);
+  materialInfos = std::move(mesh.materialInfos);
+  initLods(std::move(mesh.lods));
+  createMaterials();
+  vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+  chooseIndexType(mesh.indices.data(), options);
+  createVertexBuffer(mesh.vertices.data(),
+                     static_cast<uint32_t>(mesh.vertices.size()));
+  createIndicesBuffer(mesh.indices.data(),
+                      static_cast<uint32_t>(mesh.indices.size()));
+  createMeshletBuffer(mesh.meshlets.data(),
+                      static_cast<uint32_t>(mesh.meshlets.size()));
+}
 
-      indices.push_back(uniqueVertices[vertex]);
+void Model::loadGltf(const std::string& path,
+                     const ModelLoadOptions& options) {
+  GltfLoadOptions gltfOptions;
+  gltfOptions.normalized = options.normalized;
+  GltfAsset asset = LoadGltf(path, gltfOptions);
+
+  if (options.optimize || options.lodCount > 1 || options.splitIndexChunks ||
+      options.buildMeshlets) {
+    // 需要重排索引时和obj走相同的处理流程
+    MeshData mesh = GltfToMeshData(asset);
+    processMesh(mesh, options);
+    uploadMesh(mesh, options);
+  } else {
+    bounds = asset.bounds;
+    subMeshes = GltfSubMeshes(asset);
+    materialInfos = asset.materialInfos;
+    initLods({});
+    createMaterials();
+    indexType = options.allowUint16Indices && asset.FitsUint16Indices()
+                    ? vk::IndexType::eUint16
+                    : vk::IndexType::eUint32;
+    // 从accessor直接写到staging buffer，不经过std::vector<Vertex>
+    createVertexBuffer(asset.vertexCount, [&](void* dst) {
+      if (vertexFormat == VertexFormat::ePacked) {
+        std::vector<Vertex> vertices(asset.vertexCount);
+        WriteGltfVertices(asset, vertices.data());
+        PackVertices(vertices.data(), asset.vertexCount, dequantization,
+                     static_cast<PackedVertex*>(dst));
+      } else {
+        WriteGltfVertices(asset, static_cast<Vertex*>(dst));
+      }
+    });
+    createIndicesBuffer(asset.indexCount, [&](void* dst) {
+      WriteGltfIndices(asset, dst, indexType == vk::IndexType::eUint16);
+    });
+  }
+  createGltfTextures(asset);
+}
+
+void Model::createGltfTextures(const GltfAsset& asset) {
+  auto& textureManager = TextureManager::GetInstance();
+  // 多个材质引用同一张图片时只加载一次
+  std::vector<Texture*> imageTextures(asset.images.size(), nullptr);
+  // 所有贴图一起上传并生成mipmap
+  textureManager.BeginBatch();
+  try {
+    for (size_t i = 0; i < asset.materialImages.size(); i++) {
+      auto imageIndex = asset.materialImages[i];
+      if (imageIndex < 0) {
+        continue;
+      }
+      auto& imageTexture = imageTextures[imageIndex];
+      if (!imageTexture) {
+        const auto& image = asset.images[imageIndex];
+        if (image.data) {
+          imageTexture = textureManager.LoadFromMemory(image.data, image.size);
+        } else if (!image.path.empty()) {
+          imageTexture = textureManager.Load(image.path);
+        } else {
+          continue;
+        }
+        textures.push_back(imageTexture);
+      }
+      materials[i]->texture = imageTexture;
     }
+  } catch (...) {
+    textureManager.EndBatch();
+    throw;
+  }
+  textureManager.EndBatch();
+  if (!texture && !textures.empty()) {
+    texture = textures.front();
+  }
+}
+
+void Model::initLods(std::vector<MeshLod> meshLods) {
+  lods = std::move(meshLods);
+  if (lods.empty()) {
+    lods.push_back({0, static_cast<uint32_t>(subMeshes.size()), 0.0f});
   }
-  if (normalized) {
-    auto scale_factor =
-        2.0 / std::max(maxX - minX, std::max(maxY - minY, maxZ - minZ));
-    for (auto& vertex : vertices) {
-      vertex.pos.x = (vertex.pos.x - minX) * scale_factor - 1.0;
-      vertex.pos.y = (vertex.pos.y - minY) * scale_factor - 1.0;
-      vertex.pos.z = (vertex.pos.z - minZ) * scale_factor;
+}
+
+void Model::createMaterials() {
+  // 没有材质的subMesh使用默认材质，保证绘制时set 2总是有效
+  materials.clear();
+  for (size_t i = 0; i <= materialInfos.size(); i++) {
+    MaterialInfo info =
+        i < materialInfos.size() ? materialInfos[i] : MaterialInfo{};
+    materials.emplace_back(new Material{});
+    materials.back()->info = info;
+  }
+}
+
+void Model::createVertexBuffer(const Vertex* data, uint32_t count) {
+  createVertexBuffer(count, [&](void* dst) {
+    if (vertexFormat == VertexFormat::ePacked) {
+      PackVertices(data, count, dequantization,
+                   static_cast<PackedVertex*>(dst));
+    } else {
+      memcpy(dst, data, sizeof(Vertex) * count);
     }
+  });
+}
+
+void Model::createVertexBuffer(uint32_t count,
+                               const std::function<void(void*)>& write) {
+  vertexCount = count;
+  auto size = VertexBufferSize();
+  if (vertexFormat == VertexFormat::ePacked) {
+    dequantization = VertexDequantization::FromBounds(bounds);
+  }
+  if (useGeometryPool_) {
+    vertexRange = Context::GetInstance().geometryPool->AllocateVertices(
+        VertexStride(vertexFormat), count);
+  }
+  if (vertexRange) {
+    baseVertex = static_cast<int32_t>(vertexRange.first);
+    uploadRange(vertexRange, write);
+  } else {
+    vertexBuffer.reset(new Buffer{size,
+                                  vk::BufferUsageFlagBits::eVertexBuffer |
+                                      vk::BufferUsageFlagBits::eTransferDst,
+                                  MemoryUsage::eGpuOnly});
+    uploadBuffer(*vertexBuffer, write);
   }
+  if (vertexFormat == VertexFormat::ePacked) {
+    auto fullSize = sizeof(Vertex) * count;
+    std::cout << "[" << name << "] packed vertices: " << fullSize << " -> "
+              << size << " bytes, saved " << (fullSize - size) / 1024
+              << " KB" << std::endl;
+  }
+}
 
-  createVertexBuffer();
-  createIndicesBuffer();
+void Model::uploadBuffer(Buffer& dst, const std::function<void(void*)>& write) {
+  upload = Context::GetInstance().stagingRing->UploadBuffer(dst.buffer,
+                                                            dst.size, write);
 }
 
-void Model::createVertexBuffer() {
-  auto size = sizeof(vertices[0]) * vertices.size();
-  Buffer stagingBuffer = Buffer{size, vk::BufferUsageFlagBits::eTransferSrc,
-                                vk::MemoryPropertyFlagBits::eHostVisible |
-                                    vk::MemoryPropertyFlagBits::eHostCoherent};
-  memcpy(stagingBuffer.map, vertices.data(), size);
-  vertexBuffer.reset(new Buffer{size,
-                                vk::BufferUsageFlagBits::eVertexBuffer |
-                                    vk::BufferUsageFlagBits::eTransferDst,
-                                vk::MemoryPropertyFlagBits::eDeviceLocal});
-  auto& ctx = Context::GetInstance();
-  ctx.commandManager->ExecuteCmd(
-      ctx.graphicsQueue, [&](vk::CommandBuffer& cmdBuff) {
-        vk::BufferCopy region;
-        region.setSize(stagingBuffer.size).setSrcOffset(0).setDstOffset(0);
-        cmdBuff.copyBuffer(stagingBuffer.buffer, vertexBuffer->buffer, region);
-      });
-}
-
-void Model::createIndicesBuffer() {
-  auto size = sizeof(indices[0]) * indices.size();
-  Buffer stagingBuffer = Buffer{size, vk::BufferUsageFlagBits::eTransferSrc,
-                                vk::MemoryPropertyFlagBits::eHostVisible |
-                                    vk::MemoryPropertyFlagBits::eHostCoherent};
-  memcpy(stagingBuffer.map, indices.data(), size);
-  indicesBuffer.reset(new Buffer{size,
-                                 vk::BufferUsageFlagBits::eTransferDst |
-                                     vk::BufferUsageFlagBits::eIndexBuffer,
-                                 vk::MemoryPropertyFlagBits::eDeviceLocal});
+void Model::uploadRange(const GeometryPool::Range& dst,
+                        const std::function<void(void*)>& write) {
+  upload = Context::GetInstance().stagingRing->UploadBuffer(
+      dst.buffer, dst.ByteSize(), write, dst.ByteOffset());
+}
+
+void Model::chooseIndexType(const uint32_t* indices,
+                            const ModelLoadOptions& options) {
+  indexType = options.allowUint16Indices &&
+                      FitsUint16Indices(indices, vertexCount, subMeshes)
+                  ? vk::IndexType::eUint16
+                  : vk::IndexType::eUint32;
+}
+
+void Model::createIndicesBuffer(const uint32_t* data, uint32_t count) {
+  createIndicesBuffer(count, [&](void* dst) {
+    if (indexType == vk::IndexType::eUint16) {
+      auto dst16 = static_cast<uint16_t*>(dst);
+      for (uint32_t i = 0; i < count; i++) {
+        dst16[i] = static_cast<uint16_t>(data[i]);
+      }
+    } else {
+      memcpy(dst, data, sizeof(uint32_t) * count);
+    }
+  });
+}
+
+void Model::createIndicesBuffer(uint32_t count,
+                                const std::function<void(void*)>& write) {
+  indexCount = count;
+  auto size = IndexBufferSize();
+  if (useGeometryPool_) {
+    indexRange =
+        Context::GetInstance().geometryPool->AllocateIndices(indexType, count);
+  }
+  if (indexRange) {
+    firstIndex = indexRange.first;
+    uploadRange(indexRange, write);
+  } else {
+    indicesBuffer.reset(new Buffer{size,
+                                   vk::BufferUsageFlagBits::eTransferDst |
+                                       vk::BufferUsageFlagBits::eIndexBuffer,
+                                   MemoryUsage::eGpuOnly});
+    uploadBuffer(*indicesBuffer, write);
+  }
+}
+
+void Model::createMeshletBuffer(const Meshlet* data, uint32_t count) {
+  meshletCount = count;
+  if (count == 0) {
+    return;
+  }
+  meshletGroups.clear();
+  for (uint32_t i = 0; i < count; i++) {
+    if (meshletGroups.empty() ||
+        meshletGroups.back().subMesh != data[i].subMesh) {
+      meshletGroups.push_back({data[i].subMesh, i, 0});
+    }
+    meshletGroups.back().meshletCount++;
+  }
+  auto size = sizeof(Meshlet) * count;
+  meshletBuffer.reset(new Buffer{size,
+                                 vk::BufferUsageFlagBits::eStorageBuffer |
+                                     vk::BufferUsageFlagBits::eTransferDst,
+                                 MemoryUsage::eGpuOnly});
+  // 剔除着色器直接输出绘制命令，加上模型在GeometryPool中的偏移
+  uploadBuffer(*meshletBuffer, [&](void* dst) {
+    auto meshlets = static_cast<Meshlet*>(dst);
+    memcpy(meshlets, data, size);
+    for (uint32_t i = 0; i < count; i++) {
+      meshlets[i].firstIndex += firstIndex;
+      meshlets[i].vertexOffset += baseVertex;
+    }
+  });
   auto& ctx = Context::GetInstance();
-  ctx.commandManager->ExecuteCmd(
-      ctx.graphicsQueue, [&](vk::CommandBuffer& cmdBuff) {
-        vk::BufferCopy region;
-        region.setSize(stagingBuffer.size).setSrcOffset(0).setDstOffset(0);
-        cmdBuff.copyBuffer(stagingBuffer.buffer, indicesBuffer->buffer, region);
-      });
+
+  meshletSet = DescriptorSetManager::GetInstance().AllocStorageBufferSet(
+      ctx.renderProcess->meshletCullPipeline->setLayouts[0]);
+  vk::DescriptorBufferInfo bufferInfo;
+  bufferInfo.setBuffer(meshletBuffer->buffer).setOffset(0).setRange(size);
+  vk::WriteDescriptorSet writeInfo;
+  writeInfo.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+      .setBufferInfo(bufferInfo)
+      .setDstBinding(0)
+      .setDstSet(meshletSet.set)
+      .setDstArrayElement(0)
+      .setDescriptorCount(1);
+  ctx.device.updateDescriptorSets(writeInfo, {});
 }
 
-}  // namespace sktr
\ No newline at end of file
+}  // namespace sktr
@@ -1,34 +1,162 @@
 #pragma once
 #include "material.hpp"
+#include "sktr/mesh/mesh_data.hpp"
+#include "sktr/mesh/mesh_optimizer.hpp"
+#include "sktr/mesh/mesh_simplifier.hpp"
+#include "sktr/mesh/vertex_packing.hpp"
+#include "sktr/mesh/weld_table.hpp"
 #include "sktr/pch.hpp"
 #include "sktr/system/buffer.hpp"
+#include "sktr/system/geometry_pool.hpp"
+#include "sktr/system/staging_ring.hpp"
 #include "sktr/utils/common.hpp"
 #include "texture.hpp"
 
 namespace sktr {
 
+struct GltfAsset;
+
+struct ModelLoadOptions {
+  // 把模型缩放到[-1, 1]
+  bool normalized = false;
+  // 优先读取.obj旁边的二进制缓存，没有或失效时重新解析并写入缓存。
+  // glTF本身就是二进制布局，不使用缓存
+  bool useCache = true;
+  // 顶点去重使用的线程数，0表示使用全部硬件线程
+  uint32_t loadThreads = 0;
+  // 顶点焊接方式，eQuantized时按weldEpsilon量化后比较
+  WeldMode weldMode = WeldMode::eExact;
+  float weldEpsilon = WeldTable::DefaultEpsilon;
+  // 加载时重排三角形和顶点，提高顶点缓存命中率、减少overdraw
+  bool optimize = false;
+  // GPU端顶点格式，ePacked时按包围盒量化，只在上传时转换，不影响缓存
+  VertexFormat vertexFormat = VertexFormat::eFull;
+  // 索引都能用16位表示时使用eUint16
+  bool allowUint16Indices = true;
+  // 顶点数超过65536的模型拆成多个16位索引块，块边界上的顶点会被复制
+  bool splitIndexChunks = false;
+  // 包含原始网格在内的LOD级数，1表示不生成
+  uint32_t lodCount = 1;
+  // 每级LOD的三角形数约为上一级的多少
+  float lodReduction = 0.5f;
+  // 把LOD0切成meshlet，绘制时先用compute剔除再间接绘制
+  bool buildMeshlets = false;
+  // 顶点和索引放在共享的GeometryPool中，放不下时单独创建buffer
+  bool useGeometryPool = true;
+};
+
 class Model final {
  public:
   std::string name;
-  std::vector<Vertex> vertices;
-  std::vector<uint32_t> indices;
+  uint32_t vertexCount = 0;
+  uint32_t indexCount = 0;
+  VertexFormat vertexFormat = VertexFormat::eFull;
+  vk::IndexType indexType = vk::IndexType::eUint32;
+  // ePacked时还原位置用
+  VertexDequantization dequantization;
+  Bounds bounds;
+  std::vector<SubMesh> subMeshes;
+  // 至少有一级，各级的索引都在indicesBuffer中
+  std::vector<MeshLod> lods;
   std::vector<MaterialInfo> materialInfos;
+  // 只在重新解析并优化时填写，读缓存时为空
+  std::optional<MeshOptimizationStats> optimizationStats;
   glm ::mat4 modelMatrix;
-  Texture* texture;
-  std::unique_ptr<Material> material;
+  // 材质没有贴图时使用，glTF模型默认为第一张baseColor贴图
+  Texture* texture = nullptr;
+  // glTF中加载的贴图，由TextureManager持有
+  std::vector<Texture*> textures;
+  // 和materialInfos一一对应，最后一个是没有材质的subMesh使用的默认材质
+  std::vector<std::unique_ptr<Material>> materials;
 
+  // 在GeometryPool中时为空，使用vertexRange和indexRange
   std::unique_ptr<Buffer> vertexBuffer;
   std::unique_ptr<Buffer> indicesBuffer;
+  GeometryPool::Range vertexRange;
+  GeometryPool::Range indexRange;
+  // 绘制时加到subMesh的vertexOffset和firstIndex上，单独的buffer时为0
+  int32_t baseVertex = 0;
+  uint32_t firstIndex = 0;
+
+  // LOD0的meshlet，剔除着色器的set 0
+  uint32_t meshletCount = 0;
+  // 属于同一个subMesh的meshlet是连续的，按组切换材质
+  struct MeshletGroup {
+    uint32_t subMesh;
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+  };
+  std::vector<MeshletGroup> meshletGroups;
+  std::unique_ptr<Buffer> meshletBuffer;
+  DescriptorSetManager::SetInfo meshletSet;
+  // 最后一次上传的批次，完成之前不能销毁buffer
+  UploadHandle upload;
 
   Model(const std::string name, const std::string modelPath,
         const std::string mtlPath = "", bool normalized = false);
+  // modelPath为.glb/.gltf时按glTF加载，忽略mtlPath
+  Model(const std::string name, const std::string modelPath,
+        const std::string mtlPath, const ModelLoadOptions& options);
+  ~Model();
+
+  // 等正在执行的帧和上传完成后释放buffer，之后不能再绘制
+  void Release();
 
   void SetModelM(glm::mat4 model) { modelMatrix = model; }
+  // 世界坐标下的包围球，xyz是球心，w是半径(按缩放最大的轴)。
+  // 没有包围盒时半径为无穷大
+  glm::vec4 WorldSphere() const { return WorldSphere(modelMatrix); }
+  glm::vec4 WorldSphere(const glm::mat4& transform) const;
+
+  vk::Buffer VertexBuffer() const {
+    return vertexRange ? vertexRange.buffer : vertexBuffer->buffer;
+  }
+  vk::Buffer IndexBuffer() const {
+    return indexRange ? indexRange.buffer : indicesBuffer->buffer;
+  }
+
+  const Material& MaterialOf(const SubMesh& subMesh) const {
+    bool valid = subMesh.materialId >= 0 &&
+                 subMesh.materialId < static_cast<int32_t>(materialInfos.size());
+    return valid ? *materials[subMesh.materialId] : *materials.back();
+  }
+
+  vk::DeviceSize VertexBufferSize() const {
+    return vk::DeviceSize(VertexStride(vertexFormat)) * vertexCount;
+  }
+  vk::DeviceSize IndexBufferSize() const {
+    return vk::DeviceSize(indexType == vk::IndexType::eUint16
+                              ? sizeof(uint16_t)
+                              : sizeof(uint32_t)) *
+           indexCount;
+  }
 
   // todo: set texture
 
  private:
-  void createVertexBuffer();
-  void createIndicesBuffer();
+  bool useGeometryPool_;
+
+  // 优化、LOD、拆分和meshlet，obj和glTF共用
+  void processMesh(MeshData& mesh, const ModelLoadOptions& options);
+  void uploadMesh(MeshData& mesh, const ModelLoadOptions& options);
+  void loadGltf(const std::string& path, const ModelLoadOptions& options);
+  void createGltfTextures(const GltfAsset& asset);
+  void createMaterials();
+  void initLods(std::vector<MeshLod> meshLods);
+  void createVertexBuffer(const Vertex* data, uint32_t count);
+  // write直接写入映射的staging buffer，格式为vertexFormat
+  void createVertexBuffer(uint32_t count,
+                          const std::function<void(void*)>& write);
+  void createIndicesBuffer(const uint32_t* data, uint32_t count);
+  // write直接写入映射的staging buffer，格式为indexType
+  void createIndicesBuffer(uint32_t count,
+                           const std::function<void(void*)>& write);
+  void createMeshletBuffer(const Meshlet* data, uint32_t count);
+  // 通过stagingRing异步上传到整个dst，renderer提交时获取所有权
+  void uploadBuffer(Buffer& dst, const std::function<void(void*)>& write);
+  void uploadRange(const GeometryPool::Range& dst,
+                   const std::function<void(void*)>& write);
+  void chooseIndexType(const uint32_t* indices,
+                       const ModelLoadOptions& options);
 };
 }  // namespace sktr
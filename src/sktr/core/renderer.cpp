@@ -1,6 +1,8 @@
 #include "renderer.hpp"
 
 #include "context.hpp"
+#include "sktr/utils/frustum.hpp"
+#include "sktr/utils/radix_sort.hpp"
 
 namespace sktr {
 
@@ -11,14 +13,21 @@ Renderer::Renderer(int width, int height, int maxFlightCount)
   createFences();
 
   createUniformBuffers();
+  createMeshletCullResources();
+  instanceBuffers_.resize(maxFlightCount_);
+  for (auto& buffer : instanceBuffers_) {
+    buffer.reset(new Buffer{sizeof(InstanceData) * DefaultInstanceCapacity,
+                            vk::BufferUsageFlagBits::eVertexBuffer,
+                            MemoryUsage::eCpuToGpu});
+  }
 
   initMats();
   SetProjection(glm::radians(45.0f), width / (float)height, 0.1f, 10.0f);
   SetView(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f),
           glm::vec3(0.0f, 0.0f, 1.0f));
 
-  worldUniformDescriptorSets_ =
-      DescriptorSetManager::GetInstance().AllocWorldBufferSets(maxFlightCount);
+  worldSet_ = DescriptorSetManager::GetInstance().AllocWorldBufferSet();
+  materialSet_ = DescriptorSetManager::GetInstance().AllocMaterialBufferSet();
   updateDescriptorSets();
 
   // createWhiteTexture();
@@ -32,8 +41,18 @@ Renderer::~Renderer() {
   // ! 应当手动调用Texture Manager的clear，
   // ! 因为单例的析构函数在最后，会导致内部的texture析构时device以及为空
   TextureManager::GetInstance().Clear();
-  uniformVPBuffers.clear();
-  uniformLightBuffers.clear();
+  uniforms_.reset();
+  instanceBuffers_.clear();
+  for (auto& set : meshletOutputSets_) {
+    DescriptorSetManager::GetInstance().FreeStorageBufferSet(set);
+  }
+  meshletCommandBuffers_.clear();
+  meshletStatsBuffers_.clear();
+  for (auto& set : occlusionSets_) {
+    DescriptorSetManager::GetInstance().FreeComputeImageSet(set);
+  }
+  occlusionParams_.clear();
+  depthPyramid_.reset();
   for (auto& sem : imageAvaliableSems_) {
     device.destroySemaphore(sem);
   }
@@ -45,6 +64,8 @@ Renderer::~Renderer() {
   }
 
   Context::GetInstance().commandManager->FreeCommandBuffers(cmdBuffs_);
+  Context::GetInstance().commandManager->FreeCommandBuffers(computeCmdBuffs_);
+  Context::GetInstance().commandManager->FreeCommandBuffers(acquireCmdBuffs_);
 }
 
 void Renderer::allocCmdBuffers() {
@@ -52,6 +73,14 @@ void Renderer::allocCmdBuffers() {
   for (auto& cmdBuff : cmdBuffs_) {
     cmdBuff = Context::GetInstance().commandManager->CreateOneCommandBuffer();
   }
+  computeCmdBuffs_.resize(maxFlightCount_);
+  for (auto& cmdBuff : computeCmdBuffs_) {
+    cmdBuff = Context::GetInstance().commandManager->CreateOneCommandBuffer();
+  }
+  acquireCmdBuffs_.resize(maxFlightCount_);
+  for (auto& cmdBuff : acquireCmdBuffs_) {
+    cmdBuff = Context::GetInstance().commandManager->CreateOneCommandBuffer();
+  }
 }
 
 bool Renderer::StartRender() {
@@ -87,8 +116,50 @@ bool Renderer::StartRender() {
   imageIndex_ = result.value;
   device.resetFences(fence);
 
+  // 这个fence属于maxFlightCount_帧之前，它和更早的帧引用的资源都可以销毁了
+  auto& deletionQueue = Context::GetInstance().deletionQueue;
+  if (deletionQueue->Frame() > static_cast<uint64_t>(maxFlightCount_)) {
+    deletionQueue->Collect(deletionQueue->Frame() - maxFlightCount_);
+  }
+
+  // 这一段的uniform上次被读取的帧已经执行完
+  uniforms_->BeginFrame(curFrame_);
+  frameSerial_++;
+  worldDirty_ = true;
+
   auto& cmdBuff = cmdBuffs_[curFrame_];
   cmdBuff.reset();
+  frameStats_ = FrameStats{};
+  drawItems_.clear();
+  itemSpheres_.Clear();
+  boundItem_ = WholeModel;
+  materialSortIds_.clear();
+  textureSortIds_.clear();
+  materialUniformOffsets_.clear();
+  boundPipeline_ = nullptr;
+  boundMaterial_ = nullptr;
+  boundTextureSet_ = nullptr;
+  boundVertexBuffer_ = nullptr;
+  boundIndexBuffer_ = nullptr;
+  boundInstanceBuffer_ = nullptr;
+  instanceHead_ = 0;
+
+  // fence之后这一帧上次的剔除结果已经写完
+  auto visibleCount =
+      static_cast<uint32_t*>(meshletStatsBuffers_[curFrame_]->map);
+  meshletCullStats_.total = meshletsDispatched_[curFrame_];
+  meshletCullStats_.visible = *visibleCount;
+  *visibleCount = 0;
+  meshletsDispatched_[curFrame_] = 0;
+  cullDispatched_ = false;
+
+  // 遮挡剔除时从early pass开始，DrawGpuScene在两个阶段之间切换到late pass
+  occlusionFrame_ =
+      occlusionCulling_ && Context::GetInstance().occlusionCullingEnabled;
+  occlusionSplit_ = false;
+  if (occlusionFrame_) {
+    ensureDepthPyramid();
+  }
 
   vk::CommandBufferBeginInfo beginInfo;
   // OneTimeSubmit: 提交一次之后失效
@@ -96,6 +167,9 @@ bool Renderer::StartRender() {
   // SimultaneousUse: 可以一直重复使用
   beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
   cmdBuff.begin(beginInfo);
+  auto& computeCmdBuff = computeCmdBuffs_[curFrame_];
+  computeCmdBuff.reset();
+  computeCmdBuff.begin(beginInfo);
 
   vk::RenderPassBeginInfo renderPassBegin;
   vk::Rect2D area;
@@ -105,7 +179,9 @@ bool Renderer::StartRender() {
   clearValues[1].depthStencil = vk::ClearDepthStencilValue{1.0f, 0};
 
   area.setOffset({0, 0}).setExtent(swapchain->info.imageExtent);
-  renderPassBegin.setRenderPass(renderProcess->renderPass)
+  renderPassBegin
+      .setRenderPass(occlusionFrame_ ? renderProcess->occlusionEarlyPass
+                                     : renderProcess->renderPass)
       .setRenderArea(area)
       .setFramebuffer(swapchain->framebuffers[imageIndex_])
       .setClearValues(clearValues);
@@ -117,22 +193,65 @@ bool Renderer::StartRender() {
 void Renderer::EndRender() {
   auto& swapchain = Context::GetInstance().swapchain;
   auto& cmdBuff = cmdBuffs_[curFrame_];
+  auto& computeCmdBuff = computeCmdBuffs_[curFrame_];
   auto& imageAvaliableSem = imageAvaliableSems_[curFrame_];
   auto& renderFinishSem = renderFinishSems_[curFrame_];
   auto& fence = fences_[curFrame_];
 
+  flushDraws();
   cmdBuff.endRenderPass();
 
   cmdBuff.end();
 
+  if (cullDispatched_) {
+    // 剔除的结果作为间接绘制的参数，计数给CPU读回
+    vk::MemoryBarrier barrier;
+    barrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead |
+                          vk::AccessFlagBits::eHostRead);
+    computeCmdBuff.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader,
+        vk::PipelineStageFlagBits::eDrawIndirect |
+            vk::PipelineStageFlagBits::eHost,
+        {}, barrier, {}, {});
+  }
+  computeCmdBuff.end();
+
+  // 这一帧录制期间加载的资源也要在提交前获取
+  auto& ctx = Context::GetInstance();
+  auto& acquireCmdBuff = acquireCmdBuffs_[curFrame_];
+  vk::CommandBufferBeginInfo beginInfo;
+  beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+  acquireCmdBuff.reset();
+  acquireCmdBuff.begin(beginInfo);
+  auto upload = ctx.stagingRing->RecordAcquires(acquireCmdBuff);
+  acquireCmdBuff.end();
+
   vk::SubmitInfo submitInfo;
-  vk::PipelineStageFlags flags =
-      vk::PipelineStageFlagBits::eColorAttachmentOutput;
-  submitInfo.setCommandBuffers(cmdBuff)
-      .setWaitSemaphores(imageAvaliableSem)
+  // 同一批次按顺序执行，获取所有权和剔除在绘制之前
+  std::vector<vk::CommandBuffer> cmdBuffs;
+  std::vector<vk::Semaphore> waitSems = {imageAvaliableSem};
+  std::vector<vk::PipelineStageFlags> waitStages = {
+      vk::PipelineStageFlagBits::eColorAttachmentOutput};
+  // binary semaphore对应的值会被忽略
+  std::vector<uint64_t> waitValues = {0};
+  vk::TimelineSemaphoreSubmitInfo timelineInfo;
+  if (upload) {
+    cmdBuffs.push_back(acquireCmdBuff);
+    waitSems.push_back(ctx.stagingRing->Timeline());
+    waitStages.push_back(vk::PipelineStageFlagBits::eAllCommands);
+    waitValues.push_back(upload.value);
+    timelineInfo.setWaitSemaphoreValues(waitValues);
+    submitInfo.setPNext(&timelineInfo);
+  }
+  cmdBuffs.push_back(computeCmdBuff);
+  cmdBuffs.push_back(cmdBuff);
+  submitInfo.setCommandBuffers(cmdBuffs)
+      .setWaitSemaphores(waitSems)
       .setSignalSemaphores(renderFinishSem)
-      .setWaitDstStageMask(flags);
-  Context::GetInstance().graphicsQueue.submit(submitInfo, fence);
+      .setWaitDstStageMask(waitStages);
+  ctx.graphicsQueue.submit(submitInfo, fence);
+  ctx.deletionQueue->EndFrame();
 
   vk::PresentInfoKHR present;
   present.setImageIndices(imageIndex_)
@@ -148,35 +267,651 @@ void Renderer::EndRender() {
 }
 
 void Renderer::DrawModel(const Model& model) {
-  auto& ctx = Context::GetInstance();
-  auto& device = ctx.device;
+  const glm::vec4 sphere = model.WorldSphere();
+  // 排序时在EndRender统一剔除
+  if (!drawSorting_ && frustumCulling_ && !frustum_.Intersects(sphere)) {
+    frameStats_.culledModels++;
+    return;
+  }
+  DrawItem item{&model, model.modelMatrix, drawColor_, false, 0};
+  item.instanceCount = 1;
+  const uint32_t itemIndex = static_cast<uint32_t>(drawItems_.size());
+  const size_t firstPacket = drawPackets_.size();
+  const uint32_t depth = depthKey(model, model.modelMatrix);
+  auto addPacket = [&](const Material& material, uint32_t part) {
+    drawPackets_.push_back(
+        {sortKey(model, material, depth, false), itemIndex, part});
+  };
+
+  if (model.subMeshes.empty()) {
+    addPacket(*model.materials.back(), WholeModel);
+    frameStats_.triangles += model.indexCount / 3;
+  } else {
+    const uint32_t lodIndex = SelectLod(model);
+    const auto& lod = model.lods[lodIndex];
+    const bool useMeshlets =
+        lodIndex == 0 && meshletCulling_ && model.meshletCount > 0;
+    // 排序时等flushDraws剔除之后，只对可见的模型录制meshlet剔除。
+    // 先按subMesh记录，命令空间不够时就按subMesh绘制
+    item.meshletCandidate = useMeshlets && drawSorting_;
+    if (useMeshlets && !drawSorting_ &&
+        cullMeshlets(model, item.modelMatrix, item.commandOffset)) {
+      item.meshlets = true;
+      addMeshletPackets(model, itemIndex, depth);
+    } else {
+      for (uint32_t i = 0; i < lod.subMeshCount; i++) {
+        addPacket(model.MaterialOf(model.subMeshes[lod.firstSubMesh + i]),
+                  lod.firstSubMesh + i);
+      }
+    }
+    for (uint32_t i = 0; i < lod.subMeshCount; i++) {
+      frameStats_.triangles +=
+          model.subMeshes[lod.firstSubMesh + i].indexCount / 3;
+    }
+  }
+  submitDraw(item, sphere, firstPacket);
+}
+
+void Renderer::DrawModelInstanced(const Model& model,
+                                  const std::vector<glm::mat4>& transforms,
+                                  const std::vector<Color>& colors) {
+  if (transforms.empty()) {
+    return;
+  }
+  const uint32_t count = static_cast<uint32_t>(transforms.size());
+  const uint32_t firstInstance = pushInstances(transforms, colors);
+  DrawItem item{&model, glm::mat4(1.0f), drawColor_, false, 0};
+  item.instances = instanceBuffers_[curFrame_]->buffer;
+  item.firstInstance = firstInstance;
+  item.instanceCount = count;
+  const uint32_t itemIndex = static_cast<uint32_t>(drawItems_.size());
+  const size_t firstPacket = drawPackets_.size();
+  // 用第一个实例的距离排序
+  const uint32_t depth = depthKey(model, transforms[0]);
+  auto addPacket = [&](const Material& material, uint32_t part) {
+    drawPackets_.push_back(
+        {sortKey(model, material, depth, true), itemIndex, part});
+  };
+
+  if (model.subMeshes.empty()) {
+    addPacket(*model.materials.back(), WholeModel);
+    frameStats_.triangles += uint64_t(model.indexCount / 3) * count;
+  } else {
+    const auto& lod = model.lods[0];
+    for (uint32_t i = 0; i < lod.subMeshCount; i++) {
+      const auto& subMesh = model.subMeshes[lod.firstSubMesh + i];
+      addPacket(model.MaterialOf(subMesh), lod.firstSubMesh + i);
+      frameStats_.triangles += uint64_t(subMesh.indexCount / 3) * count;
+    }
+  }
+  // 实例分散在各处，不做整体的剔除
+  submitDraw(item,
+             glm::vec4(0.0f, 0.0f, 0.0f,
+                       std::numeric_limits<float>::infinity()),
+             firstPacket);
+}
+
+uint32_t Renderer::pushInstances(const std::vector<glm::mat4>& transforms,
+                                 const std::vector<Color>& colors) {
+  auto& buffer = instanceBuffers_[curFrame_];
+  const uint32_t count = static_cast<uint32_t>(transforms.size());
+  const uint32_t capacity =
+      static_cast<uint32_t>(buffer->size / sizeof(InstanceData));
+  if (instanceHead_ + count > capacity) {
+    // 这一帧已经录制的绘制还在使用旧的buffer，等帧结束后销毁
+    uint32_t newCapacity = capacity * 2;
+    while (newCapacity < count) {
+      newCapacity *= 2;
+    }
+    Context::GetInstance().deletionQueue->Push(std::move(buffer));
+    buffer.reset(new Buffer{sizeof(InstanceData) * newCapacity,
+                            vk::BufferUsageFlagBits::eVertexBuffer,
+                            MemoryUsage::eCpuToGpu});
+    instanceHead_ = 0;
+  }
+  auto instances = static_cast<InstanceData*>(buffer->map) + instanceHead_;
+  for (uint32_t i = 0; i < count; i++) {
+    instances[i].model = transforms[i];
+    instances[i].color =
+        glm::vec4(i < colors.size() ? colors[i] : drawColor_, 1.0f);
+  }
+  uint32_t first = instanceHead_;
+  instanceHead_ += count;
+  return first;
+}
+
+void Renderer::submitDraw(const DrawItem& item, const glm::vec4& sphere,
+                          size_t firstPacket) {
+  drawItems_.push_back(item);
+  itemSpheres_.Push(glm::vec3(sphere), sphere.w);
+  if (!drawSorting_) {
+    for (size_t i = firstPacket; i < drawPackets_.size(); i++) {
+      emitDraw(drawPackets_[i]);
+    }
+    drawPackets_.resize(firstPacket);
+  }
+}
+
+uint32_t Renderer::depthKey(const Model& model,
+                            const glm::mat4& modelMatrix) const {
+  // 非负float的位模式和数值的大小顺序一致，去掉低8位
+  const glm::vec3 center =
+      model.bounds.Valid() ? (model.bounds.min + model.bounds.max) * 0.5f
+                           : glm::vec3(0.0f);
+  const float distance =
+      glm::length(glm::vec3(modelMatrix * glm::vec4(center, 1.0f)) -
+                  lightMatrices_.cameraPosition);
+  uint32_t depth;
+  memcpy(&depth, &distance, sizeof(depth));
+  return depth >> 8;
+}
+
+uint64_t Renderer::sortKey(const Model& model, const Material& material,
+                           uint32_t depth, bool instanced) {
+  // 这一帧第一次出现时分配编号，超过16位只影响排序效果，绑定时比较的是实际的set
+  const Texture* texture = material.texture ? material.texture : model.texture;
+  const uint32_t materialId =
+      materialSortIds_
+          .emplace(&material, static_cast<uint32_t>(materialSortIds_.size()))
+          .first->second;
+  const uint32_t textureId =
+      textureSortIds_
+          .emplace(texture, static_cast<uint32_t>(textureSortIds_.size()))
+          .first->second;
+  // [63:56] pipeline [55:40] 材质 [39:24] 贴图 [23:0] 距离
+  const uint64_t pipeline =
+      (instanced ? 2 : 0) |
+      (model.vertexFormat == VertexFormat::ePacked ? 1 : 0);
+  return pipeline << 56 | uint64_t(materialId & 0xFFFF) << 40 |
+         uint64_t(textureId & 0xFFFF) << 24 | (depth & 0xFFFFFF);
+}
+
+void Renderer::addMeshletPackets(const Model& model, uint32_t itemIndex,
+                                 uint32_t depth) {
+  for (uint32_t i = 0; i < model.meshletGroups.size(); i++) {
+    const auto& material =
+        model.MaterialOf(model.subMeshes[model.meshletGroups[i].subMesh]);
+    drawPackets_.push_back(
+        {sortKey(model, material, depth, false), itemIndex, i});
+  }
+}
+
+void Renderer::flushDraws() {
+  // 立即录制的item已经剔除过，也不再有packet
+  const bool culled = frustumCulling_ && !drawPackets_.empty();
+  if (culled) {
+    itemVisible_.resize(itemSpheres_.Size());
+    const uint32_t visible =
+        CullSpheres(frustum_, itemSpheres_, itemVisible_.data());
+    frameStats_.culledModels +=
+        static_cast<uint32_t>(itemSpheres_.Size()) - visible;
+    drawPackets_.erase(
+        std::remove_if(drawPackets_.begin(), drawPackets_.end(),
+                       [&](const DrawPacket& packet) {
+                         return !itemVisible_[packet.item];
+                       }),
+        drawPackets_.end());
+  }
+  // 剔除之后才录制meshlet剔除，不可见的模型不占用命令空间
+  bool meshletItems = false;
+  for (uint32_t i = 0; i < drawItems_.size(); i++) {
+    auto& item = drawItems_[i];
+    if (item.meshletCandidate && (!culled || itemVisible_[i]) &&
+        cullMeshlets(*item.model, item.modelMatrix, item.commandOffset)) {
+      item.meshlets = true;
+      meshletItems = true;
+    }
+  }
+  if (meshletItems) {
+    // 换掉DrawModel时按subMesh记录的packet
+    drawPackets_.erase(
+        std::remove_if(drawPackets_.begin(), drawPackets_.end(),
+                       [&](const DrawPacket& packet) {
+                         return drawItems_[packet.item].meshlets;
+                       }),
+        drawPackets_.end());
+    for (uint32_t i = 0; i < drawItems_.size(); i++) {
+      const auto& item = drawItems_[i];
+      if (item.meshlets) {
+        addMeshletPackets(*item.model, i,
+                          depthKey(*item.model, item.modelMatrix));
+      }
+    }
+  }
+  RadixSortByKey(drawPackets_, sortScratch_);
+  for (const auto& packet : drawPackets_) {
+    emitDraw(packet);
+  }
+  drawPackets_.clear();
+  // 遮挡剔除时在帧中间也会录制，已录制的item不再被引用
+  drawItems_.clear();
+  itemSpheres_.Clear();
+  boundItem_ = WholeModel;
+}
+
+void Renderer::bindModel(const Model& model, vk::Buffer instances) {
   auto& cmdBuff = cmdBuffs_[curFrame_];
   auto& renderProcess = Context::GetInstance().renderProcess;
   vk::DeviceSize offset = 0;
 
-  cmdBuff.bindPipeline(vk::PipelineBindPoint::eGraphics,
-                       renderProcess->graphicsPipelineWithTriangleTopology);
-  //  todo
-  cmdBuff.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-                             renderProcess->pipelineLayout, 0,
-                             worldUniformDescriptorSets_[curFrame_].set, {});
-  cmdBuff.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-                             renderProcess->pipelineLayout, 1,
-                             model.texture->set.set, {});
-  cmdBuff.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-                             renderProcess->pipelineLayout, 2,
-                             model.material->set.set, {});
-  cmdBuff.bindVertexBuffers(0, model.vertexBuffer->buffer, offset);
-  cmdBuff.bindIndexBuffer(model.indicesBuffer->buffer, 0,
-                          vk::IndexType::eUint32);
-
-  cmdBuff.pushConstants(renderProcess->pipelineLayout,
-                        vk::ShaderStageFlagBits::eVertex, 0, sizeof(glm::mat4),
-                        &model.modelMatrix);
-  cmdBuff.pushConstants(renderProcess->pipelineLayout,
-                        vk::ShaderStageFlagBits::eFragment, sizeof(glm::mat4),
-                        sizeof(Color), &drawColor_);
-  cmdBuff.drawIndexed(model.indices.size(), 1, 0, 0, 0);
+  const bool packed = model.vertexFormat == VertexFormat::ePacked;
+  vk::Pipeline pipeline;
+  if (instances) {
+    pipeline = packed
+                   ? renderProcess->graphicsPipelineInstancedWithPackedVertex
+                   : renderProcess->graphicsPipelineInstanced;
+  } else {
+    pipeline = packed ? renderProcess->graphicsPipelineWithPackedVertex
+                      : renderProcess->graphicsPipelineWithTriangleTopology;
+  }
+  if (boundPipeline_ != pipeline) {
+    cmdBuff.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+    boundPipeline_ = pipeline;
+    frameStats_.pipelineBinds++;
+  } else {
+    frameStats_.bindsSaved++;
+  }
+  // 所有pipeline共用一个layout，切换pipeline后set仍然有效
+  bindWorld();
+  // GeometryPool中同一种格式的模型共用buffer，不需要重新绑定
+  if (boundVertexBuffer_ != model.VertexBuffer()) {
+    boundVertexBuffer_ = model.VertexBuffer();
+    cmdBuff.bindVertexBuffers(0, boundVertexBuffer_, offset);
+    frameStats_.bufferBinds++;
+  } else {
+    frameStats_.bindsSaved++;
+  }
+  if (boundIndexBuffer_ != model.IndexBuffer()) {
+    boundIndexBuffer_ = model.IndexBuffer();
+    cmdBuff.bindIndexBuffer(boundIndexBuffer_, 0, model.indexType);
+    frameStats_.bufferBinds++;
+  } else {
+    frameStats_.bindsSaved++;
+  }
+  // 整个buffer从0开始绑定，用firstInstance选择实例
+  if (instances) {
+    if (boundInstanceBuffer_ != instances) {
+      boundInstanceBuffer_ = instances;
+      cmdBuff.bindVertexBuffers(1, boundInstanceBuffer_, offset);
+      frameStats_.bufferBinds++;
+    } else {
+      frameStats_.bindsSaved++;
+    }
+  }
+}
+
+void Renderer::emitDraw(const DrawPacket& packet) {
+  auto& cmdBuff = cmdBuffs_[curFrame_];
+  auto& renderProcess = Context::GetInstance().renderProcess;
+  const auto& item = drawItems_[packet.item];
+  const Model& model = *item.model;
+  bindModel(model, item.instances);
+
+  if (boundItem_ != packet.item) {
+    cmdBuff.pushConstants(renderProcess->pipelineLayout,
+                          vk::ShaderStageFlagBits::eVertex, 0,
+                          sizeof(glm::mat4), &item.modelMatrix);
+    cmdBuff.pushConstants(renderProcess->pipelineLayout,
+                          vk::ShaderStageFlagBits::eFragment,
+                          sizeof(glm::mat4), sizeof(Color), &item.color);
+    if (model.vertexFormat == VertexFormat::ePacked) {
+      cmdBuff.pushConstants(renderProcess->pipelineLayout,
+                            vk::ShaderStageFlagBits::eVertex,
+                            PushConstantDequantizationOffset,
+                            sizeof(VertexDequantization),
+                            &model.dequantization);
+    }
+    boundItem_ = packet.item;
+  }
+
+  if (packet.part == WholeModel) {
+    bindMaterial(model, *model.materials.back());
+    cmdBuff.drawIndexed(model.indexCount, item.instanceCount,
+                        model.firstIndex, model.baseVertex,
+                        item.firstInstance);
+    frameStats_.drawCalls++;
+  } else if (item.meshlets) {
+    // 不可见的meshlet instanceCount为0，不需要CPU知道剔除结果
+    constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+    const auto& group = model.meshletGroups[packet.part];
+    bindMaterial(model, model.MaterialOf(model.subMeshes[group.subMesh]));
+    for (uint32_t first = 0; first < group.meshletCount;
+         first += maxDrawIndirectCount_) {
+      uint32_t count =
+          std::min(maxDrawIndirectCount_, group.meshletCount - first);
+      vk::DeviceSize commandOffset =
+          vk::DeviceSize(item.commandOffset + group.firstMeshlet + first) *
+          stride;
+      cmdBuff.drawIndexedIndirect(meshletCommandBuffers_[curFrame_]->buffer,
+                                  commandOffset, count, stride);
+      frameStats_.drawCalls++;
+    }
+  } else {
+    // 拆分过的模型每块有自己的vertexOffset
+    const auto& subMesh = model.subMeshes[packet.part];
+    bindMaterial(model, model.MaterialOf(subMesh));
+    cmdBuff.drawIndexed(subMesh.indexCount, item.instanceCount,
+                        model.firstIndex + subMesh.firstIndex,
+                        model.baseVertex + subMesh.vertexOffset,
+                        item.firstInstance);
+    frameStats_.drawCalls++;
+  }
+}
+
+void Renderer::bindWorld() {
+  // StartRender时标记为修改过，之后set 0一直保持绑定
+  if (!worldDirty_) {
+    frameStats_.bindsSaved++;
+    return;
+  }
+  worldOffsets_[0] = uniforms_->Push(vpMatrices_);
+  worldOffsets_[1] = uniforms_->Push(lightMatrices_);
+  worldDirty_ = false;
+  cmdBuffs_[curFrame_].bindDescriptorSets(
+      vk::PipelineBindPoint::eGraphics,
+      Context::GetInstance().renderProcess->pipelineLayout, 0, worldSet_.set,
+      worldOffsets_);
+  frameStats_.descriptorBinds++;
+}
+
+void Renderer::bindMaterial(const Model& model, const Material& material) {
+  auto& layout = Context::GetInstance().renderProcess->pipelineLayout;
+  // 同一帧里set 1、set 2和上一次相同时不重复绑定
+  const Texture* texture = material.texture ? material.texture : model.texture;
+  if (boundTextureSet_ != texture->set.set) {
+    cmdBuffs_[curFrame_].bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                            layout, 1, texture->set.set, {});
+    boundTextureSet_ = texture->set.set;
+    frameStats_.descriptorBinds++;
+  } else {
+    frameStats_.bindsSaved++;
+  }
+  if (boundMaterial_ == &material) {
+    frameStats_.bindsSaved++;
+    return;
+  }
+  auto uniform = materialUniformOffsets_.find(&material);
+  if (uniform == materialUniformOffsets_.end()) {
+    uniform = materialUniformOffsets_
+                  .emplace(&material, uniforms_->Push(material.info))
+                  .first;
+  }
+  cmdBuffs_[curFrame_].bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                          layout, 2, materialSet_.set,
+                                          uniform->second);
+  boundMaterial_ = &material;
+  frameStats_.materialBinds++;
+  frameStats_.descriptorBinds++;
+}
+
+// 从mvp矩阵的行组合出视锥的6个平面(Gribb-Hartmann)，深度范围[0, 1]
+bool Renderer::cullMeshlets(const Model& model, const glm::mat4& modelMatrix,
+                            uint32_t& commandOffset) {
+  auto& computeCmdBuff = computeCmdBuffs_[curFrame_];
+  auto& cullPipeline =
+      *Context::GetInstance().renderProcess->meshletCullPipeline;
+  commandOffset = meshletsDispatched_[curFrame_];
+  if (commandOffset + model.meshletCount > MaxMeshletCommands) {
+    return false;
+  }
+
+  // 在模型坐标下剔除，省去每个meshlet的变换。法线锥的角度只在均匀缩放下不变
+  MeshletCullPushConstants pushConstants{};
+  const Frustum frustum =
+      Frustum::FromMatrix(vpMatrices_.proj * vpMatrices_.view * modelMatrix);
+  std::copy(std::begin(frustum.planes), std::end(frustum.planes),
+            pushConstants.frustumPlanes);
+  pushConstants.cameraPosition = glm::inverse(modelMatrix) *
+                                 glm::vec4(lightMatrices_.cameraPosition, 1.0f);
+  pushConstants.meshletCount = model.meshletCount;
+  pushConstants.commandOffset = commandOffset;
+  pushConstants.flags = MeshletCullFrustum | MeshletCullCone;
+
+  computeCmdBuff.bindPipeline(vk::PipelineBindPoint::eCompute,
+                              cullPipeline.pipeline);
+  computeCmdBuff.bindDescriptorSets(
+      vk::PipelineBindPoint::eCompute, cullPipeline.layout, 0,
+      {model.meshletSet.set, meshletOutputSets_[curFrame_].set}, {});
+  computeCmdBuff.pushConstants(cullPipeline.layout,
+                               vk::ShaderStageFlagBits::eCompute, 0,
+                               sizeof(pushConstants), &pushConstants);
+  computeCmdBuff.dispatch((model.meshletCount + 63) / 64, 1, 1);
+  meshletsDispatched_[curFrame_] += model.meshletCount;
+  cullDispatched_ = true;
+  frameStats_.meshlets += model.meshletCount;
+  return true;
+}
+
+void Renderer::DrawGpuScene(GpuScene& scene) {
+  if (scene.DrawCount() == 0) {
+    return;
+  }
+  auto& ctx = Context::GetInstance();
+  auto& cmdBuff = cmdBuffs_[curFrame_];
+  auto& computeCmdBuff = computeCmdBuffs_[curFrame_];
+  auto& renderProcess = ctx.renderProcess;
+  auto& frame = scene.prepare(curFrame_);
+  // 只有这一帧第一次调用分两个阶段，之后已经在late pass中
+  const bool occlusion = occlusionFrame_ && !occlusionSplit_;
+  auto& cullPipeline = occlusion ? *renderProcess->objectOcclusionCullPipeline
+                                 : *renderProcess->objectCullPipeline;
+  const glm::mat4 viewProj = vpMatrices_.proj * vpMatrices_.view;
+
+  ObjectCullPushConstants pushConstants{};
+  std::copy(std::begin(frustum_.planes), std::end(frustum_.planes),
+            pushConstants.frustumPlanes);
+  pushConstants.drawCount = scene.DrawCount();
+  pushConstants.bucketCount = scene.BucketCount();
+  pushConstants.flags = ctx.drawIndirectCountEnabled ? ObjectCullCompact : 0;
+  if (occlusion) {
+    // 金字塔是上一帧生成的才能用，投影用当时的VP。否则第一阶段只做视锥剔除
+    if (pyramidFrame_ != 0 && pyramidFrame_ + 1 == frameSerial_) {
+      pushConstants.flags |= ObjectCullOcclusion;
+    }
+    auto params =
+        static_cast<OcclusionCullParams*>(occlusionParams_[curFrame_]->map);
+    params->viewProj[0] = pyramidViewProj_;
+    params->viewProj[1] = viewProj;
+    params->pyramidSize = glm::vec2(depthPyramid_->Extent().width,
+                                    depthPyramid_->Extent().height);
+    params->levelCount = depthPyramid_->LevelCount();
+  }
+  dispatchObjectCull(computeCmdBuff, cullPipeline, frame, pushConstants,
+                     occlusion);
+  cullDispatched_ = true;
+  drawGpuSceneBuckets(scene, frame, 0);
+  if (!occlusion) {
+    return;
+  }
+
+  // 第二阶段：用已经绘制的深度生成金字塔，重新测试第一阶段被遮挡的对象
+  // 排序中的DrawModel也要先录制，才能作为遮挡物
+  flushDraws();
+  cmdBuff.endRenderPass();
+  depthPyramid_->Build(cmdBuff);
+  // 第一阶段写入的遮挡标记和计数
+  vk::MemoryBarrier flagBarrier;
+  flagBarrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+      .setDstAccessMask(vk::AccessFlagBits::eShaderRead |
+                        vk::AccessFlagBits::eShaderWrite);
+  cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                          vk::PipelineStageFlagBits::eComputeShader, {},
+                          flagBarrier, {}, {});
+  pushConstants.flags |= ObjectCullOcclusion;
+  pushConstants.pass = 1;
+  dispatchObjectCull(cmdBuff, cullPipeline, frame, pushConstants, true);
+  vk::MemoryBarrier commandBarrier;
+  commandBarrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+      .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead |
+                        vk::AccessFlagBits::eHostRead);
+  cmdBuff.pipelineBarrier(
+      vk::PipelineStageFlagBits::eComputeShader,
+      vk::PipelineStageFlagBits::eDrawIndirect |
+          vk::PipelineStageFlagBits::eHost,
+      {}, commandBarrier, {}, {});
+  pyramidViewProj_ = viewProj;
+  pyramidFrame_ = frameSerial_;
+  occlusionSplit_ = true;
+  // compute的push constant之后，图形的push constant需要重新设置
+  boundItem_ = WholeModel;
+
+  // 加载第一阶段的颜色和深度，之后的绘制都在late pass中
+  vk::RenderPassBeginInfo renderPassBegin;
+  renderPassBegin.setRenderPass(renderProcess->occlusionLatePass)
+      .setRenderArea({{0, 0}, ctx.swapchain->info.imageExtent})
+      .setFramebuffer(ctx.swapchain->framebuffers[imageIndex_]);
+  cmdBuff.beginRenderPass(renderPassBegin, vk::SubpassContents::eInline);
+  drawGpuSceneBuckets(scene, frame, 1);
+}
+
+void Renderer::dispatchObjectCull(vk::CommandBuffer cmdBuff,
+                                  const ComputePipeline& pipeline,
+                                  const GpuScene::FrameResources& frame,
+                                  const ObjectCullPushConstants& pushConstants,
+                                  bool occlusion) {
+  cmdBuff.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.pipeline);
+  std::vector<vk::DescriptorSet> sets = {frame.inputSet.set,
+                                         frame.outputSet.set};
+  if (occlusion) {
+    sets.push_back(occlusionSets_[curFrame_].set);
+  }
+  cmdBuff.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline.layout,
+                             0, sets, {});
+  cmdBuff.pushConstants(pipeline.layout, vk::ShaderStageFlagBits::eCompute, 0,
+                        sizeof(pushConstants), &pushConstants);
+  cmdBuff.dispatch((pushConstants.drawCount + 63) / 64, 1, 1);
+}
+
+void Renderer::drawGpuSceneBuckets(const GpuScene& scene,
+                                   const GpuScene::FrameResources& frame,
+                                   uint32_t pass) {
+  auto& ctx = Context::GetInstance();
+  auto& cmdBuff = cmdBuffs_[curFrame_];
+  auto& renderProcess = ctx.renderProcess;
+  // 支持drawIndirectCount时只执行可见的命令，否则执行桶中的所有命令
+  constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+  const uint32_t commandBase = pass * scene.DrawCount();
+  const uint32_t countBase = pass * scene.BucketCount();
+  for (uint32_t i = 0; i < scene.buckets_.size(); i++) {
+    const auto& bucket = scene.buckets_[i];
+    const Model& model = *bucket.model;
+    bindModel(model, frame.instances->buffer);
+    if (model.vertexFormat == VertexFormat::ePacked) {
+      cmdBuff.pushConstants(renderProcess->pipelineLayout,
+                            vk::ShaderStageFlagBits::eVertex,
+                            PushConstantDequantizationOffset,
+                            sizeof(VertexDequantization),
+                            &model.dequantization);
+      boundItem_ = WholeModel;
+    }
+    bindMaterial(model, *bucket.material);
+    const uint32_t commandOffset = commandBase + bucket.commandOffset;
+    if (ctx.drawIndirectCountEnabled) {
+      cmdBuff.drawIndexedIndirectCount(
+          frame.commands->buffer, vk::DeviceSize(commandOffset) * stride,
+          frame.counts->buffer,
+          vk::DeviceSize(countBase + i) * sizeof(uint32_t), bucket.drawCount,
+          stride);
+      frameStats_.drawCalls++;
+      continue;
+    }
+    for (uint32_t first = 0; first < bucket.drawCount;
+         first += maxDrawIndirectCount_) {
+      uint32_t count =
+          std::min(maxDrawIndirectCount_, bucket.drawCount - first);
+      cmdBuff.drawIndexedIndirect(
+          frame.commands->buffer,
+          vk::DeviceSize(commandOffset + first) * stride, count, stride);
+      frameStats_.drawCalls++;
+    }
+  }
+}
+
+void Renderer::ensureDepthPyramid() {
+  auto& ctx = Context::GetInstance();
+  auto& swapchain = *ctx.swapchain;
+  if (depthPyramid_ && pyramidGeneration_ == swapchain.attachmentGeneration) {
+    return;
+  }
+  // 之前的帧可能还在使用
+  ctx.deletionQueue->Push(std::move(depthPyramid_));
+  for (const auto& set : occlusionSets_) {
+    ctx.deletionQueue->Push([set]() {
+      DescriptorSetManager::GetInstance().FreeComputeImageSet(set);
+    });
+  }
+  occlusionSets_.clear();
+  depthPyramid_.reset(
+      new DepthPyramid{swapchain.attachmentExtent, swapchain.DepthView()});
+  pyramidGeneration_ = swapchain.attachmentGeneration;
+  pyramidFrame_ = 0;
+
+  auto& pipeline = *ctx.renderProcess->objectOcclusionCullPipeline;
+  occlusionParams_.resize(maxFlightCount_);
+  for (int i = 0; i < maxFlightCount_; i++) {
+    if (!occlusionParams_[i]) {
+      occlusionParams_[i].reset(new Buffer{
+          sizeof(OcclusionCullParams), vk::BufferUsageFlagBits::eStorageBuffer,
+          MemoryUsage::eCpuToGpu});
+    }
+    occlusionSets_.push_back(
+        DescriptorSetManager::GetInstance().AllocComputeImageSet(
+            pipeline.setLayouts[2]));
+    vk::DescriptorImageInfo imageInfo;
+    imageInfo.setImageView(depthPyramid_->View())
+        .setSampler(depthPyramid_->Sampler())
+        .setImageLayout(vk::ImageLayout::eGeneral);
+    vk::DescriptorBufferInfo bufferInfo;
+    bufferInfo.setBuffer(occlusionParams_[i]->buffer)
+        .setOffset(0)
+        .setRange(VK_WHOLE_SIZE);
+    std::array<vk::WriteDescriptorSet, 2> writeInfos;
+    writeInfos[0]
+        .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+        .setImageInfo(imageInfo)
+        .setDstBinding(0);
+    writeInfos[1]
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(bufferInfo)
+        .setDstBinding(1);
+    for (auto& writeInfo : writeInfos) {
+      writeInfo.setDstSet(occlusionSets_.back().set)
+          .setDstArrayElement(0)
+          .setDescriptorCount(1);
+    }
+    ctx.device.updateDescriptorSets(writeInfos, {});
+  }
+}
+
+uint32_t Renderer::SelectLod(const Model& model) const {
+  if (model.lods.size() <= 1 || !model.bounds.Valid()) {
+    return 0;
+  }
+  const glm::vec4 sphere = model.WorldSphere();
+  const float scale = std::max(
+      std::max(glm::length(glm::vec3(model.modelMatrix[0])),
+               glm::length(glm::vec3(model.modelMatrix[1]))),
+      glm::length(glm::vec3(model.modelMatrix[2])));
+  const float distance =
+      glm::length(glm::vec3(sphere) - lightMatrices_.cameraPosition) -
+      sphere.w;
+  if (distance <= 0.0f) {
+    return 0;
+  }
+
+  // 透视投影下，距离d处长度e在屏幕上占 e / d * proj[1][1] * height / 2 像素
+  const float height = static_cast<float>(
+      Context::GetInstance().swapchain->info.imageExtent.height);
+  const float pixelsPerUnit =
+      std::abs(vpMatrices_.proj[1][1]) * height * 0.5f / distance;
+  uint32_t selected = 0;
+  for (uint32_t i = 1; i < model.lods.size(); i++) {
+    if (model.lods[i].error * scale * pixelsPerUnit > lodThreshold_) {
+      break;
+    }
+    selected = i;
+  }
+  return selected;
 }
 
 // void Renderer::DrawTexture(const Rect& rect, Texture& texture) {
@@ -259,33 +994,57 @@ void Renderer::createFences() {
 }
 
 void Renderer::createUniformBuffers() {
-  size_t sizeVPM = sizeof(ViewProjectMatrices);
-  size_t sizeLM = sizeof(LightInfo);
-  uniformVPBuffers.resize(maxFlightCount_);
-  uniformLightBuffers.resize(maxFlightCount_);
-
-  for (size_t i = 0; i < maxFlightCount_; i++) {
-    uniformVPBuffers[i].reset(
-        new Buffer{sizeVPM, vk::BufferUsageFlagBits::eUniformBuffer,
-                   vk::MemoryPropertyFlagBits::eHostCoherent |
-                       vk::MemoryPropertyFlagBits::eHostVisible});
-    uniformLightBuffers[i].reset(
-        new Buffer{sizeLM, vk::BufferUsageFlagBits::eUniformBuffer,
-                   vk::MemoryPropertyFlagBits::eHostCoherent |
-                       vk::MemoryPropertyFlagBits::eHostVisible});
-  }
+  uniforms_.reset(new UniformAllocator(maxFlightCount_));
 }
 
-void Renderer::bufferVPData() {
-  for (int i = 0; i < uniformVPBuffers.size(); i++) {
-    memcpy(uniformVPBuffers[i]->map, &vpMatrices_, sizeof(vpMatrices_));
-  }
-}
+void Renderer::createMeshletCullResources() {
+  auto& ctx = Context::GetInstance();
+  // 不支持multiDrawIndirect时每次间接绘制只能有一条命令
+  maxDrawIndirectCount_ =
+      ctx.enabledFeatures.multiDrawIndirect
+          ? ctx.phyDevice.getProperties().limits.maxDrawIndirectCount
+          : 1;
+
+  size_t commandSize =
+      sizeof(vk::DrawIndexedIndirectCommand) * MaxMeshletCommands;
+  meshletCommandBuffers_.resize(maxFlightCount_);
+  meshletStatsBuffers_.resize(maxFlightCount_);
+  meshletOutputSets_.resize(maxFlightCount_);
+  meshletsDispatched_.resize(maxFlightCount_, 0);
+  for (int i = 0; i < maxFlightCount_; i++) {
+    meshletCommandBuffers_[i].reset(
+        new Buffer{commandSize,
+                   vk::BufferUsageFlagBits::eStorageBuffer |
+                       vk::BufferUsageFlagBits::eIndirectBuffer,
+                   MemoryUsage::eGpuOnly});
+    meshletStatsBuffers_[i].reset(
+        new Buffer{sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer,
+                   MemoryUsage::eGpuToCpu});
+    memset(meshletStatsBuffers_[i]->map, 0, sizeof(uint32_t));
 
-void Renderer::bufferLightData() {
-  for (int i = 0; i < uniformLightBuffers.size(); i++) {
-    memcpy(uniformLightBuffers[i]->map, &lightMatrices_,
-           sizeof(lightMatrices_));
+    meshletOutputSets_[i] =
+        DescriptorSetManager::GetInstance().AllocStorageBufferSet(
+            ctx.renderProcess->meshletCullPipeline->setLayouts[1]);
+    std::array<vk::DescriptorBufferInfo, 2> bufferInfos;
+    bufferInfos[0]
+        .setBuffer(meshletCommandBuffers_[i]->buffer)
+        .setOffset(0)
+        .setRange(commandSize);
+    bufferInfos[1]
+        .setBuffer(meshletStatsBuffers_[i]->buffer)
+        .setOffset(0)
+        .setRange(sizeof(uint32_t));
+    std::array<vk::WriteDescriptorSet, 2> writeInfos;
+    for (uint32_t binding = 0; binding < 2; binding++) {
+      writeInfos[binding]
+          .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+          .setBufferInfo(bufferInfos[binding])
+          .setDstBinding(binding)
+          .setDstSet(meshletOutputSets_[i].set)
+          .setDstArrayElement(0)
+          .setDescriptorCount(1);
+    }
+    ctx.device.updateDescriptorSets(writeInfos, {});
   }
 }
 
@@ -294,6 +1053,7 @@ void Renderer::SetDrawColor(const Color& color) { drawColor_ = color; }
 void Renderer::initMats() {
   vpMatrices_.proj = glm::identity<glm::mat4>();
   vpMatrices_.view = glm::identity<glm::mat4>();
+  frustum_ = Frustum::FromMatrix(vpMatrices_.proj * vpMatrices_.view);
 
   lightMatrices_.position = glm::zero<glm::vec3>();
   lightMatrices_.intensity = glm::zero<glm::float32>();
@@ -308,21 +1068,22 @@ void Renderer::initMats() {
 void Renderer::SetProjection(float fov, float aspect, float near, float far) {
   vpMatrices_.proj = glm::perspective(fov, aspect, near, far);
   vpMatrices_.proj[1][1] *= -1;
-  bufferVPData();
+  frustum_ = Frustum::FromMatrix(vpMatrices_.proj * vpMatrices_.view);
+  worldDirty_ = true;
 }
 
 void Renderer::SetView(const glm::vec3 eye, const glm::vec3 center,
                        const glm::vec3 up) {
   vpMatrices_.view = glm::lookAt(eye, center, up);
   lightMatrices_.cameraPosition = eye;
-  bufferVPData();
-  bufferLightData();
+  frustum_ = Frustum::FromMatrix(vpMatrices_.proj * vpMatrices_.view);
+  worldDirty_ = true;
 }
 
 void Renderer::SetLight(glm::vec3 lightPos, glm::float32 lightIntensity) {
   lightMatrices_.position = lightPos;
   lightMatrices_.intensity = lightIntensity;
-  bufferLightData();
+  worldDirty_ = true;
 }
 
 void Renderer::copyBuffer(vk::Buffer& src, vk::Buffer& dst, size_t size,
@@ -337,36 +1098,44 @@ void Renderer::copyBuffer(vk::Buffer& src, vk::Buffer& dst, size_t size,
 }
 
 void Renderer::updateDescriptorSets() {
-  for (int i = 0; i < maxFlightCount_; i++) {
-    std::vector<vk::WriteDescriptorSet> writeInfos(2);
-    auto& set = worldUniformDescriptorSets_[i];
-    // bind VP buffer
-    vk::DescriptorBufferInfo bufferInfoVP;
-    bufferInfoVP.setBuffer(uniformVPBuffers[i]->buffer)
-        .setOffset(0)
-        .setRange(sizeof(vpMatrices_));
-    vk::DescriptorBufferInfo bufferInfoLight;
-    bufferInfoLight.setBuffer(uniformLightBuffers[i]->buffer)
-        .setOffset(0)
-        .setRange(sizeof(LightInfo));
+  // 都指向buffer开头，绘制时的dynamic offset加上这里的offset
+  vk::DescriptorBufferInfo bufferInfoVP;
+  bufferInfoVP.setBuffer(uniforms_->GetBuffer())
+      .setOffset(0)
+      .setRange(sizeof(vpMatrices_));
+  vk::DescriptorBufferInfo bufferInfoLight;
+  bufferInfoLight.setBuffer(uniforms_->GetBuffer())
+      .setOffset(0)
+      .setRange(sizeof(LightInfo));
+  vk::DescriptorBufferInfo bufferInfoMaterial;
+  bufferInfoMaterial.setBuffer(uniforms_->GetBuffer())
+      .setOffset(0)
+      .setRange(sizeof(MaterialInfo));
 
-    writeInfos[0]
-        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-        .setBufferInfo(bufferInfoVP)
-        .setDstBinding(0)
-        .setDstSet(set.set)
-        .setDstArrayElement(0)
-        .setDescriptorCount(1);
-    writeInfos[1]
-        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-        .setBufferInfo(bufferInfoLight)
-        .setDstBinding(1)
-        .setDstSet(set.set)
-        .setDstArrayElement(0)
-        .setDescriptorCount(1);
+  std::vector<vk::WriteDescriptorSet> writeInfos(3);
+  writeInfos[0]
+      .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
+      .setBufferInfo(bufferInfoVP)
+      .setDstBinding(0)
+      .setDstSet(worldSet_.set)
+      .setDstArrayElement(0)
+      .setDescriptorCount(1);
+  writeInfos[1]
+      .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
+      .setBufferInfo(bufferInfoLight)
+      .setDstBinding(1)
+      .setDstSet(worldSet_.set)
+      .setDstArrayElement(0)
+      .setDescriptorCount(1);
+  writeInfos[2]
+      .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
+      .setBufferInfo(bufferInfoMaterial)
+      .setDstBinding(0)
+      .setDstSet(materialSet_.set)
+      .setDstArrayElement(0)
+      .setDescriptorCount(1);
 
-    Context::GetInstance().device.updateDescriptorSets(writeInfos, {});
-  }
+  Context::GetInstance().device.updateDescriptorSets(writeInfos, {});
 }
 
 }  // namespace sktr
\ No newline at end of file
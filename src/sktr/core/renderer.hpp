@@ -1,14 +1,48 @@
 #pragma once
+#include <unordered_map>
+
+#include "gpu_scene.hpp"
 #include "model.hpp"
 #include "sktr/pch.hpp"
 #include "sktr/system/buffer.hpp"
+#include "sktr/system/depth_pyramid.hpp"
 #include "sktr/system/descriptor_manager.hpp"
+#include "sktr/system/uniform_allocator.hpp"
+#include "sktr/utils/frustum.hpp"
 #include "sktr/utils/math.hpp"
 #include "texture.hpp"
 
 namespace sktr {
 class Renderer final {
  public:
+  // 当前帧录制的绘制统计，StartRender时清零
+  struct FrameStats {
+    uint32_t drawCalls = 0;
+    uint32_t materialBinds = 0;
+    uint32_t pipelineBinds = 0;
+    // 所有set的绑定，包括materialBinds
+    uint32_t descriptorBinds = 0;
+    uint32_t bufferBinds = 0;
+    // 和已绑定的状态相同而跳过的pipeline、set和buffer绑定
+    uint32_t bindsSaved = 0;
+    // 视锥剔除和meshlet剔除前的三角形数
+    uint64_t triangles = 0;
+    // 包围球在视锥外而没有录制的DrawModel次数
+    uint32_t culledModels = 0;
+    // 提交给剔除着色器的meshlet数
+    uint32_t meshlets = 0;
+  };
+  // 剔除结果要等GPU执行完才能读回，是maxFlightCount帧之前的结果
+  struct MeshletCullStats {
+    uint32_t total = 0;
+    uint32_t visible = 0;
+  };
+
+  // 每帧最多剔除的meshlet数，超出后按subMesh直接绘制
+  static constexpr uint32_t MaxMeshletCommands = 65536;
+  // 每帧实例buffer的初始容量，不够时翻倍
+  static constexpr uint32_t DefaultInstanceCapacity = 16384;
+
   Renderer(int width, int height, int maxFlightCount = 2);
   ~Renderer();
 
@@ -16,16 +50,66 @@ class Renderer final {
   void SetView(const glm::vec3 eye, const glm::vec3 center, const glm::vec3 up);
   void SetLight(glm::vec3 lightPos, glm::float32 lightIntensity);
   void SetDrawColor(const Color& color);
+  // LOD投影到屏幕上的误差不超过多少像素
+  void SetLodThreshold(float pixels) { lodThreshold_ = pixels; }
+  // 绘制LOD0时是否先用meshlet做视锥和背面剔除
+  void SetMeshletCulling(bool enable) { meshletCulling_ = enable; }
+  /**
+   * @brief  DrawModel只记录绘制，EndRender时按状态排序后统一录制
+   * @note   排序键从高到低是pipeline、材质、贴图和相机距离(由近到远)。
+   *         模型矩阵和颜色在DrawModel时复制，VP和light使用EndRender时的值。
+   *         关闭时DrawModel立即录制，默认开启
+   */
+  void SetDrawSorting(bool enable) { drawSorting_ = enable; }
+  /**
+   * @brief  录制之前用模型的世界包围球做视锥剔除，默认开启
+   * @note   排序时在EndRender按SoA批量剔除，否则在DrawModel时逐个判断。
+   *         实例化绘制不剔除
+   */
+  void SetFrustumCulling(bool enable) { frustumCulling_ = enable; }
+  /**
+   * @brief  DrawGpuScene是否做两个阶段的遮挡剔除，默认开启
+   * @note   Init时没有开启occlusionCulling则没有效果。第一阶段按上一帧的
+   *         深度金字塔剔除并绘制，然后用这一帧已有的深度生成金字塔，
+   *         重新测试被遮挡的对象。render pass在DrawGpuScene中切换，
+   *         切换前录制排序中的DrawModel，之前的绘制都作为遮挡物。
+   *         结果见GpuScene::GetCullStats
+   */
+  void SetOcclusionCulling(bool enable) { occlusionCulling_ = enable; }
 
   // 开启render pass 并绑定渲染管线
   bool StartRender();
   // 结束render pass 并提交命令
   void EndRender();
 
+  // 开启排序时EndRender之前模型不能销毁
   // 可以绘制多个图片
   void DrawTexture(const Rect& rect, Texture& texture);
   void DrawLine(const Vec2& p1, const Vec2& p2);
   void DrawModel(const Model& model);
+  /**
+   * @brief  一次实例化绘制，画出模型的多个副本
+   * @note   实例数据在调用时写入这一帧的实例buffer，忽略model.modelMatrix。
+   *         总是绘制LOD0，不使用meshlet剔除
+   * @param  transforms: 每个实例的模型矩阵
+   * @param  colors: 每个实例的颜色，为空时都使用SetDrawColor的颜色
+   */
+  void DrawModelInstanced(const Model& model,
+                          const std::vector<glm::mat4>& transforms,
+                          const std::vector<Color>& colors = {});
+  /**
+   * @brief  GPU剔除并间接绘制scene中的所有对象
+   * @note   剔除在render pass之前的compute中执行，每个桶一次间接绘制，
+   *         立即录制，不参与排序。每帧最多调用一次
+   */
+  void DrawGpuScene(GpuScene& scene);
+
+  // 按当前的view/projection选择满足lodThreshold_的最粗LOD
+  uint32_t SelectLod(const Model& model) const;
+  const FrameStats& GetFrameStats() const { return frameStats_; }
+  const MeshletCullStats& GetMeshletCullStats() const {
+    return meshletCullStats_;
+  }
 
   void GetInstance();
 
@@ -38,6 +122,10 @@ class Renderer final {
   LightInfo lightMatrices_;
 
   std::vector<vk::CommandBuffer> cmdBuffs_;
+  // 在render pass之前执行的剔除，和cmdBuffs_一起提交
+  std::vector<vk::CommandBuffer> computeCmdBuffs_;
+  // 获取异步上传资源的所有权，有需要时放在这一帧提交的最前面
+  std::vector<vk::CommandBuffer> acquireCmdBuffs_;
 
   std::vector<vk::Semaphore> imageAvaliableSems_;
   std::vector<vk::Semaphore> renderFinishSems_;
@@ -52,12 +140,100 @@ class Renderer final {
 
   // std::vector<std::unique_ptr<Buffer>> hostColorBuffers_;
   // std::vector<std::unique_ptr<Buffer>> deviceColorBuffers_;
-  std::vector<std::unique_ptr<Buffer>> uniformVPBuffers;
-  std::vector<std::unique_ptr<Buffer>> uniformLightBuffers;
+  // VP、light和材质的uniform，每帧写入自己的一段
+  std::unique_ptr<UniformAllocator> uniforms_;
+  DescriptorSetManager::SetInfo worldSet_;
+  DescriptorSetManager::SetInfo materialSet_;
+  // VP或light修改过，下一次绘制前写入当前帧
+  bool worldDirty_ = true;
+  std::array<uint32_t, 2> worldOffsets_ = {};
+  // StartRender的次数，用于判断材质在这一帧是否写入过
+  uint64_t frameSerial_ = 0;
 
-  std::vector<DescriptorSetManager::SetInfo> worldUniformDescriptorSets_;
   Texture* whiteTexture;
   Color drawColor_ = {1, 1, 1};
+  float lodThreshold_ = 1.0f;
+  FrameStats frameStats_;
+  vk::Pipeline boundPipeline_ = nullptr;
+  const Material* boundMaterial_ = nullptr;
+  vk::DescriptorSet boundTextureSet_ = nullptr;
+  vk::Buffer boundVertexBuffer_ = nullptr;
+  // 同一个buffer中只有一种索引类型
+  vk::Buffer boundIndexBuffer_ = nullptr;
+  vk::Buffer boundInstanceBuffer_ = nullptr;
+
+  // 每帧的InstanceData，CPU直接写入，满了之后换一个更大的
+  std::vector<std::unique_ptr<Buffer>> instanceBuffers_;
+  // 当前帧的buffer中已写入的实例数
+  uint32_t instanceHead_ = 0;
+
+  // DrawModel记录的一次绘制，排序后按packet录制
+  struct DrawItem {
+    const Model* model;
+    glm::mat4 modelMatrix;
+    Color color;
+    // 使用meshlet剔除时，part是meshletGroups的下标
+    bool meshlets;
+    uint32_t commandOffset;
+    // 实例化绘制时是instanceBuffers_中的一段，否则为空
+    vk::Buffer instances;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+    // 排序时在flushDraws剔除后再尝试meshlet剔除，成功后meshlets为true
+    bool meshletCandidate = false;
+  };
+  // subMesh或meshlet组的一次绘制，只有key参与排序
+  struct DrawPacket {
+    uint64_t key;
+    uint32_t item;
+    // subMeshes或meshletGroups的下标，没有subMesh时为WholeModel
+    uint32_t part;
+  };
+  static constexpr uint32_t WholeModel = ~0u;
+
+  bool drawSorting_ = true;
+  // 当前帧还没有录制的DrawItem，flushDraws后清空
+  std::vector<DrawItem> drawItems_;
+  std::vector<DrawPacket> drawPackets_;
+  std::vector<DrawPacket> sortScratch_;
+  bool frustumCulling_ = true;
+  // VP修改时更新，世界坐标下的平面
+  Frustum frustum_;
+  // 和drawItems_一一对应的世界包围球，flushDraws时批量剔除
+  SphereBoundsSoA itemSpheres_;
+  std::vector<uint8_t> itemVisible_;
+  // 上一次push constant的DrawItem
+  uint32_t boundItem_ = WholeModel;
+  // 排序键中的编号，每帧第一次提交时按顺序分配，StartRender时清空
+  std::unordered_map<const Material*, uint32_t> materialSortIds_;
+  std::unordered_map<const Texture*, uint32_t> textureSortIds_;
+  // 材质在当前帧uniform中的偏移，同一帧内多次绑定只写一次
+  std::unordered_map<const Material*, uint32_t> materialUniformOffsets_;
+
+  bool meshletCulling_ = true;
+  // 每帧的间接绘制命令和可见meshlet计数，剔除着色器的set 1
+  std::vector<std::unique_ptr<Buffer>> meshletCommandBuffers_;
+  std::vector<std::unique_ptr<Buffer>> meshletStatsBuffers_;
+  std::vector<DescriptorSetManager::SetInfo> meshletOutputSets_;
+  std::vector<uint32_t> meshletsDispatched_;
+  uint32_t maxDrawIndirectCount_;
+  // 这一帧录制了剔除，提交前需要屏障
+  bool cullDispatched_ = false;
+  MeshletCullStats meshletCullStats_;
+
+  bool occlusionCulling_ = true;
+  // 这一帧从early pass开始，DrawGpuScene之后切换到了late pass
+  bool occlusionFrame_ = false;
+  bool occlusionSplit_ = false;
+  std::unique_ptr<DepthPyramid> depthPyramid_;
+  // 和Swapchain::attachmentGeneration不同时重新创建
+  uint64_t pyramidGeneration_ = 0;
+  // 生成金字塔的帧和当时的VP，0表示还没有生成
+  uint64_t pyramidFrame_ = 0;
+  glm::mat4 pyramidViewProj_ = glm::mat4(1.0f);
+  // 每帧的OcclusionCullParams和object_cull_occlusion的set 2
+  std::vector<std::unique_ptr<Buffer>> occlusionParams_;
+  std::vector<DescriptorSetManager::SetInfo> occlusionSets_;
 
   void allocCmdBuffers();
   void createSemaphores();
@@ -65,9 +241,48 @@ class Renderer final {
 
   void createBuffers();
   void createUniformBuffers();
+  void createMeshletCullResources();
+
+  // 写入VP和light并绑定set 0，没有修改过时跳过
+  void bindWorld();
+  // 材质没有贴图时使用模型的贴图
+  void bindMaterial(const Model& model, const Material& material);
+
+  // 录制LOD0的剔除，命令空间不够时返回false
+  bool cullMeshlets(const Model& model, const glm::mat4& modelMatrix,
+                    uint32_t& commandOffset);
+  // 按meshlet组添加item的packet
+  void addMeshletPackets(const Model& model, uint32_t itemIndex,
+                         uint32_t depth);
+
+  // occlusion时绑定set 2
+  void dispatchObjectCull(vk::CommandBuffer cmdBuff,
+                          const ComputePipeline& pipeline,
+                          const GpuScene::FrameResources& frame,
+                          const ObjectCullPushConstants& pushConstants,
+                          bool occlusion);
+  // 录制一个阶段的间接绘制
+  void drawGpuSceneBuckets(const GpuScene& scene,
+                           const GpuScene::FrameResources& frame,
+                           uint32_t pass);
+  // 深度附件重新创建后重新创建金字塔和set 2
+  void ensureDepthPyramid();
 
-  void bufferVPData();
-  void bufferLightData();
+  // 返回第一个实例在当前帧buffer中的下标
+  uint32_t pushInstances(const std::vector<glm::mat4>& transforms,
+                         const std::vector<Color>& colors);
+  // 包围盒中心到相机的距离，量化成24位
+  uint32_t depthKey(const Model& model, const glm::mat4& modelMatrix) const;
+  uint64_t sortKey(const Model& model, const Material& material,
+                   uint32_t depth, bool instanced);
+  // 加入item，不排序时立即录制它从firstPacket开始的packet
+  void submitDraw(const DrawItem& item, const glm::vec4& sphere,
+                  size_t firstPacket);
+  // 绑定pipeline、set 0和顶点/索引buffer，instances不为空时使用实例化pipeline
+  void bindModel(const Model& model, vk::Buffer instances);
+  void emitDraw(const DrawPacket& packet);
+  // 剔除、排序并录制drawPackets_
+  void flushDraws();
 
   void initMats();
 
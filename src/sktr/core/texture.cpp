@@ -24,17 +24,12 @@ void ImageResource::createImage(uint32_t w, uint32_t h, uint32_t mipLevels,
   image = Context::GetInstance().device.createImage(imageInfo);
 }
 
-void ImageResource::allocMemory(vk::MemoryPropertyFlags properties) {
-  auto& device = Context::GetInstance().device;
-  vk::MemoryAllocateInfo allocateInfo;
-
-  auto requirements = device.getImageMemoryRequirements(image);
-  allocateInfo.setAllocationSize(requirements.size);
-
-  auto index = QueryMemoryTypeIndex(requirements.memoryTypeBits, properties);
-  allocateInfo.setMemoryTypeIndex(index);
-
-  memory = device.allocateMemory(allocateInfo);
+void ImageResource::allocMemory(MemoryUsage memoryUsage,
+                                vk::ImageTiling tiling) {
+  allocation = Context::GetInstance().memoryAllocator->AllocateForImage(
+      image, memoryUsage,
+      tiling == vk::ImageTiling::eOptimal ? ResourceTiling::eOptimal
+                                          : ResourceTiling::eLinear);
 }
 
 void ImageResource::createImageView(vk::Format format,
@@ -60,12 +55,10 @@ ImageResource ImageResource::CreateColorResource(
     uint32_t w, uint32_t h, uint32_t mipLevels,
     vk::SampleCountFlagBits numSamples, vk::Format format,
     vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-    vk::MemoryPropertyFlags properties) {
+    MemoryUsage memoryUsage) {
   ImageResource resource;
   resource.createImage(w, h, mipLevels, numSamples, format, tiling, usage);
-  resource.allocMemory(properties);
-  Context::GetInstance().device.bindImageMemory(resource.image, resource.memory,
-                                                0);
+  resource.allocMemory(memoryUsage, tiling);
   resource.createImageView(format, vk::ImageAspectFlagBits::eColor, mipLevels);
   return resource;
 }
@@ -74,16 +67,12 @@ ImageResource ImageResource::CreateDepthResource(
     uint32_t w, uint32_t h, uint32_t mipLevels,
     vk::SampleCountFlagBits numSamples, vk::Format format,
     vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-    vk::MemoryPropertyFlags properties) {
+    MemoryUsage memoryUsage) {
   ImageResource resource;
   resource.createImage(w, h, mipLevels, numSamples, format, tiling, usage);
-  resource.allocMemory(properties);
-  Context::GetInstance().device.bindImageMemory(resource.image, resource.memory,
-                                                0);
+  resource.allocMemory(memoryUsage, tiling);
   resource.createImageView(format, vk::ImageAspectFlagBits::eDepth, mipLevels);
-  resource.transitionImageLayout(
-      format, vk::ImageLayout::eUndefined,
-      vk::ImageLayout::eDepthStencilAttachmentOptimal, mipLevels);
+  // render pass的initialLayout是undefined，第一次使用时由render pass转换
   return resource;
 }
 
@@ -162,17 +151,33 @@ void ImageResource::transitionImageLayout(vk::Format format,
 }
 
 ImageResource::~ImageResource() {
-  auto& device = Context::GetInstance().device;
-  device.destroyImageView(view);
-  device.freeMemory(memory);
-  device.destroyImage(image);
+  auto& ctx = Context::GetInstance();
+  ctx.device.destroyImageView(view);
+  ctx.device.destroyImage(image);
+  ctx.memoryAllocator->Free(allocation);
+}
+
+Texture::Texture(std::string_view filename, bool deferMipmaps) {
+  initFromSurface(IMG_Load(filename.data()), filename.data(), deferMipmaps);
 }
 
-Texture::Texture(std::string_view filename) {
-  auto surface = SDL_ConvertSurfaceFormat(IMG_Load(filename.data()),
-                                          SDL_PIXELFORMAT_RGBA32, 0);
+Texture::Texture(const void* data, size_t size, bool deferMipmaps) {
+  initFromSurface(
+      IMG_Load_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1),
+      "memory image", deferMipmaps);
+}
+
+void Texture::initFromSurface(SDL_Surface* loaded, const char* name,
+                              bool deferMipmaps) {
+  if (!loaded) {
+    throw std::runtime_error(std::string("load ") + name +
+                             " failed: " + IMG_GetError());
+  }
+  auto surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(loaded);
   if (!surface) {
-    SDL_Log("load %s failed", filename);
+    throw std::runtime_error(std::string("convert ") + name +
+                             " failed: " + SDL_GetError());
   }
   auto w = surface->w;
   auto h = surface->h;
@@ -182,7 +187,7 @@ Texture::Texture(std::string_view filename) {
        vk::Format::eR8G8B8A8Srgb, vk::ImageTiling::eOptimal,
        vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled |
            vk::ImageUsageFlagBits::eTransferSrc,
-       vk::MemoryPropertyFlagBits::eDeviceLocal);
+       MemoryUsage::eGpuOnly, deferMipmaps);
 
   SDL_FreeSurface(surface);
 }
@@ -190,31 +195,26 @@ Texture::Texture(std::string_view filename) {
 Texture::Texture(void* data, uint32_t w, uint32_t h, uint32_t mipLevels,
                  vk::SampleCountFlagBits numSamples, vk::Format format,
                  vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-                 vk::MemoryPropertyFlags properties) {
-  init(data, w, h, mipLevels, numSamples, format, tiling, usage, properties);
+                 MemoryUsage memoryUsage) {
+  init(data, w, h, mipLevels, numSamples, format, tiling, usage, memoryUsage);
 }
 
 void Texture::init(void* data, uint32_t w, uint32_t h, uint32_t mipLevels,
                    vk::SampleCountFlagBits numSamples, vk::Format format,
                    vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-                   vk::MemoryPropertyFlags properties) {
-  const uint32_t size = w * h * 4;
-
-  std::unique_ptr<Buffer> buffer(
-      new Buffer(size, vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostCoherent |
-                     vk::MemoryPropertyFlagBits::eHostVisible));
-  memcpy(buffer->map, data, size);
-
+                   MemoryUsage memoryUsage, bool deferMipmaps) {
+  width_ = w;
+  height_ = h;
   createImage(w, h, mipLevels, numSamples, format, tiling, usage);
-  allocMemory(properties);
-  Context::GetInstance().device.bindImageMemory(image, memory, 0);
+  allocMemory(memoryUsage, tiling);
 
-  transitionImageLayoutFromUndefine2Dst();
-  transformData2Image(*buffer, w, h);
+  // 上传时在传输队列上从undefined转换为dst
+  transformData2Image(data, w, h);
   // transitionImageLayoutFromDst2Optimal();
 
-  generateMipmaps(w, h);
+  if (!deferMipmaps) {
+    generateMipmaps(w, h);
+  }
 
   createImageView(format, vk::ImageAspectFlagBits::eColor, mipLevels_);
 
@@ -254,32 +254,21 @@ void Texture::transitionImageLayoutFromDst2Optimal() {
                         vk::ImageLayout::eShaderReadOnlyOptimal, 1);
 }
 
-void Texture::transformData2Image(Buffer& buffer, uint32_t w, uint32_t h) {
+void Texture::transformData2Image(const void* data, uint32_t w, uint32_t h) {
+  Context::GetInstance().stagingRing->UploadImage(
+      image, w, h, mipLevels_,
+      [&](void* dst) { memcpy(dst, data, size_t(w) * h * 4); });
+}
+
+void Texture::generateMipmaps(int32_t texWidth, int32_t texHeight) {
   Context::GetInstance().commandManager->ExecuteCmd(
-      Context::GetInstance().graphicsQueue, [&](vk::CommandBuffer cmdBuff) {
-        vk::BufferImageCopy region;
-        vk::ImageSubresourceLayers subSource;
-        subSource.setAspectMask(vk::ImageAspectFlagBits::eColor)
-            .setBaseArrayLayer(0)
-            .setMipLevel(0)
-            .setLayerCount(1);
-        region
-            // padding:方便存储，内存对齐
-            // 0：告诉vulkan图像就是紧凑存储
-            .setBufferImageHeight(0)
-            // buffer中image的偏移量
-            .setBufferOffset(0)
-            .setImageOffset(0)
-            .setImageExtent({w, h, 1})
-            // 也是为了计算padding
-            .setBufferRowLength(0)
-            .setImageSubresource(subSource);
-        cmdBuff.copyBufferToImage(buffer.buffer, image,
-                                  vk::ImageLayout::eTransferDstOptimal, region);
+      Context::GetInstance().graphicsQueue, [&](vk::CommandBuffer& cmdBuff) {
+        recordMipmaps(cmdBuff, texWidth, texHeight);
       });
 }
 
-void Texture::generateMipmaps(int32_t texWidth, int32_t texHeight) {
+void Texture::recordMipmaps(vk::CommandBuffer& cmdBuff, int32_t texWidth,
+                            int32_t texHeight) {
   vk::FormatProperties formatProperties =
       Context::GetInstance().phyDevice.getFormatProperties(
           vk::Format::eR8G8B8A8Srgb);
@@ -289,94 +278,91 @@ void Texture::generateMipmaps(int32_t texWidth, int32_t texHeight) {
         "texture image format does not support linear blitting!");
   }
 
-  Context::GetInstance().commandManager->ExecuteCmd(
-      Context::GetInstance().graphicsQueue, [&](vk::CommandBuffer cmdBuff) {
-        // 用于gpu同步，等待layout的转化
-        vk::ImageMemoryBarrier barrier;
-        vk::ImageSubresourceRange range;
-        range.setLayerCount(1)
-            .setBaseArrayLayer(0)
-            .setLevelCount(1)
-            .setBaseMipLevel(0)
-            .setAspectMask(vk::ImageAspectFlagBits::eColor);
-        barrier
-            .setImage(image)
-            // 没有queueFamily的依赖关系
-            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
-
-        int32_t mipWidth = texWidth;
-        int32_t mipHeight = texHeight;
-
-        for (uint32_t i = 1; i < mipLevels_; i++) {
-          range.setBaseMipLevel(i - 1);
-          barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-              .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
-              .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
-              .setDstAccessMask(vk::AccessFlagBits::eTransferRead)
-              .setSubresourceRange(range);
-
-          cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                  vk::PipelineStageFlagBits::eTransfer, {},
-                                  // 使用裸内存，不绑定在buffer或image上
-                                  {},
-                                  // 需要对buffer进行等待
-                                  nullptr,
-                                  // 需要对image等待
-                                  barrier);
-
-          vk::ImageBlit bilt{};
-          vk::ImageSubresourceLayers srcLayer{};
-          vk::ImageSubresourceLayers dstLayer{};
-          srcLayer.setAspectMask(vk::ImageAspectFlagBits::eColor)
-              .setMipLevel(i - 1)
-              .setBaseArrayLayer(0)
-              .setLayerCount(1);
-          dstLayer.setAspectMask(vk::ImageAspectFlagBits::eColor)
-              .setMipLevel(i)
-              .setBaseArrayLayer(0)
-              .setLayerCount(1);
-          bilt.setSrcOffsets(
-                  {vk::Offset3D{0, 0, 0}, vk::Offset3D{mipWidth, mipHeight, 1}})
-              .setSrcSubresource(srcLayer)
-              .setDstOffsets(
-                  {vk::Offset3D{0, 0, 0},
-                   vk::Offset3D{mipWidth > 1 ? mipWidth / 2 : 1,
-                                mipHeight > 1 ? mipHeight / 2 : 1, 1}})
-              .setDstSubresource(dstLayer);
-
-          cmdBuff.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image,
-                            vk::ImageLayout::eTransferDstOptimal, bilt,
-                            vk::Filter::eLinear);
-
-          barrier.setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
-              .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-              .setSrcAccessMask(vk::AccessFlagBits::eTransferRead)
-              .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-          cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                  vk::PipelineStageFlagBits::eFragmentShader,
-                                  {}, {}, nullptr, barrier);
-
-          if (mipWidth > 1) mipWidth /= 2;
-          if (mipHeight > 1) mipHeight /= 2;
-        }
-        range.setBaseMipLevel(mipLevels_ - 1);
-        barrier.setSubresourceRange(range)
-            .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-            .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-            .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
-            .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-        cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                vk::PipelineStageFlagBits::eFragmentShader, {},
-                                // 使用裸内存，不绑定在buffer或image上
-                                {},
-                                // 需要对buffer进行等待
-                                nullptr,
-                                // 需要对image等待
-                                barrier);
-      });
+  // 用于gpu同步，等待layout的转化
+  vk::ImageMemoryBarrier barrier;
+  vk::ImageSubresourceRange range;
+  range.setLayerCount(1)
+      .setBaseArrayLayer(0)
+      .setLevelCount(1)
+      .setBaseMipLevel(0)
+      .setAspectMask(vk::ImageAspectFlagBits::eColor);
+  barrier
+      .setImage(image)
+      // 没有queueFamily的依赖关系
+      .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+      .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+
+  int32_t mipWidth = texWidth;
+  int32_t mipHeight = texHeight;
+
+  for (uint32_t i = 1; i < mipLevels_; i++) {
+    range.setBaseMipLevel(i - 1);
+    barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+        .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferRead)
+        .setSubresourceRange(range);
+
+    cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eTransfer, {},
+                            // 使用裸内存，不绑定在buffer或image上
+                            {},
+                            // 需要对buffer进行等待
+                            nullptr,
+                            // 需要对image等待
+                            barrier);
+
+    vk::ImageBlit bilt{};
+    vk::ImageSubresourceLayers srcLayer{};
+    vk::ImageSubresourceLayers dstLayer{};
+    srcLayer.setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setMipLevel(i - 1)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1);
+    dstLayer.setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setMipLevel(i)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1);
+    bilt.setSrcOffsets(
+            {vk::Offset3D{0, 0, 0}, vk::Offset3D{mipWidth, mipHeight, 1}})
+        .setSrcSubresource(srcLayer)
+        .setDstOffsets(
+            {vk::Offset3D{0, 0, 0},
+             vk::Offset3D{mipWidth > 1 ? mipWidth / 2 : 1,
+                          mipHeight > 1 ? mipHeight / 2 : 1, 1}})
+        .setDstSubresource(dstLayer);
+
+    cmdBuff.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image,
+                      vk::ImageLayout::eTransferDstOptimal, bilt,
+                      vk::Filter::eLinear);
+
+    barrier.setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+        .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferRead)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eFragmentShader,
+                            {}, {}, nullptr, barrier);
+
+    if (mipWidth > 1) mipWidth /= 2;
+    if (mipHeight > 1) mipHeight /= 2;
+  }
+  range.setBaseMipLevel(mipLevels_ - 1);
+  barrier.setSubresourceRange(range)
+      .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+      .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+      .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+      .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+  cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                          vk::PipelineStageFlagBits::eFragmentShader, {},
+                          // 使用裸内存，不绑定在buffer或image上
+                          {},
+                          // 需要对buffer进行等待
+                          nullptr,
+                          // 需要对image等待
+                          barrier);
 }
 
 void Texture::createSampler() {
@@ -407,19 +393,70 @@ void Texture::createSampler() {
 // TextureManager
 std::unique_ptr<TextureManager> TextureManager::instance_ = nullptr;
 
-Texture* TextureManager::Load(const std::string& filename) {
-  datas_.push_back(std::unique_ptr<Texture>(new Texture{filename}));
+Texture* TextureManager::add(std::unique_ptr<Texture> texture) {
+  datas_.push_back(std::move(texture));
+  if (batchDepth_ > 0) {
+    batch_.push_back(datas_.back().get());
+  }
   return datas_.back().get();
 }
 
+Texture* TextureManager::Load(const std::string& filename) {
+  return add(std::unique_ptr<Texture>(new Texture{filename, batchDepth_ > 0}));
+}
+
+Texture* TextureManager::LoadFromMemory(const void* data, size_t size) {
+  return add(
+      std::unique_ptr<Texture>(new Texture{data, size, batchDepth_ > 0}));
+}
+
+void TextureManager::BeginBatch() {
+  batchDepth_++;
+  Context::GetInstance().stagingRing->BeginBatch();
+}
+
+void TextureManager::EndBatch() {
+  auto& ctx = Context::GetInstance();
+  ctx.stagingRing->EndBatch();
+  if (--batchDepth_ > 0 || batch_.empty()) {
+    return;
+  }
+  // 获取所有权并生成所有贴图的mipmap，只提交一次
+  ctx.commandManager->ExecuteCmd(
+      ctx.graphicsQueue, [&](vk::CommandBuffer& cmdBuff) {
+        for (auto texture : batch_) {
+          texture->recordMipmaps(cmdBuff, texture->width_, texture->height_);
+        }
+      });
+  batch_.clear();
+}
+
+std::vector<Texture*> TextureManager::LoadBatch(
+    const std::vector<std::string>& filenames) {
+  std::vector<Texture*> textures;
+  textures.reserve(filenames.size());
+  BeginBatch();
+  try {
+    for (const auto& filename : filenames) {
+      textures.push_back(Load(filename));
+    }
+  } catch (...) {
+    // 已经加载的贴图也要生成mipmap
+    EndBatch();
+    throw;
+  }
+  EndBatch();
+  return textures;
+}
+
 Texture* TextureManager::Create(void* data, uint32_t w, uint32_t h,
                                 uint32_t mipLevels,
                                 vk::SampleCountFlagBits numSamples,
                                 vk::Format format, vk::ImageTiling tiling,
                                 vk::ImageUsageFlags usage,
-                                vk::MemoryPropertyFlags properties) {
+                                MemoryUsage memoryUsage) {
   datas_.push_back(std::unique_ptr<Texture>(new Texture(
-      data, w, h, mipLevels, numSamples, format, tiling, usage, properties)));
+      data, w, h, mipLevels, numSamples, format, tiling, usage, memoryUsage)));
   return datas_.back().get();
 }
 
@@ -430,7 +467,13 @@ void TextureManager::Destroy(Texture* texture) {
       datas_.begin(), datas_.end(),
       [&](const std::unique_ptr<Texture>& t) { return t.get() == texture; });
   if (it != datas_.end()) {
-    Context::GetInstance().device.waitIdle();
+    // 正在执行的帧可能还在采样这张贴图
+    auto& deletionQueue = Context::GetInstance().deletionQueue;
+    if (deletionQueue) {
+      deletionQueue->Push(std::move(*it));
+    } else {
+      Context::GetInstance().device.waitIdle();
+    }
     datas_.erase(it);
     return;
   }
@@ -8,7 +8,7 @@ namespace sktr {
 class ImageResource {
  public:
   vk::Image image;
-  vk::DeviceMemory memory;
+  MemoryAllocation allocation;
   vk::ImageView view;
   ~ImageResource();
 
@@ -18,14 +18,14 @@ class ImageResource {
                                            vk::Format format,
                                            vk::ImageTiling tiling,
                                            vk::ImageUsageFlags usage,
-                                           vk::MemoryPropertyFlags properties);
+                                           MemoryUsage memoryUsage);
   static ImageResource CreateDepthResource(uint32_t w, uint32_t h,
                                            uint32_t mipLevels,
                                            vk::SampleCountFlagBits numSamples,
                                            vk::Format format,
                                            vk::ImageTiling tiling,
                                            vk::ImageUsageFlags usage,
-                                           vk::MemoryPropertyFlags properties);
+                                           MemoryUsage memoryUsage);
 
  protected:
   void createImage(uint32_t w, uint32_t h, uint32_t mipLevels,
@@ -33,7 +33,8 @@ class ImageResource {
                    vk::ImageTiling tiling, vk::ImageUsageFlags usage);
   void createImageView(vk::Format format, vk::ImageAspectFlags aspectFlags,
                        uint32_t mipLevels);
-  void allocMemory(vk::MemoryPropertyFlags properties);
+  // 从MemoryAllocator分配并绑定
+  void allocMemory(MemoryUsage memoryUsage, vk::ImageTiling tiling);
   void transitionImageLayout(vk::Format format, vk::ImageLayout oldLayout,
                              vk::ImageLayout newLayout, uint32_t mipLevels);
   bool hasStencilComponent(vk::Format format) {
@@ -54,26 +55,37 @@ class Texture final : public ImageResource {
 
  private:
   uint32_t mipLevels_;
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
   vk::Sampler sampler;
 
-  Texture(std::string_view filename);
+  // deferMipmaps为true时不生成mipmap，由TextureManager::EndBatch统一录制
+  Texture(std::string_view filename, bool deferMipmaps = false);
+  // 内存中的png/jpg等编码后的图片
+  Texture(const void* data, size_t size, bool deferMipmaps = false);
   Texture(void* data, uint32_t w, uint32_t h, uint32_t mipLevels,
           vk::SampleCountFlagBits numSamples, vk::Format format,
           vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-          vk::MemoryPropertyFlags properties);
+          MemoryUsage memoryUsage);
 
   // 从undefined转化为dst，防止①无法操作；②性能损失
   void transitionImageLayoutFromUndefine2Dst();
-  // CPU传到GPU
-  void transformData2Image(Buffer&, uint32_t w, uint32_t h);
+  // CPU传到GPU，异步提交到传输队列，之后ExecuteCmd的命令获取所有权后使用
+  void transformData2Image(const void* data, uint32_t w, uint32_t h);
   // 接收数据的布局->shader只读的布局
   void transitionImageLayoutFromDst2Optimal();
   void updateDescriptorSet();
+  // 转成RGBA8888并生成mipmap，会释放surface
+  void initFromSurface(SDL_Surface* surface, const char* name,
+                       bool deferMipmaps);
   void init(void* data, uint32_t w, uint32_t h, uint32_t mipLevels,
             vk::SampleCountFlagBits numSamples, vk::Format format,
             vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-            vk::MemoryPropertyFlags properties);
+            MemoryUsage memoryUsage, bool deferMipmaps = false);
   void generateMipmaps(int32_t texWidth, int32_t texHeight);
+  // 第0级在eTransferDstOptimal，录制后所有级别都是shader只读
+  void recordMipmaps(vk::CommandBuffer& cmdBuff, int32_t texWidth,
+                     int32_t texHeight);
   void createSampler();
 };
 
@@ -87,12 +99,25 @@ class TextureManager final {
   }
 
   Texture* Load(const std::string& filename);
+  // 从内存解码图片，如glTF中嵌入的贴图，data只在调用期间使用
+  Texture* LoadFromMemory(const void* data, size_t size);
+
+  /**
+   * @brief  开始批量加载
+   * @note   到EndBatch之前Load和LoadFromMemory的上传录制到同一个批次，
+   *         EndBatch时在一次提交中生成所有贴图的mipmap。
+   *         贴图在EndBatch之后才能使用，可以嵌套
+   */
+  void BeginBatch();
+  void EndBatch();
+  // BeginBatch、逐个Load、EndBatch
+  std::vector<Texture*> LoadBatch(const std::vector<std::string>& filenames);
 
   // * data must be a RGBA8888 format data
   Texture* Create(void* data, uint32_t w, uint32_t h, uint32_t mipLevels,
                   vk::SampleCountFlagBits numSamples, vk::Format format,
                   vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-                  vk::MemoryPropertyFlags properties);
+                  MemoryUsage memoryUsage);
   void Destroy(Texture*);
   void Clear();
   void updateDescriptorSet();
@@ -101,5 +126,10 @@ class TextureManager final {
   static std::unique_ptr<TextureManager> instance_;
 
   std::vector<std::unique_ptr<Texture>> datas_;
+  uint32_t batchDepth_ = 0;
+  // 等待EndBatch生成mipmap的贴图
+  std::vector<Texture*> batch_;
+
+  Texture* add(std::unique_ptr<Texture> texture);
 };
 }  // namespace sktr
\ No newline at end of file
@@ -0,0 +1,752 @@
+#include "gltf_loader.hpp"
+
+#include "sktr/utils/json.hpp"
+
+namespace sktr {
+
+namespace {
+
+constexpr uint32_t GlbMagic = 0x46546C67;      // "glTF"
+constexpr uint32_t GlbChunkJson = 0x4E4F534A;  // "JSON"
+constexpr uint32_t GlbChunkBin = 0x004E4942;   // "BIN\0"
+
+constexpr uint32_t ComponentByte = 5120;
+constexpr uint32_t ComponentUnsignedByte = 5121;
+constexpr uint32_t ComponentShort = 5122;
+constexpr uint32_t ComponentUnsignedShort = 5123;
+constexpr uint32_t ComponentUnsignedInt = 5125;
+constexpr uint32_t ComponentFloat = 5126;
+
+constexpr int64_t ModeTriangles = 4;
+// 防止节点成环时无限递归
+constexpr int MaxNodeDepth = 64;
+
+[[noreturn]] void fail(const std::string& path, const std::string& message) {
+  throw std::runtime_error("load gltf " + path + " failed: " + message);
+}
+
+uint32_t componentSize(uint32_t componentType) {
+  switch (componentType) {
+    case ComponentByte:
+    case ComponentUnsignedByte:
+      return 1;
+    case ComponentShort:
+    case ComponentUnsignedShort:
+      return 2;
+    case ComponentUnsignedInt:
+    case ComponentFloat:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+uint32_t componentCount(const std::string& type) {
+  if (type == "SCALAR") return 1;
+  if (type == "VEC2") return 2;
+  if (type == "VEC3") return 3;
+  if (type == "VEC4") return 4;
+  if (type == "MAT2") return 4;
+  if (type == "MAT3") return 9;
+  if (type == "MAT4") return 16;
+  return 0;
+}
+
+uint32_t readUint32(const uint8_t* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t readIndex(const GltfAccessor& accessor, uint32_t i) {
+  const uint8_t* p = accessor.data + size_t(accessor.stride) * i;
+  if (accessor.componentType == ComponentUnsignedInt) {
+    return readUint32(p);
+  }
+  if (accessor.componentType == ComponentUnsignedShort) {
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  return *p;
+}
+
+std::vector<uint8_t> decodeBase64(std::string_view text) {
+  auto decodeChar = [](char c) -> int {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+' || c == '-') return 62;
+    if (c == '/' || c == '_') return 63;
+    return -1;
+  };
+  std::vector<uint8_t> result;
+  result.reserve(text.size() / 4 * 3);
+  uint32_t bits = 0;
+  int bitCount = 0;
+  for (char c : text) {
+    int value = decodeChar(c);
+    if (value < 0) {
+      // '='以及换行之类的字符
+      continue;
+    }
+    bits = (bits << 6) | static_cast<uint32_t>(value);
+    bitCount += 6;
+    if (bitCount >= 8) {
+      bitCount -= 8;
+      result.push_back(static_cast<uint8_t>(bits >> bitCount));
+    }
+  }
+  return result;
+}
+
+struct BufferSpan {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+bool isIdentity(const glm::mat4& m) {
+  for (int c = 0; c < 4; c++) {
+    for (int r = 0; r < 4; r++) {
+      if (m[c][r] != (c == r ? 1.0f : 0.0f)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// 列主序，和glm一致
+glm::mat4 nodeLocalMatrix(const Json& node) {
+  glm::mat4 m(1.0f);
+  const Json& matrix = node["matrix"];
+  if (matrix.Size() == 16) {
+    for (int i = 0; i < 16; i++) {
+      m[i / 4][i % 4] = static_cast<float>(matrix[i].AsNumber());
+    }
+    return m;
+  }
+  const Json& t = node["translation"];
+  const Json& r = node["rotation"];
+  const Json& s = node["scale"];
+  float x = static_cast<float>(r[0].AsNumber(0.0));
+  float y = static_cast<float>(r[1].AsNumber(0.0));
+  float z = static_cast<float>(r[2].AsNumber(0.0));
+  float w = static_cast<float>(r[3].AsNumber(1.0));
+  glm::vec3 scale(static_cast<float>(s[0].AsNumber(1.0)),
+                  static_cast<float>(s[1].AsNumber(1.0)),
+                  static_cast<float>(s[2].AsNumber(1.0)));
+  // T * R * S
+  m[0] = glm::vec4(1 - 2 * (y * y + z * z), 2 * (x * y + z * w),
+                   2 * (x * z - y * w), 0.0f) *
+         scale.x;
+  m[1] = glm::vec4(2 * (x * y - z * w), 1 - 2 * (x * x + z * z),
+                   2 * (y * z + x * w), 0.0f) *
+         scale.y;
+  m[2] = glm::vec4(2 * (x * z + y * w), 2 * (y * z - x * w),
+                   1 - 2 * (x * x + y * y), 0.0f) *
+         scale.z;
+  m[3] = glm::vec4(static_cast<float>(t[0].AsNumber()),
+                   static_cast<float>(t[1].AsNumber()),
+                   static_cast<float>(t[2].AsNumber()), 1.0f);
+  return m;
+}
+
+float det3(const glm::mat4& m) {
+  return glm::dot(glm::vec3(m[0]),
+                  glm::cross(glm::vec3(m[1]), glm::vec3(m[2])));
+}
+
+// 左乘一个每轴相同缩放的仿射变换: p' = (p - origin) * scale + offset
+glm::mat4 scaleTranslate(const glm::mat4& m, const glm::vec3& origin,
+                         float scale, const glm::vec3& offset) {
+  glm::mat4 result = m;
+  for (int c = 0; c < 4; c++) {
+    glm::vec3 column(m[c]);
+    column = c < 3 ? column * scale
+                   : (column - origin * m[c].w) * scale + offset * m[c].w;
+    result[c] = glm::vec4(column, m[c].w);
+  }
+  return result;
+}
+
+class GltfParser final {
+ public:
+  GltfParser(const std::string& path, GltfAsset& asset)
+      : path_(path), asset_(asset) {
+    auto slash = path.find_last_of("/\\");
+    directory_ = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+  }
+
+  void Parse() {
+    asset_.file = MappedFile(path_);
+    if (!asset_.file) {
+      fail(path_, "can't open file");
+    }
+    std::string_view jsonText;
+    BufferSpan binChunk;
+    const uint8_t* data = asset_.file.Data();
+    const size_t size = asset_.file.Size();
+    if (size >= 12 && readUint32(data) == GlbMagic) {
+      // header(12字节) | JSON chunk | BIN chunk(可选)，chunk都是4字节对齐
+      size_t offset = 12;
+      const size_t length = std::min<size_t>(readUint32(data + 8), size);
+      while (offset + 8 <= length) {
+        uint32_t chunkLength = readUint32(data + offset);
+        uint32_t chunkType = readUint32(data + offset + 4);
+        offset += 8;
+        if (chunkLength > length - offset) {
+          fail(path_, "truncated glb chunk");
+        }
+        if (chunkType == GlbChunkJson && jsonText.empty()) {
+          jsonText = std::string_view(
+              reinterpret_cast<const char*>(data + offset), chunkLength);
+        } else if (chunkType == GlbChunkBin && !binChunk.data) {
+          binChunk = {data + offset, chunkLength};
+        }
+        offset += (chunkLength + 3) & ~3u;
+      }
+      if (jsonText.empty()) {
+        fail(path_, "missing json chunk");
+      }
+    } else {
+      jsonText = std::string_view(reinterpret_cast<const char*>(data), size);
+    }
+
+    doc_ = Json::Parse(jsonText);
+    if (!doc_.IsObject()) {
+      fail(path_, "root is not an object");
+    }
+    parseBuffers(binChunk);
+    parseImages();
+    parseMaterials();
+    parseScene();
+
+    // 同一材质的primitive相邻，绘制时少切换材质
+    std::stable_sort(asset_.primitives.begin(), asset_.primitives.end(),
+                     [](const GltfPrimitive& a, const GltfPrimitive& b) {
+                       return a.materialId < b.materialId;
+                     });
+    for (auto& primitive : asset_.primitives) {
+      primitive.firstVertex = asset_.vertexCount;
+      primitive.firstIndex = asset_.indexCount;
+      asset_.vertexCount += primitive.VertexCount();
+      asset_.indexCount += primitive.indexCount;
+    }
+  }
+
+  void Normalize() {
+    const Bounds& bounds = asset_.bounds;
+    if (!bounds.Valid()) {
+      return;
+    }
+    auto extent = bounds.max - bounds.min;
+    auto scaleFactor = 2.0f / std::max(extent.x, std::max(extent.y, extent.z));
+    // 和obj一致: x、y映射到[-1, 1]，z从0开始
+    const glm::vec3 offset(-1.0f, -1.0f, 0.0f);
+    for (auto& primitive : asset_.primitives) {
+      primitive.transform = scaleTranslate(primitive.transform, bounds.min,
+                                           scaleFactor, offset);
+      primitive.identity = false;
+    }
+    asset_.bounds.min = offset;
+    asset_.bounds.max = extent * scaleFactor + offset;
+  }
+
+ private:
+  const std::string& path_;
+  std::string directory_;
+  GltfAsset& asset_;
+  Json doc_;
+  std::vector<BufferSpan> buffers_;
+
+  void parseBuffers(const BufferSpan& binChunk) {
+    const Json& buffers = doc_["buffers"];
+    for (size_t i = 0; i < buffers.Size(); i++) {
+      const Json& buffer = buffers[i];
+      const auto& uri = buffer["uri"].AsString();
+      const auto byteLength = static_cast<size_t>(buffer["byteLength"].AsInt());
+      BufferSpan span;
+      if (uri.empty()) {
+        if (i != 0 || !binChunk.data) {
+          fail(path_, "buffer " + std::to_string(i) + " has no data");
+        }
+        span = binChunk;
+      } else if (uri.compare(0, 5, "data:") == 0) {
+        auto comma = uri.find(',');
+        if (comma == std::string::npos) {
+          fail(path_, "invalid data uri");
+        }
+        asset_.decodedBuffers.push_back(
+            decodeBase64(std::string_view(uri).substr(comma + 1)));
+        span = {asset_.decodedBuffers.back().data(),
+                asset_.decodedBuffers.back().size()};
+      } else {
+        MappedFile file(directory_ + uri);
+        if (!file) {
+          fail(path_, "can't open buffer " + uri);
+        }
+        span = {file.Data(), file.Size()};
+        asset_.externalBuffers.push_back(std::move(file));
+      }
+      if (span.size < byteLength) {
+        fail(path_, "buffer " + std::to_string(i) + " is truncated");
+      }
+      buffers_.push_back(span);
+    }
+  }
+
+  BufferSpan bufferView(int64_t index) {
+    const Json& view = doc_["bufferViews"][static_cast<size_t>(index)];
+    if (!view.IsObject()) {
+      fail(path_, "invalid bufferView " + std::to_string(index));
+    }
+    auto bufferIndex = static_cast<size_t>(view["buffer"].AsInt(-1));
+    auto offset = static_cast<size_t>(view["byteOffset"].AsInt());
+    auto length = static_cast<size_t>(view["byteLength"].AsInt());
+    if (bufferIndex >= buffers_.size() ||
+        offset > buffers_[bufferIndex].size ||
+        length > buffers_[bufferIndex].size - offset) {
+      fail(path_, "bufferView " + std::to_string(index) + " out of range");
+    }
+    return {buffers_[bufferIndex].data + offset, length};
+  }
+
+  GltfAccessor accessor(int64_t index) {
+    const Json& json = doc_["accessors"][static_cast<size_t>(index)];
+    if (!json.IsObject()) {
+      fail(path_, "invalid accessor " + std::to_string(index));
+    }
+    if (json.Has("sparse")) {
+      fail(path_, "sparse accessors are not supported");
+    }
+    if (!json.Has("bufferView")) {
+      fail(path_, "accessors without bufferView are not supported");
+    }
+    GltfAccessor result;
+    result.count = static_cast<uint32_t>(json["count"].AsInt());
+    result.componentType = static_cast<uint32_t>(json["componentType"].AsInt());
+    result.componentCount = componentCount(json["type"].AsString());
+    result.normalized = json["normalized"].AsBool();
+    const uint32_t elementSize =
+        componentSize(result.componentType) * result.componentCount;
+    if (elementSize == 0) {
+      fail(path_, "invalid accessor type " + std::to_string(index));
+    }
+
+    auto viewIndex = json["bufferView"].AsInt(-1);
+    BufferSpan view = bufferView(viewIndex);
+    const auto stride = static_cast<uint32_t>(
+        doc_["bufferViews"][static_cast<size_t>(viewIndex)]["byteStride"]
+            .AsInt());
+    result.stride = stride != 0 ? stride : elementSize;
+    auto offset = static_cast<size_t>(json["byteOffset"].AsInt());
+    // 最后一个元素也要完整地落在bufferView里
+    if (result.count > 0 &&
+        (offset > view.size || size_t(result.stride) * (result.count - 1) +
+                                       elementSize >
+                                   view.size - offset)) {
+      fail(path_, "accessor " + std::to_string(index) + " out of range");
+    }
+    result.data = view.data + offset;
+    return result;
+  }
+
+  void parseImages() {
+    const Json& images = doc_["images"];
+    for (size_t i = 0; i < images.Size(); i++) {
+      const Json& image = images[i];
+      GltfImage result;
+      const auto& uri = image["uri"].AsString();
+      if (image.Has("bufferView")) {
+        BufferSpan view = bufferView(image["bufferView"].AsInt(-1));
+        result.data = view.data;
+        result.size = view.size;
+      } else if (uri.compare(0, 5, "data:") == 0) {
+        auto comma = uri.find(',');
+        if (comma == std::string::npos) {
+          fail(path_, "invalid data uri");
+        }
+        asset_.decodedBuffers.push_back(
+            decodeBase64(std::string_view(uri).substr(comma + 1)));
+        result.data = asset_.decodedBuffers.back().data();
+        result.size = asset_.decodedBuffers.back().size();
+      } else if (!uri.empty()) {
+        result.path = directory_ + uri;
+      }
+      asset_.images.push_back(std::move(result));
+    }
+  }
+
+  void parseMaterials() {
+    const Json& materials = doc_["materials"];
+    for (size_t i = 0; i < materials.Size(); i++) {
+      const Json& pbr = materials[i]["pbrMetallicRoughness"];
+      MaterialInfo info;
+      const Json& factor = pbr["baseColorFactor"];
+      if (factor.Size() >= 3) {
+        info.diffuse = {static_cast<float>(factor[0].AsNumber()),
+                        static_cast<float>(factor[1].AsNumber()),
+                        static_cast<float>(factor[2].AsNumber())};
+      }
+      asset_.materialInfos.push_back(info);
+
+      int32_t image = -1;
+      const Json& baseColor = pbr["baseColorTexture"];
+      if (baseColor.IsObject()) {
+        const Json& texture =
+            doc_["textures"][static_cast<size_t>(baseColor["index"].AsInt(-1))];
+        auto source = texture["source"].AsInt(-1);
+        if (source >= 0 &&
+            source < static_cast<int64_t>(asset_.images.size())) {
+          image = static_cast<int32_t>(source);
+        }
+      }
+      asset_.materialImages.push_back(image);
+    }
+  }
+
+  void parseScene() {
+    const Json& nodes = doc_["nodes"];
+    const Json& scenes = doc_["scenes"];
+    const Json& scene = scenes[static_cast<size_t>(doc_["scene"].AsInt(0))];
+    if (scene.IsObject()) {
+      const Json& roots = scene["nodes"];
+      for (size_t i = 0; i < roots.Size(); i++) {
+        parseNode(static_cast<size_t>(roots[i].AsInt(-1)), glm::mat4(1.0f),
+                  0);
+      }
+      return;
+    }
+    // 没有场景时绘制所有根节点
+    std::vector<bool> isChild(nodes.Size(), false);
+    for (size_t i = 0; i < nodes.Size(); i++) {
+      const Json& children = nodes[i]["children"];
+      for (size_t j = 0; j < children.Size(); j++) {
+        auto child = static_cast<size_t>(children[j].AsInt(-1));
+        if (child < isChild.size()) {
+          isChild[child] = true;
+        }
+      }
+    }
+    for (size_t i = 0; i < nodes.Size(); i++) {
+      if (!isChild[i]) {
+        parseNode(i, glm::mat4(1.0f), 0);
+      }
+    }
+  }
+
+  void parseNode(size_t index, const glm::mat4& parent, int depth) {
+    const Json& node = doc_["nodes"][index];
+    if (!node.IsObject()) {
+      fail(path_, "invalid node " + std::to_string(index));
+    }
+    if (depth > MaxNodeDepth) {
+      fail(path_, "node hierarchy too deep");
+    }
+    glm::mat4 world = parent * nodeLocalMatrix(node);
+    if (node.Has("mesh")) {
+      parseMesh(node["mesh"].AsInt(-1), world);
+    }
+    const Json& children = node["children"];
+    for (size_t i = 0; i < children.Size(); i++) {
+      parseNode(static_cast<size_t>(children[i].AsInt(-1)), world, depth + 1);
+    }
+  }
+
+  void parseMesh(int64_t index, const glm::mat4& transform) {
+    const Json& mesh = doc_["meshes"][static_cast<size_t>(index)];
+    if (!mesh.IsObject()) {
+      fail(path_, "invalid mesh " + std::to_string(index));
+    }
+    const Json& primitives = mesh["primitives"];
+    for (size_t i = 0; i < primitives.Size(); i++) {
+      const Json& json = primitives[i];
+      if (json["mode"].AsInt(ModeTriangles) != ModeTriangles) {
+        std::cout << "gltf " << path_ << ": skip non-triangle primitive"
+                  << std::endl;
+        continue;
+      }
+      const Json& attributes = json["attributes"];
+      if (!attributes.Has("POSITION")) {
+        continue;
+      }
+      GltfPrimitive primitive;
+      primitive.position = accessor(attributes["POSITION"].AsInt(-1));
+      if (primitive.position.componentType != ComponentFloat ||
+          primitive.position.componentCount != 3) {
+        fail(path_, "POSITION must be float VEC3");
+      }
+      if (attributes.Has("NORMAL")) {
+        primitive.normal = accessor(attributes["NORMAL"].AsInt(-1));
+        if (primitive.normal.componentType != ComponentFloat ||
+            primitive.normal.componentCount != 3 ||
+            primitive.normal.count != primitive.position.count) {
+          fail(path_, "NORMAL must be float VEC3");
+        }
+      }
+      if (attributes.Has("TEXCOORD_0")) {
+        primitive.texCoord = accessor(attributes["TEXCOORD_0"].AsInt(-1));
+        auto type = primitive.texCoord.componentType;
+        bool validType = type == ComponentFloat ||
+                         (primitive.texCoord.normalized &&
+                          (type == ComponentUnsignedByte ||
+                           type == ComponentUnsignedShort));
+        if (!validType || primitive.texCoord.componentCount != 2 ||
+            primitive.texCoord.count != primitive.position.count) {
+          fail(path_, "invalid TEXCOORD_0");
+        }
+      }
+      if (json.Has("indices")) {
+        primitive.indices = accessor(json["indices"].AsInt(-1));
+        auto type = primitive.indices.componentType;
+        if (primitive.indices.componentCount != 1 ||
+            (type != ComponentUnsignedByte &&
+             type != ComponentUnsignedShort && type != ComponentUnsignedInt)) {
+          fail(path_, "invalid indices");
+        }
+      }
+      uint32_t indexCount = primitive.indices ? primitive.indices.count
+                                              : primitive.position.count;
+      primitive.indexCount = indexCount - indexCount % 3;
+      if (primitive.indexCount == 0) {
+        continue;
+      }
+      // 索引直接写入GPU和之后的优化、简化，越界的索引在这里拒绝
+      if (primitive.indices) {
+        for (uint32_t k = 0; k < primitive.indexCount; k++) {
+          if (readIndex(primitive.indices, k) >= primitive.VertexCount()) {
+            fail(path_, "index out of range in mesh " + std::to_string(index));
+          }
+        }
+      }
+
+      auto materialId = json["material"].AsInt(-1);
+      primitive.materialId =
+          materialId < static_cast<int64_t>(asset_.materialInfos.size())
+              ? static_cast<int32_t>(materialId)
+              : -1;
+      primitive.transform = transform;
+      primitive.identity = isIdentity(transform);
+      expandBounds(attributes["POSITION"].AsInt(-1), primitive);
+      asset_.primitives.push_back(primitive);
+    }
+  }
+
+  // POSITION的min/max是必须的，变换后取8个角，有旋转时偏保守
+  void expandBounds(int64_t accessorIndex, const GltfPrimitive& primitive) {
+    const Json& json = doc_["accessors"][static_cast<size_t>(accessorIndex)];
+    const Json& min = json["min"];
+    const Json& max = json["max"];
+    Bounds local;
+    if (min.Size() == 3 && max.Size() == 3) {
+      local.min = {static_cast<float>(min[0].AsNumber()),
+                   static_cast<float>(min[1].AsNumber()),
+                   static_cast<float>(min[2].AsNumber())};
+      local.max = {static_cast<float>(max[0].AsNumber()),
+                   static_cast<float>(max[1].AsNumber()),
+                   static_cast<float>(max[2].AsNumber())};
+    } else {
+      const auto& position = primitive.position;
+      for (uint32_t i = 0; i < position.count; i++) {
+        glm::vec3 p;
+        memcpy(&p, position.data + size_t(position.stride) * i, sizeof(p));
+        local.Expand(p);
+      }
+    }
+    if (!local.Valid()) {
+      return;
+    }
+    for (int corner = 0; corner < 8; corner++) {
+      glm::vec3 p((corner & 1) ? local.max.x : local.min.x,
+                  (corner & 2) ? local.max.y : local.min.y,
+                  (corner & 4) ? local.max.z : local.min.z);
+      asset_.bounds.Expand(
+          glm::vec3(primitive.transform * glm::vec4(p, 1.0f)));
+    }
+  }
+};
+
+glm::vec2 readTexCoord(const GltfAccessor& accessor, uint32_t i) {
+  const uint8_t* p = accessor.data + size_t(accessor.stride) * i;
+  glm::vec2 result;
+  if (accessor.componentType == ComponentFloat) {
+    memcpy(&result, p, sizeof(result));
+  } else if (accessor.componentType == ComponentUnsignedShort) {
+    uint16_t value[2];
+    memcpy(value, p, sizeof(value));
+    result = {value[0] / 65535.0f, value[1] / 65535.0f};
+  } else {
+    result = {p[0] / 255.0f, p[1] / 255.0f};
+  }
+  return result;
+}
+
+// 镜像变换会让三角形反向，写索引时交换后两个顶点
+bool flipsWinding(const GltfPrimitive& primitive) {
+  return !primitive.identity && det3(primitive.transform) < 0.0f;
+}
+
+// 没有法线时用面积加权的面法线平均
+std::vector<glm::vec3> generateNormals(const GltfPrimitive& primitive) {
+  std::vector<glm::vec3> normals(primitive.VertexCount(), glm::vec3(0.0f));
+  const auto& position = primitive.position;
+  auto readPosition = [&](uint32_t i) {
+    glm::vec3 p;
+    memcpy(&p, position.data + size_t(position.stride) * i, sizeof(p));
+    return p;
+  };
+  for (uint32_t i = 0; i < primitive.indexCount; i += 3) {
+    uint32_t v[3];
+    for (int k = 0; k < 3; k++) {
+      v[k] = primitive.indices ? readIndex(primitive.indices, i + k) : i + k;
+    }
+    glm::vec3 p0 = readPosition(v[0]);
+    glm::vec3 n = glm::cross(readPosition(v[1]) - p0, readPosition(v[2]) - p0);
+    for (int k = 0; k < 3; k++) {
+      normals[v[k]] += n;
+    }
+  }
+  return normals;
+}
+
+}  // namespace
+
+bool GltfAsset::FitsUint16Indices() const {
+  return std::all_of(primitives.begin(), primitives.end(),
+                     [](const GltfPrimitive& primitive) {
+                       return primitive.VertexCount() <= 65536;
+                     });
+}
+
+bool IsGltfPath(const std::string& path) {
+  auto dot = path.find_last_of('.');
+  if (dot == std::string::npos) {
+    return false;
+  }
+  auto extension = path.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return extension == "glb" || extension == "gltf";
+}
+
+GltfAsset LoadGltf(const std::string& path, const GltfLoadOptions& options) {
+  GltfAsset asset;
+  GltfParser parser(path, asset);
+  parser.Parse();
+  if (options.normalized) {
+    parser.Normalize();
+  }
+  return asset;
+}
+
+void WriteGltfVertices(const GltfAsset& asset, Vertex* dst) {
+  for (const auto& primitive : asset.primitives) {
+    const auto& position = primitive.position;
+    const auto& normal = primitive.normal;
+    std::vector<glm::vec3> generatedNormals;
+    if (!normal) {
+      generatedNormals = generateNormals(primitive);
+    }
+    // 法线用伴随矩阵的转置变换，最后会归一化所以不用除以行列式
+    const glm::mat4& m = primitive.transform;
+    const glm::vec3 c0(m[0]), c1(m[1]), c2(m[2]);
+    const float sign = det3(m) < 0.0f ? -1.0f : 1.0f;
+    const glm::vec3 n0 = glm::cross(c1, c2) * sign;
+    const glm::vec3 n1 = glm::cross(c2, c0) * sign;
+    const glm::vec3 n2 = glm::cross(c0, c1) * sign;
+
+    Vertex* out = dst + primitive.firstVertex;
+    for (uint32_t i = 0; i < position.count; i++) {
+      // 先在栈上拼好再整体写出，dst可能是write-combined的映射内存
+      Vertex vertex;
+      memcpy(&vertex.pos, position.data + size_t(position.stride) * i,
+             sizeof(glm::vec3));
+      if (normal) {
+        memcpy(&vertex.normal, normal.data + size_t(normal.stride) * i,
+               sizeof(glm::vec3));
+      } else {
+        vertex.normal = generatedNormals[i];
+      }
+      vertex.texCoord = primitive.texCoord ? readTexCoord(primitive.texCoord, i)
+                                           : glm::vec2(0.0f);
+      vertex.color = {1.0f, 1.0f, 1.0f};
+      if (!primitive.identity) {
+        vertex.pos = glm::vec3(m * glm::vec4(vertex.pos, 1.0f));
+        vertex.normal =
+            n0 * vertex.normal.x + n1 * vertex.normal.y + n2 * vertex.normal.z;
+      }
+      if (!normal || !primitive.identity) {
+        float length = glm::length(vertex.normal);
+        vertex.normal =
+            length > 0.0f ? vertex.normal / length : glm::vec3(0, 0, 1);
+      }
+      out[i] = vertex;
+    }
+  }
+}
+
+void WriteGltfIndices(const GltfAsset& asset, void* dst, bool uint16) {
+  const uint32_t indexSize = uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+  const uint32_t componentType =
+      uint16 ? ComponentUnsignedShort : ComponentUnsignedInt;
+  for (const auto& primitive : asset.primitives) {
+    uint8_t* out =
+        static_cast<uint8_t*>(dst) + size_t(primitive.firstIndex) * indexSize;
+    const auto& indices = primitive.indices;
+    const bool flip = flipsWinding(primitive);
+    if (indices && !flip && indices.componentType == componentType &&
+        indices.stride == indexSize) {
+      memcpy(out, indices.data, size_t(primitive.indexCount) * indexSize);
+      continue;
+    }
+    for (uint32_t i = 0; i < primitive.indexCount; i++) {
+      uint32_t source = i;
+      if (flip && i % 3 != 0) {
+        // 交换每个三角形的后两个顶点
+        source = i % 3 == 1 ? i + 1 : i - 1;
+      }
+      uint32_t index = indices ? readIndex(indices, source) : source;
+      if (uint16) {
+        reinterpret_cast<uint16_t*>(out)[i] = static_cast<uint16_t>(index);
+      } else {
+        reinterpret_cast<uint32_t*>(out)[i] = index;
+      }
+    }
+  }
+}
+
+std::vector<SubMesh> GltfSubMeshes(const GltfAsset& asset) {
+  std::vector<SubMesh> subMeshes;
+  subMeshes.reserve(asset.primitives.size());
+  for (const auto& primitive : asset.primitives) {
+    subMeshes.push_back({primitive.firstIndex, primitive.indexCount,
+                         primitive.materialId,
+                         static_cast<int32_t>(primitive.firstVertex)});
+  }
+  return subMeshes;
+}
+
+MeshData GltfToMeshData(const GltfAsset& asset) {
+  MeshData mesh;
+  mesh.vertices.resize(asset.vertexCount);
+  mesh.indices.resize(asset.indexCount);
+  WriteGltfVertices(asset, mesh.vertices.data());
+  WriteGltfIndices(asset, mesh.indices.data(), false);
+  for (const auto& primitive : asset.primitives) {
+    for (uint32_t i = 0; i < primitive.indexCount; i++) {
+      mesh.indices[primitive.firstIndex + i] += primitive.firstVertex;
+    }
+    // primitive已经按材质排好序，相同材质的合并成一个subMesh
+    if (mesh.subMeshes.empty() ||
+        mesh.subMeshes.back().materialId != primitive.materialId) {
+      mesh.subMeshes.push_back({primitive.firstIndex, 0, primitive.materialId});
+    }
+    mesh.subMeshes.back().indexCount += primitive.indexCount;
+  }
+  mesh.materialInfos = asset.materialInfos;
+  mesh.bounds = asset.bounds;
+  return mesh;
+}
+
+}  // namespace sktr
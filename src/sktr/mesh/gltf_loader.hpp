@@ -0,0 +1,118 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+#include "sktr/utils/mapped_file.hpp"
+
+namespace sktr {
+
+// 指向buffer中的一个accessor，data已经加上bufferView和accessor的偏移
+struct GltfAccessor {
+  const uint8_t* data = nullptr;
+  uint32_t count = 0;
+  // 相邻元素的字节间隔，交错存放时为bufferView的byteStride
+  uint32_t stride = 0;
+  // GL的类型枚举，如5126(float)、5123(unsigned short)
+  uint32_t componentType = 0;
+  uint32_t componentCount = 0;
+  bool normalized = false;
+
+  operator bool() const { return data != nullptr; }
+};
+
+// 一个三角形primitive，节点的变换已经展开到transform中
+struct GltfPrimitive {
+  GltfAccessor position;
+  // 可选
+  GltfAccessor normal;
+  // 可选，TEXCOORD_0
+  GltfAccessor texCoord;
+  // 可选，没有时按顶点顺序每三个组成一个三角形
+  GltfAccessor indices;
+  int32_t materialId = -1;
+  glm::mat4 transform = glm::mat4(1.0f);
+  bool identity = true;
+  // 在合并后的顶点、索引中的位置
+  uint32_t firstVertex = 0;
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+
+  uint32_t VertexCount() const { return position.count; }
+};
+
+// 嵌入的图片指向buffer，外部图片只记录路径
+struct GltfImage {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  std::string path;
+};
+
+/*
+ * 解析后的glTF 2.0场景，只包含渲染需要的部分
+ *
+ * 所有accessor都直接指向映射的文件或解码后的buffer，
+ * 在GltfAsset析构之前有效
+ */
+struct GltfAsset {
+  // 按材质稳定排序，相同材质的primitive相邻
+  std::vector<GltfPrimitive> primitives;
+  std::vector<MaterialInfo> materialInfos;
+  // 和materialInfos一一对应，baseColor贴图在images中的下标，-1表示没有
+  std::vector<int32_t> materialImages;
+  std::vector<GltfImage> images;
+  Bounds bounds;
+  uint32_t vertexCount = 0;
+  uint32_t indexCount = 0;
+
+  // 每个primitive的顶点数都不超过65536，可以用vertexOffset + 16位索引绘制
+  bool FitsUint16Indices() const;
+
+  // buffer的存储
+  MappedFile file;
+  std::vector<MappedFile> externalBuffers;
+  std::vector<std::vector<uint8_t>> decodedBuffers;
+};
+
+struct GltfLoadOptions {
+  // 把模型缩放到[-1, 1]，和ObjLoadOptions一致
+  bool normalized = false;
+};
+
+/**
+ * @brief  解析.glb或.gltf文件
+ * @note   不涉及任何GPU资源。只支持三角形primitive和float的位置、法线，
+ *         不支持稀疏accessor、蒙皮和动画，格式错误时抛出std::runtime_error
+ * @param  path: .glb或.gltf文件路径，外部buffer和图片相对于它所在的目录
+ * @param  options: 加载参数
+ * @retval 解析后的场景
+ */
+GltfAsset LoadGltf(const std::string& path, const GltfLoadOptions& options = {});
+
+// 按扩展名判断是否是glTF文件
+bool IsGltfPath(const std::string& path);
+
+/**
+ * @brief  把所有primitive的顶点按顺序写到dst
+ * @note   直接从accessor按stride读取，交错或分开存放都可以，
+ *         dst可以是staging buffer的映射
+ * @param  dst: 至少asset.vertexCount个顶点
+ */
+void WriteGltfVertices(const GltfAsset& asset, Vertex* dst);
+
+/**
+ * @brief  把所有primitive的索引按顺序写到dst
+ * @note   索引相对于各自primitive的firstVertex，绘制时作为vertexOffset。
+ *         accessor的类型和目标相同时直接memcpy
+ * @param  dst: 至少asset.indexCount个uint16或uint32
+ * @param  uint16: 写16位索引，需要FitsUint16Indices()
+ */
+void WriteGltfIndices(const GltfAsset& asset, void* dst, bool uint16);
+
+// 每个primitive一个subMesh，vertexOffset为primitive的firstVertex
+std::vector<SubMesh> GltfSubMeshes(const GltfAsset& asset);
+
+// 转换成和LoadObjMesh相同形式的MeshData(索引从0开始，每个材质一个subMesh)，
+// 用于后续的优化、LOD和meshlet处理
+MeshData GltfToMeshData(const GltfAsset& asset);
+
+}  // namespace sktr
@@ -0,0 +1,96 @@
+#include "index_chunks.hpp"
+
+namespace sktr {
+
+static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+bool FitsUint16Indices(const uint32_t* indices, size_t vertexCount,
+                       const std::vector<SubMesh>& subMeshes) {
+  if (vertexCount <= MaxVerticesPerIndexChunk) {
+    return true;
+  }
+  if (subMeshes.empty()) {
+    return false;
+  }
+  for (const auto& subMesh : subMeshes) {
+    for (uint32_t i = 0; i < subMesh.indexCount; i++) {
+      if (indices[subMesh.firstIndex + i] >= MaxVerticesPerIndexChunk) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void SplitIndexChunks(MeshData& mesh) {
+  if (mesh.vertices.size() <= MaxVerticesPerIndexChunk) {
+    return;
+  }
+
+  std::vector<Vertex> vertices;
+  vertices.reserve(mesh.vertices.size());
+  std::vector<SubMesh> subMeshes;
+  // 全局顶点 -> 当前块内的顶点，用touched在换块时只重置用过的部分
+  std::vector<uint32_t> remap(mesh.vertices.size(), InvalidIndex);
+  std::vector<uint32_t> touched;
+  touched.reserve(MaxVerticesPerIndexChunk);
+
+  // 原subMesh -> 拆分后的第一块，用来更新LOD的区间
+  std::vector<uint32_t> firstChunks;
+  firstChunks.reserve(mesh.subMeshes.size() + 1);
+
+  for (const auto& subMesh : mesh.subMeshes) {
+    firstChunks.push_back(static_cast<uint32_t>(subMeshes.size()));
+    SubMesh chunk;
+    chunk.firstIndex = subMesh.firstIndex;
+    chunk.materialId = subMesh.materialId;
+    chunk.vertexOffset = static_cast<int32_t>(vertices.size());
+
+    auto closeChunk = [&](uint32_t endIndex) {
+      chunk.indexCount = endIndex - chunk.firstIndex;
+      if (chunk.indexCount > 0) {
+        subMeshes.push_back(chunk);
+      }
+      for (uint32_t v : touched) {
+        remap[v] = InvalidIndex;
+      }
+      touched.clear();
+      chunk.firstIndex = endIndex;
+      chunk.vertexOffset = static_cast<int32_t>(vertices.size());
+    };
+
+    const uint32_t end = subMesh.firstIndex + subMesh.indexCount;
+    for (uint32_t i = subMesh.firstIndex; i < end; i += 3) {
+      uint32_t newVertices = 0;
+      for (uint32_t k = 0; k < 3; k++) {
+        newVertices += remap[mesh.indices[i + k]] == InvalidIndex;
+      }
+      if (touched.size() + newVertices > MaxVerticesPerIndexChunk) {
+        closeChunk(i);
+      }
+      for (uint32_t k = 0; k < 3; k++) {
+        uint32_t& index = mesh.indices[i + k];
+        if (remap[index] == InvalidIndex) {
+          remap[index] = static_cast<uint32_t>(touched.size());
+          touched.push_back(index);
+          vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+      }
+    }
+    closeChunk(end);
+  }
+  firstChunks.push_back(static_cast<uint32_t>(subMeshes.size()));
+
+  for (auto& lod : mesh.lods) {
+    const uint32_t first = firstChunks[lod.firstSubMesh];
+    lod.subMeshCount =
+        firstChunks[lod.firstSubMesh + lod.subMeshCount] - first;
+    lod.firstSubMesh = first;
+  }
+
+  mesh.vertices = std::move(vertices);
+  mesh.subMeshes = std::move(subMeshes);
+}
+
+}  // namespace sktr
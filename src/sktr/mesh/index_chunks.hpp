@@ -0,0 +1,20 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+// 16位索引能寻址的顶点数
+constexpr uint32_t MaxVerticesPerIndexChunk = 65536;
+
+// 所有subMesh的索引(相对vertexOffset)都不超过16位
+bool FitsUint16Indices(const uint32_t* indices, size_t vertexCount,
+                       const std::vector<SubMesh>& subMeshes);
+
+// 把subMesh按顺序切成最多引用MaxVerticesPerIndexChunk个顶点的块，
+// 每块的顶点连续存放(块之间共享的顶点会被复制)，索引改为相对于块的vertexOffset。
+// 三角形的顺序不变，mesh.lods的区间会同步更新
+void SplitIndexChunks(MeshData& mesh);
+
+}  // namespace sktr
@@ -0,0 +1,233 @@
+#include "mesh_cache.hpp"
+
+namespace sktr {
+
+static constexpr char CacheMagic[4] = {'S', 'K', 'T', 'M'};
+static constexpr uint64_t SectionAlignment = 16;
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+static constexpr uint64_t HashPrime = 0x100000001b3ull;
+
+// FNV-1a，按8字节一组处理，尾部逐字节
+static uint64_t hashBytes(const uint8_t* data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ull ^ size;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * HashPrime;
+    hash ^= hash >> 29;
+  }
+  for (; i < size; i++) {
+    hash = (hash ^ data[i]) * HashPrime;
+  }
+  return hash;
+}
+
+static uint64_t combineHash(uint64_t hash, uint64_t value) {
+  hash = (hash ^ value) * HashPrime;
+  return hash ^ (hash >> 29);
+}
+
+static uint64_t hashString(const std::string& value) {
+  return hashBytes(reinterpret_cast<const uint8_t*>(value.data()),
+                   value.size());
+}
+
+uint64_t MeshCache::HashFile(const std::string& filename) {
+  MappedFile file(filename);
+  if (!file) {
+    return 0;
+  }
+  return hashBytes(file.Data(), file.Size());
+}
+
+uint64_t MeshCache::HashSource(const std::string& objPath,
+                               const std::string& mtlDir) {
+  MappedFile file(objPath);
+  if (!file) {
+    return 0;
+  }
+  const char* data = reinterpret_cast<const char*>(file.Data());
+  uint64_t hash = hashBytes(file.Data(), file.Size());
+  hash = combineHash(hash, hashString(mtlDir));
+  if (mtlDir.empty()) {
+    return hash;
+  }
+  // 逐行查找mtllib，后面可以有多个文件名
+  auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+  const char* end = data + file.Size();
+  for (const char* line = data; line < end;) {
+    const char* lineEnd =
+        static_cast<const char*>(memchr(line, '\n', end - line));
+    lineEnd = lineEnd ? lineEnd : end;
+    const char* p = line;
+    while (p < lineEnd && isSpace(*p)) {
+      p++;
+    }
+    constexpr size_t keywordSize = sizeof("mtllib") - 1;
+    if (size_t(lineEnd - p) > keywordSize &&
+        memcmp(p, "mtllib", keywordSize) == 0 && isSpace(p[keywordSize])) {
+      p += keywordSize;
+      while (p < lineEnd) {
+        while (p < lineEnd && isSpace(*p)) {
+          p++;
+        }
+        const char* nameEnd = p;
+        while (nameEnd < lineEnd && !isSpace(*nameEnd)) {
+          nameEnd++;
+        }
+        if (nameEnd > p) {
+          const std::string name(p, nameEnd);
+          hash = combineHash(hash, hashString(name));
+          hash = combineHash(hash, HashFile(mtlDir + name));
+        }
+        p = nameEnd;
+      }
+    }
+    line = lineEnd + 1;
+  }
+  return hash;
+}
+
+std::optional<CachedMesh> MeshCache::Load(const std::string& cachePath,
+                                          uint64_t sourceHash,
+                                          uint64_t flags) {
+  MappedFile file(cachePath);
+  if (!file || file.Size() < sizeof(Header)) {
+    return std::nullopt;
+  }
+
+  Header header;
+  memcpy(&header, file.Data(), sizeof(Header));
+  if (memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0 ||
+      header.version != Version || header.sourceHash != sourceHash ||
+      header.flags != flags || header.vertexStride != sizeof(Vertex)) {
+    return std::nullopt;
+  }
+
+  auto sectionFits = [&](uint64_t offset, uint64_t bytes) {
+    return offset % alignof(Vertex) == 0 && offset <= file.Size() &&
+           bytes <= file.Size() - offset;
+  };
+  if (!sectionFits(header.vertexOffset,
+                   uint64_t(header.vertexCount) * sizeof(Vertex)) ||
+      !sectionFits(header.indexOffset,
+                   uint64_t(header.indexCount) * sizeof(uint32_t)) ||
+      !sectionFits(header.subMeshOffset,
+                   uint64_t(header.subMeshCount) * sizeof(SubMesh)) ||
+      !sectionFits(header.materialOffset,
+                   uint64_t(header.materialCount) * sizeof(MaterialInfo)) ||
+      !sectionFits(header.lodOffset,
+                   uint64_t(header.lodCount) * sizeof(MeshLod)) ||
+      !sectionFits(header.meshletOffset,
+                   uint64_t(header.meshletCount) * sizeof(Meshlet))) {
+    return std::nullopt;
+  }
+
+  CachedMesh mesh;
+  const uint8_t* base = file.Data();
+  mesh.vertices =
+      reinterpret_cast<const Vertex*>(base + header.vertexOffset);
+  mesh.vertexCount = header.vertexCount;
+  mesh.indices =
+      reinterpret_cast<const uint32_t*>(base + header.indexOffset);
+  mesh.indexCount = header.indexCount;
+
+  mesh.subMeshes.resize(header.subMeshCount);
+  memcpy(mesh.subMeshes.data(), base + header.subMeshOffset,
+         header.subMeshCount * sizeof(SubMesh));
+  mesh.materialInfos.resize(header.materialCount);
+  memcpy(mesh.materialInfos.data(), base + header.materialOffset,
+         header.materialCount * sizeof(MaterialInfo));
+  mesh.lods.resize(header.lodCount);
+  memcpy(mesh.lods.data(), base + header.lodOffset,
+         header.lodCount * sizeof(MeshLod));
+  mesh.meshlets.resize(header.meshletCount);
+  memcpy(mesh.meshlets.data(), base + header.meshletOffset,
+         header.meshletCount * sizeof(Meshlet));
+  mesh.bounds.min = {header.boundsMin[0], header.boundsMin[1],
+                     header.boundsMin[2]};
+  mesh.bounds.max = {header.boundsMax[0], header.boundsMax[1],
+                     header.boundsMax[2]};
+  mesh.file = std::move(file);
+  return mesh;
+}
+
+bool MeshCache::Write(const std::string& cachePath, const MeshData& mesh,
+                      uint64_t sourceHash, uint64_t flags) {
+  Header header{};
+  memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+  header.version = Version;
+  header.sourceHash = sourceHash;
+  header.flags = flags;
+  header.vertexStride = sizeof(Vertex);
+  header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+  header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+  header.subMeshCount = static_cast<uint32_t>(mesh.subMeshes.size());
+  header.materialCount = static_cast<uint32_t>(mesh.materialInfos.size());
+  header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+  header.meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+  for (int i = 0; i < 3; i++) {
+    header.boundsMin[i] = mesh.bounds.min[i];
+    header.boundsMax[i] = mesh.bounds.max[i];
+  }
+
+  struct Section {
+    const void* data;
+    uint64_t size;
+    uint64_t* offset;
+  };
+  std::array<Section, 6> sections = {
+      Section{mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex),
+              &header.vertexOffset},
+      Section{mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t),
+              &header.indexOffset},
+      Section{mesh.subMeshes.data(), mesh.subMeshes.size() * sizeof(SubMesh),
+              &header.subMeshOffset},
+      Section{mesh.materialInfos.data(),
+              mesh.materialInfos.size() * sizeof(MaterialInfo),
+              &header.materialOffset},
+      Section{mesh.lods.data(), mesh.lods.size() * sizeof(MeshLod),
+              &header.lodOffset},
+      Section{mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet),
+              &header.meshletOffset}};
+  uint64_t offset = alignUp(sizeof(Header), SectionAlignment);
+  for (auto& section : sections) {
+    *section.offset = offset;
+    offset = alignUp(offset + section.size, SectionAlignment);
+  }
+
+  // 先写临时文件再改名，避免进程中断留下半个缓存
+  std::string tmpPath = cachePath + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+    const char zeros[SectionAlignment] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    uint64_t written = sizeof(Header);
+    for (auto& section : sections) {
+      file.write(zeros, *section.offset - written);
+      file.write(static_cast<const char*>(section.data), section.size);
+      written = *section.offset + section.size;
+    }
+    if (!file.good()) {
+      file.close();
+      std::remove(tmpPath.c_str());
+      return false;
+    }
+  }
+  std::remove(cachePath.c_str());
+  if (std::rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sktr
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+#include "sktr/utils/mapped_file.hpp"
+
+namespace sktr {
+
+// 缓存命中时的网格，顶点和索引直接指向映射的文件，不做拷贝
+struct CachedMesh {
+  MappedFile file;
+  const Vertex* vertices = nullptr;
+  uint32_t vertexCount = 0;
+  const uint32_t* indices = nullptr;
+  uint32_t indexCount = 0;
+  std::vector<SubMesh> subMeshes;
+  std::vector<MaterialInfo> materialInfos;
+  std::vector<MeshLod> lods;
+  std::vector<Meshlet> meshlets;
+  Bounds bounds;
+};
+
+/*
+ * 二进制网格缓存(.sktrmesh)，和.obj放在同一目录
+ *
+ * | header | vertices | indices | subMeshes | materialInfos | lods | meshlets |
+ *
+ * 每段按16字节对齐，header中记录源文件的哈希和加载参数，
+ * 任意一项不匹配都视为缓存失效
+ */
+class MeshCache final {
+ public:
+  static constexpr uint32_t Version = 7;
+
+  static std::string CachePath(const std::string& sourcePath) {
+    return sourcePath + ".sktrmesh";
+  }
+
+  // 源文件内容的64位哈希
+  static uint64_t HashFile(const std::string& filename);
+  /**
+   * @brief  .obj和它用到的.mtl的哈希
+   * @note   缓存中有materialInfos，材质变化时也要失效。
+   *         mtllib引用的每个.mtl按tinyobj的方式在mtlDir中查找，
+   *         mtlDir本身也参与哈希(为空时不加载材质)
+   * @param  mtlDir: .mtl所在的目录，和LoadObjMesh的mtlPath相同
+   */
+  static uint64_t HashSource(const std::string& objPath,
+                             const std::string& mtlDir);
+
+  static std::optional<CachedMesh> Load(const std::string& cachePath,
+                                        uint64_t sourceHash, uint64_t flags);
+  static bool Write(const std::string& cachePath, const MeshData& mesh,
+                    uint64_t sourceHash, uint64_t flags);
+
+ private:
+  struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t flags;
+    uint32_t vertexStride;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t subMeshCount;
+    uint32_t materialCount;
+    uint32_t lodCount;
+    uint32_t meshletCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t subMeshOffset;
+    uint64_t materialOffset;
+    uint64_t lodOffset;
+    uint64_t meshletOffset;
+  };
+};
+
+}  // namespace sktr
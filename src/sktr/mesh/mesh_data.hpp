@@ -0,0 +1,68 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+#include "sktr/utils/common.hpp"
+
+namespace sktr {
+
+struct Bounds {
+  glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+  void Expand(const glm::vec3& p) {
+    min = glm::min(min, p);
+    max = glm::max(max, p);
+  }
+  bool Valid() const {
+    return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+  }
+};
+
+// 一段使用同一个材质的索引区间
+struct SubMesh {
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  int32_t materialId = -1;
+  // drawIndexed的vertexOffset，拆分成16位索引块后每块各自的起始顶点
+  int32_t vertexOffset = 0;
+};
+
+// 一级LOD在subMeshes中对应的区间
+struct MeshLod {
+  uint32_t firstSubMesh = 0;
+  uint32_t subMeshCount = 0;
+  // 相对LOD0的几何误差(模型坐标单位)，用于按屏幕空间误差选择LOD
+  float error = 0.0f;
+};
+
+/*
+ * 一小簇相邻的三角形，和剔除着色器中的结构体布局一致(std430)
+ *
+ * 索引在mesh.indices中连续存放，绘制时直接作为一条drawIndexed命令
+ */
+struct Meshlet {
+  // xyz: 包围球球心，w: 半径(模型坐标)
+  glm::vec4 sphere;
+  // xyz: 法线锥的轴，w: cutoff，为1时锥太宽不能做背面剔除
+  glm::vec4 cone;
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  int32_t vertexOffset = 0;
+  uint32_t subMesh = 0;
+};
+static_assert(sizeof(Meshlet) == 48, "Meshlet layout must match the shader");
+
+// 加载到CPU端、还未上传到GPU的网格
+struct MeshData {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  std::vector<SubMesh> subMeshes;
+  std::vector<MaterialInfo> materialInfos;
+  // 为空时只有一级，即全部subMeshes
+  std::vector<MeshLod> lods;
+  // LOD0的meshlet，为空时不做meshlet剔除
+  std::vector<Meshlet> meshlets;
+  Bounds bounds;
+};
+
+}  // namespace sktr
@@ -0,0 +1,293 @@
+#include "mesh_optimizer.hpp"
+
+namespace sktr {
+
+static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices,
+                                    size_t indexCount, size_t vertexCount,
+                                    uint32_t cacheSize) {
+  VertexCacheStats stats;
+  if (indexCount < 3) {
+    return stats;
+  }
+  // 记录每个顶点进入缓存时的时间戳，时间戳在窗口内即命中
+  std::vector<uint32_t> timestamps(vertexCount, 0);
+  std::vector<bool> referenced(vertexCount, false);
+  uint32_t time = cacheSize + 1;
+  size_t misses = 0;
+  size_t uniqueCount = 0;
+  for (size_t i = 0; i < indexCount; i++) {
+    const uint32_t index = indices[i];
+    if (time - timestamps[index] > cacheSize) {
+      timestamps[index] = time++;
+      misses++;
+    }
+    if (!referenced[index]) {
+      referenced[index] = true;
+      uniqueCount++;
+    }
+  }
+  stats.acmr = float(misses) / float(indexCount / 3);
+  stats.atvr = uniqueCount ? float(misses) / float(uniqueCount) : 0.0f;
+  return stats;
+}
+
+// Forsyth, "Linear-Speed Vertex Cache Optimisation"
+namespace {
+constexpr uint32_t ForsythCacheSize = 32;
+
+float vertexScore(int32_t cachePosition, uint32_t remainingValence) {
+  if (remainingValence == 0) {
+    return -1.0f;
+  }
+  float score = 0.0f;
+  if (cachePosition >= 0) {
+    if (cachePosition < 3) {
+      // 刚用过的三个顶点属于上一个三角形，不额外奖励
+      score = 0.75f;
+    } else {
+      const float scaler = 1.0f / (ForsythCacheSize - 3);
+      score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+    }
+  }
+  // 剩余三角形越少越优先，尽快把孤立的顶点处理完
+  score += 2.0f / std::sqrt(float(remainingValence));
+  return score;
+}
+}  // namespace
+
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount,
+                         size_t vertexCount) {
+  const size_t triangleCount = indexCount / 3;
+  if (triangleCount < 2) {
+    return;
+  }
+
+  // 顶点 -> 引用它的三角形
+  std::vector<uint32_t> valence(vertexCount, 0);
+  for (size_t i = 0; i < triangleCount * 3; i++) {
+    valence[indices[i]]++;
+  }
+  std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+  for (size_t v = 0; v < vertexCount; v++) {
+    adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+  }
+  std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+  {
+    std::vector<uint32_t> cursor(adjacencyOffsets.begin(),
+                                 adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+      for (int k = 0; k < 3; k++) {
+        adjacency[cursor[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+      }
+    }
+  }
+
+  std::vector<int32_t> cachePositions(vertexCount, -1);
+  std::vector<float> vertexScores(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++) {
+    vertexScores[v] = vertexScore(-1, valence[v]);
+  }
+  std::vector<float> triangleScores(triangleCount);
+  std::vector<bool> emitted(triangleCount, false);
+  for (size_t t = 0; t < triangleCount; t++) {
+    triangleScores[t] = vertexScores[indices[t * 3]] +
+                        vertexScores[indices[t * 3 + 1]] +
+                        vertexScores[indices[t * 3 + 2]];
+  }
+
+  // 多留3个位置给新加入的三角形
+  std::array<uint32_t, ForsythCacheSize + 3> cache;
+  std::array<uint32_t, ForsythCacheSize + 3> nextCache;
+  size_t cacheCount = 0;
+
+  std::vector<uint32_t> result;
+  result.reserve(triangleCount * 3);
+
+  size_t inputCursor = 0;
+  uint32_t best = 0;
+  float bestScore = triangleScores[0];
+  for (size_t t = 1; t < triangleCount; t++) {
+    if (triangleScores[t] > bestScore) {
+      bestScore = triangleScores[t];
+      best = static_cast<uint32_t>(t);
+    }
+  }
+
+  while (best != InvalidIndex) {
+    const uint32_t tri[3] = {indices[best * 3], indices[best * 3 + 1],
+                             indices[best * 3 + 2]};
+    result.insert(result.end(), tri, tri + 3);
+    emitted[best] = true;
+
+    // 新三角形的顶点放到缓存最前面
+    size_t nextCount = 0;
+    for (uint32_t v : tri) {
+      nextCache[nextCount++] = v;
+    }
+    for (size_t i = 0; i < cacheCount; i++) {
+      const uint32_t v = cache[i];
+      if (v != tri[0] && v != tri[1] && v != tri[2]) {
+        nextCache[nextCount++] = v;
+      }
+    }
+    std::swap(cache, nextCache);
+    cacheCount = nextCount;
+
+    for (uint32_t v : tri) {
+      // 从邻接表中移除已输出的三角形
+      auto begin = adjacency.begin() + adjacencyOffsets[v];
+      auto end = begin + valence[v];
+      auto it = std::find(begin, end, best);
+      if (it != end) {
+        std::iter_swap(it, end - 1);
+        valence[v]--;
+      }
+    }
+
+    // 更新缓存中顶点的分数，并在它们的三角形中找最优的
+    best = InvalidIndex;
+    bestScore = -1.0f;
+    for (size_t i = 0; i < cacheCount; i++) {
+      const uint32_t v = cache[i];
+      const int32_t position = i < ForsythCacheSize ? int32_t(i) : -1;
+      cachePositions[v] = position;
+      const float newScore = vertexScore(position, valence[v]);
+      const float delta = newScore - vertexScores[v];
+      vertexScores[v] = newScore;
+      for (uint32_t k = 0; k < valence[v]; k++) {
+        const uint32_t t = adjacency[adjacencyOffsets[v] + k];
+        triangleScores[t] += delta;
+        if (triangleScores[t] > bestScore) {
+          bestScore = triangleScores[t];
+          best = t;
+        }
+      }
+    }
+    cacheCount = std::min<size_t>(cacheCount, ForsythCacheSize);
+
+    // 缓存里已经没有可用的三角形了，按输入顺序取下一个没输出的
+    if (best == InvalidIndex) {
+      while (inputCursor < triangleCount && emitted[inputCursor]) {
+        inputCursor++;
+      }
+      if (inputCursor < triangleCount) {
+        best = static_cast<uint32_t>(inputCursor);
+      }
+    }
+  }
+
+  std::copy(result.begin(), result.end(), indices);
+}
+
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount,
+                      const Vertex* vertices, size_t vertexCount,
+                      const glm::vec3& center) {
+  const size_t triangleCount = indexCount / 3;
+  if (triangleCount < 2) {
+    return;
+  }
+
+  // 1. 在三个顶点都没有命中缓存的地方切开，簇与簇之间互不影响缓存
+  std::vector<uint32_t> clusterStarts;
+  std::vector<uint32_t> timestamps(vertexCount, 0);
+  uint32_t time = SimulatedCacheSize + 1;
+  for (size_t t = 0; t < triangleCount; t++) {
+    uint32_t misses = 0;
+    for (int k = 0; k < 3; k++) {
+      const uint32_t index = indices[t * 3 + k];
+      if (time - timestamps[index] > SimulatedCacheSize) {
+        timestamps[index] = time++;
+        misses++;
+      }
+    }
+    if (t == 0 || misses == 3) {
+      clusterStarts.push_back(static_cast<uint32_t>(t));
+    }
+  }
+  clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+  const size_t clusterCount = clusterStarts.size() - 1;
+  if (clusterCount < 2) {
+    return;
+  }
+
+  // 2. 簇的中心和平均法线，dot(中心 - 模型中心, 法线)越大越朝外
+  std::vector<float> sortKeys(clusterCount);
+  for (size_t c = 0; c < clusterCount; c++) {
+    glm::vec3 centroid(0.0f);
+    glm::vec3 normal(0.0f);
+    float area = 0.0f;
+    for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+      const auto& p0 = vertices[indices[t * 3]].pos;
+      const auto& p1 = vertices[indices[t * 3 + 1]].pos;
+      const auto& p2 = vertices[indices[t * 3 + 2]].pos;
+      const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+      const float triangleArea = glm::length(n);
+      centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+      normal += n;
+      area += triangleArea;
+    }
+    const float normalLength = glm::length(normal);
+    if (area <= 0.0f || normalLength <= 0.0f) {
+      sortKeys[c] = 0.0f;
+      continue;
+    }
+    centroid /= area;
+    normal /= normalLength;
+    sortKeys[c] = glm::dot(centroid - center, normal);
+  }
+
+  std::vector<uint32_t> order(clusterCount);
+  for (size_t c = 0; c < clusterCount; c++) {
+    order[c] = static_cast<uint32_t>(c);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return sortKeys[a] > sortKeys[b];
+  });
+
+  std::vector<uint32_t> result;
+  result.reserve(triangleCount * 3);
+  for (uint32_t c : order) {
+    result.insert(result.end(), indices + clusterStarts[c] * 3,
+                  indices + clusterStarts[c + 1] * 3);
+  }
+  std::copy(result.begin(), result.end(), indices);
+}
+
+void OptimizeVertexFetch(MeshData& mesh) {
+  std::vector<uint32_t> remap(mesh.vertices.size(), InvalidIndex);
+  std::vector<Vertex> vertices;
+  vertices.reserve(mesh.vertices.size());
+  for (auto& index : mesh.indices) {
+    if (remap[index] == InvalidIndex) {
+      remap[index] = static_cast<uint32_t>(vertices.size());
+      vertices.push_back(mesh.vertices[index]);
+    }
+    index = remap[index];
+  }
+  mesh.vertices = std::move(vertices);
+}
+
+MeshOptimizationStats OptimizeMesh(MeshData& mesh) {
+  MeshOptimizationStats stats;
+  stats.before = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(),
+                                    mesh.vertices.size());
+
+  const glm::vec3 center = mesh.bounds.Valid()
+                               ? (mesh.bounds.min + mesh.bounds.max) * 0.5f
+                               : glm::vec3(0.0f);
+  for (const auto& subMesh : mesh.subMeshes) {
+    uint32_t* indices = mesh.indices.data() + subMesh.firstIndex;
+    OptimizeVertexCache(indices, subMesh.indexCount, mesh.vertices.size());
+    OptimizeOverdraw(indices, subMesh.indexCount, mesh.vertices.data(),
+                     mesh.vertices.size(), center);
+  }
+  OptimizeVertexFetch(mesh);
+
+  stats.after = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(),
+                                   mesh.vertices.size());
+  return stats;
+}
+
+}  // namespace sktr
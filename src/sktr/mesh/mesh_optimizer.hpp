@@ -0,0 +1,44 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+// 顶点后处理缓存的统计，用FIFO缓存模拟
+struct VertexCacheStats {
+  // average cache miss ratio: 每个三角形平均需要变换的顶点数，最好为0.5左右，最坏为3
+  float acmr = 0;
+  // average transform to vertex ratio: 变换次数/顶点数，最好为1
+  float atvr = 0;
+};
+
+struct MeshOptimizationStats {
+  VertexCacheStats before;
+  VertexCacheStats after;
+};
+
+// 模拟的FIFO缓存大小，和大多数桌面GPU接近
+constexpr uint32_t SimulatedCacheSize = 16;
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices,
+                                    size_t indexCount, size_t vertexCount,
+                                    uint32_t cacheSize = SimulatedCacheSize);
+
+// 按Forsyth的线性算法重排三角形，提高顶点缓存命中率
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount,
+                         size_t vertexCount);
+
+// 把三角形按缓存冷启动的位置切成簇，按簇朝外的程度排序(从外向内绘制)，
+// 几乎不影响缓存命中率
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount,
+                      const Vertex* vertices, size_t vertexCount,
+                      const glm::vec3& center);
+
+// 按第一次被引用的顺序重排顶点，未被引用的顶点会被删除
+void OptimizeVertexFetch(MeshData& mesh);
+
+// 对每个subMesh做缓存和overdraw优化，最后整体重排顶点
+MeshOptimizationStats OptimizeMesh(MeshData& mesh);
+
+}  // namespace sktr
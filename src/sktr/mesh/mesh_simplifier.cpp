@@ -0,0 +1,450 @@
+#include "mesh_simplifier.hpp"
+
+#include "mesh_optimizer.hpp"
+
+namespace sktr {
+
+namespace {
+
+constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+// 边界约束平面的权重，越大边界越不容易收缩
+constexpr double BorderWeight = 10.0;
+// 法线和uv差异的惩罚，误差按单位包围盒计算
+constexpr double AttributeWeight = 0.01;
+constexpr uint32_t MaxPasses = 64;
+
+// 对称4x4矩阵 (a, b, c, d)(a, b, c, d)^T，只存上三角
+struct Quadric {
+  double a2 = 0, ab = 0, ac = 0, ad = 0;
+  double b2 = 0, bc = 0, bd = 0;
+  double c2 = 0, cd = 0;
+  double d2 = 0;
+  double weight = 0;
+
+  static Quadric FromPlane(double a, double b, double c, double d,
+                           double weight) {
+    Quadric q;
+    q.a2 = a * a * weight;
+    q.ab = a * b * weight;
+    q.ac = a * c * weight;
+    q.ad = a * d * weight;
+    q.b2 = b * b * weight;
+    q.bc = b * c * weight;
+    q.bd = b * d * weight;
+    q.c2 = c * c * weight;
+    q.cd = c * d * weight;
+    q.d2 = d * d * weight;
+    q.weight = weight;
+    return q;
+  }
+
+  Quadric& operator+=(const Quadric& o) {
+    a2 += o.a2, ab += o.ab, ac += o.ac, ad += o.ad;
+    b2 += o.b2, bc += o.bc, bd += o.bd;
+    c2 += o.c2, cd += o.cd;
+    d2 += o.d2;
+    weight += o.weight;
+    return *this;
+  }
+
+  // 到所有平面的加权平均平方距离
+  double Error(const glm::vec3& p) const {
+    const double x = p.x, y = p.y, z = p.z;
+    double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+               b2 * y * y + 2 * bc * y * z + 2 * bd * y + c2 * z * z +
+               2 * cd * z + d2;
+    return weight > 0 ? std::abs(e) / weight : 0.0;
+  }
+};
+
+enum class VertexKind : uint8_t {
+  eManifold,
+  // 开放边界，只能沿边界折叠
+  eBorder,
+  // 属性接缝或非流形，不移动
+  eLocked,
+};
+
+struct PositionKey {
+  std::array<uint32_t, 3> bits;
+  bool operator==(const PositionKey& other) const {
+    return bits == other.bits;
+  }
+};
+
+struct PositionKeyHash {
+  size_t operator()(const PositionKey& key) const {
+    uint64_t h = 0x9e3779b97f4a7c15ull;
+    for (uint32_t bits : key.bits) {
+      h = (h ^ bits) * 0xbf58476d1ce4e5b9ull;
+      h ^= h >> 31;
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+uint64_t edgeKey(uint32_t a, uint32_t b) {
+  if (a > b) {
+    std::swap(a, b);
+  }
+  return (uint64_t(a) << 32) | b;
+}
+
+struct Collapse {
+  uint32_t from;
+  uint32_t to;
+  // 排序用，包含属性惩罚
+  float cost;
+  // 只有几何误差
+  float error;
+};
+
+}  // namespace
+
+SimplifyResult SimplifyMesh(const Vertex* vertices, size_t vertexCount,
+                            const uint32_t* indices, size_t indexCount,
+                            size_t targetIndexCount, float maxError) {
+  SimplifyResult result;
+  result.indices.assign(indices, indices + indexCount);
+  if (indexCount < 3 || targetIndexCount >= indexCount) {
+    return result;
+  }
+
+  // 1. 按单位包围盒归一化，误差和属性惩罚在同一个尺度下比较
+  Bounds bounds;
+  for (size_t i = 0; i < indexCount; i++) {
+    bounds.Expand(vertices[indices[i]].pos);
+  }
+  const glm::vec3 extent = bounds.max - bounds.min;
+  const float scale =
+      std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-12f));
+  const float invScale = 1.0f / scale;
+  std::vector<glm::vec3> positions(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++) {
+    positions[v] = (vertices[v].pos - bounds.min) * invScale;
+  }
+  const double maxCost =
+      maxError == std::numeric_limits<float>::max()
+          ? std::numeric_limits<double>::max()
+          : double(maxError * invScale) * (maxError * invScale);
+
+  // 2. 同一位置的顶点(焊接后只因法线/uv不同)共用一个位置编号
+  std::vector<uint32_t> positionIds(vertexCount, InvalidIndex);
+  std::vector<uint32_t> wedgeCounts;
+  {
+    std::unordered_map<PositionKey, uint32_t, PositionKeyHash> ids;
+    for (size_t i = 0; i < indexCount; i++) {
+      const uint32_t v = indices[i];
+      if (positionIds[v] != InvalidIndex) {
+        continue;
+      }
+      PositionKey key;
+      memcpy(key.bits.data(), &vertices[v].pos, sizeof(key.bits));
+      auto [it, inserted] =
+          ids.emplace(key, static_cast<uint32_t>(wedgeCounts.size()));
+      if (inserted) {
+        wedgeCounts.push_back(0);
+      }
+      positionIds[v] = it->second;
+      wedgeCounts[it->second]++;
+    }
+  }
+  const size_t positionCount = wedgeCounts.size();
+
+  // 3. 按位置统计边，只被一个三角形使用的是边界
+  std::unordered_map<uint64_t, uint32_t> edgeUses;
+  edgeUses.reserve(indexCount);
+  for (size_t t = 0; t + 2 < indexCount; t += 3) {
+    for (int k = 0; k < 3; k++) {
+      const uint32_t a = positionIds[indices[t + k]];
+      const uint32_t b = positionIds[indices[t + (k + 1) % 3]];
+      edgeUses[edgeKey(a, b)]++;
+    }
+  }
+  auto isBorderEdge = [&](uint32_t pa, uint32_t pb) {
+    auto it = edgeUses.find(edgeKey(pa, pb));
+    return it != edgeUses.end() && it->second == 1;
+  };
+
+  // 4. 平面二次误差，边界边额外加一个垂直于三角形的约束平面
+  std::vector<Quadric> quadrics(positionCount);
+  std::vector<uint32_t> borderEdgeCounts(positionCount, 0);
+  for (size_t t = 0; t + 2 < indexCount; t += 3) {
+    const uint32_t tri[3] = {indices[t], indices[t + 1], indices[t + 2]};
+    const glm::vec3& p0 = positions[tri[0]];
+    const glm::vec3& p1 = positions[tri[1]];
+    const glm::vec3& p2 = positions[tri[2]];
+    glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+    const float length = glm::length(normal);
+    if (length <= 0.0f) {
+      continue;
+    }
+    normal /= length;
+    const Quadric plane = Quadric::FromPlane(
+        normal.x, normal.y, normal.z, -glm::dot(normal, p0), length * 0.5);
+    for (uint32_t v : tri) {
+      quadrics[positionIds[v]] += plane;
+    }
+    for (int k = 0; k < 3; k++) {
+      const uint32_t a = tri[k];
+      const uint32_t b = tri[(k + 1) % 3];
+      if (!isBorderEdge(positionIds[a], positionIds[b])) {
+        continue;
+      }
+      borderEdgeCounts[positionIds[a]]++;
+      borderEdgeCounts[positionIds[b]]++;
+      const glm::vec3 edge = positions[b] - positions[a];
+      const float edgeLength = glm::length(edge);
+      if (edgeLength <= 0.0f) {
+        continue;
+      }
+      const glm::vec3 edgeNormal = glm::normalize(glm::cross(edge, normal));
+      const Quadric constraint = Quadric::FromPlane(
+          edgeNormal.x, edgeNormal.y, edgeNormal.z,
+          -glm::dot(edgeNormal, positions[a]),
+          double(edgeLength) * edgeLength * BorderWeight);
+      quadrics[positionIds[a]] += constraint;
+      quadrics[positionIds[b]] += constraint;
+    }
+  }
+
+  std::vector<VertexKind> kinds(positionCount, VertexKind::eManifold);
+  for (size_t p = 0; p < positionCount; p++) {
+    if (wedgeCounts[p] > 1) {
+      kinds[p] = VertexKind::eLocked;
+    } else if (borderEdgeCounts[p] == 2) {
+      kinds[p] = VertexKind::eBorder;
+    } else if (borderEdgeCounts[p] > 0) {
+      kinds[p] = VertexKind::eLocked;
+    }
+  }
+
+  auto attributeCost = [&](uint32_t from, uint32_t to) {
+    const glm::vec3 dn = vertices[from].normal - vertices[to].normal;
+    const glm::vec2 duv = vertices[from].texCoord - vertices[to].texCoord;
+    return AttributeWeight * (glm::dot(dn, dn) + glm::dot(duv, duv));
+  };
+
+  // 5. 每轮按代价从小到大折叠互不相邻的边，直到达到目标
+  auto& current = result.indices;
+  std::vector<uint32_t> remap(vertexCount);
+  std::vector<bool> locked(positionCount);
+  std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+  std::vector<uint32_t> adjacency;
+  std::vector<Collapse> collapses;
+  std::vector<Collapse> bestCollapse(vertexCount);
+  double maxAppliedError = 0.0;
+
+  for (uint32_t pass = 0;
+       pass < MaxPasses && current.size() > targetIndexCount; pass++) {
+    const size_t triangleCount = current.size() / 3;
+
+    // 顶点 -> 三角形，用于检查折叠后三角形是否翻转
+    std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+    for (uint32_t index : current) {
+      adjacencyOffsets[index + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+      adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    adjacency.resize(current.size());
+    {
+      std::vector<uint32_t> cursor(adjacencyOffsets.begin(),
+                                   adjacencyOffsets.end() - 1);
+      for (size_t i = 0; i < current.size(); i++) {
+        adjacency[cursor[current[i]]++] = static_cast<uint32_t>(i / 3);
+      }
+    }
+
+    // 每个顶点只保留代价最小的一个折叠方向
+    std::fill(bestCollapse.begin(), bestCollapse.end(),
+              Collapse{InvalidIndex, InvalidIndex, 0.0f, 0.0f});
+    for (size_t t = 0; t < triangleCount; t++) {
+      for (int k = 0; k < 3; k++) {
+        const uint32_t a = current[t * 3 + k];
+        const uint32_t b = current[t * 3 + (k + 1) % 3];
+        for (auto [from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+          const uint32_t pf = positionIds[from];
+          const uint32_t pt = positionIds[to];
+          if (pf == pt || kinds[pf] == VertexKind::eLocked) {
+            continue;
+          }
+          if (kinds[pf] == VertexKind::eBorder && !isBorderEdge(pf, pt)) {
+            continue;
+          }
+          const double error = quadrics[pf].Error(positions[to]);
+          const double cost = error + attributeCost(from, to);
+          auto& best = bestCollapse[from];
+          if (error <= maxCost &&
+              (best.from == InvalidIndex || cost < best.cost)) {
+            best = {from, to, static_cast<float>(cost),
+                    static_cast<float>(error)};
+          }
+        }
+      }
+    }
+    collapses.clear();
+    for (const auto& collapse : bestCollapse) {
+      if (collapse.from != InvalidIndex) {
+        collapses.push_back(collapse);
+      }
+    }
+    if (collapses.empty()) {
+      break;
+    }
+    std::sort(collapses.begin(), collapses.end(),
+              [](const Collapse& a, const Collapse& b) {
+                return a.cost < b.cost;
+              });
+
+    for (size_t v = 0; v < vertexCount; v++) {
+      remap[v] = static_cast<uint32_t>(v);
+    }
+    std::fill(locked.begin(), locked.end(), false);
+
+    // 不要一轮折叠太多，剩下的留给下一轮用更新后的误差重新排序
+    const size_t passBudget =
+        std::max<size_t>((triangleCount - targetIndexCount / 3) / 2 + 1, 1);
+    size_t removed = 0;
+    for (const auto& collapse : collapses) {
+      if (removed >= passBudget) {
+        break;
+      }
+      const uint32_t from = collapse.from;
+      const uint32_t to = collapse.to;
+      const uint32_t pf = positionIds[from];
+      const uint32_t pt = positionIds[to];
+      if (locked[pf] || locked[pt]) {
+        continue;
+      }
+
+      // 折叠后不能有三角形翻转
+      bool flipped = false;
+      size_t degenerate = 0;
+      for (uint32_t k = adjacencyOffsets[from];
+           k < adjacencyOffsets[from + 1] && !flipped; k++) {
+        const uint32_t* tri = &current[adjacency[k] * 3];
+        if (positionIds[tri[0]] == pt || positionIds[tri[1]] == pt ||
+            positionIds[tri[2]] == pt) {
+          degenerate++;
+          continue;
+        }
+        glm::vec3 p[3], q[3];
+        for (int i = 0; i < 3; i++) {
+          p[i] = positions[tri[i]];
+          q[i] = tri[i] == from ? positions[to] : p[i];
+        }
+        const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        const glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+        flipped = glm::dot(before, after) <= 0.0f;
+      }
+      if (flipped) {
+        continue;
+      }
+
+      remap[from] = to;
+      quadrics[pt] += quadrics[pf];
+      maxAppliedError = std::max(maxAppliedError, double(collapse.error));
+      removed += degenerate;
+      // 这些三角形已经改变，本轮不再动它们
+      locked[pf] = locked[pt] = true;
+      for (uint32_t k = adjacencyOffsets[from]; k < adjacencyOffsets[from + 1];
+           k++) {
+        const uint32_t* tri = &current[adjacency[k] * 3];
+        for (int i = 0; i < 3; i++) {
+          locked[positionIds[tri[i]]] = true;
+        }
+      }
+    }
+    if (removed == 0) {
+      break;
+    }
+
+    // 应用折叠并删掉退化的三角形(包括接缝两侧顶点组成的零面积三角形)
+    size_t write = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+      const uint32_t a = remap[current[t * 3]];
+      const uint32_t b = remap[current[t * 3 + 1]];
+      const uint32_t c = remap[current[t * 3 + 2]];
+      const uint32_t pa = positionIds[a];
+      const uint32_t pb = positionIds[b];
+      const uint32_t pc = positionIds[c];
+      if (pa == pb || pb == pc || pa == pc) {
+        continue;
+      }
+      current[write++] = a;
+      current[write++] = b;
+      current[write++] = c;
+    }
+    current.resize(write);
+  }
+
+  result.error = static_cast<float>(std::sqrt(maxAppliedError)) * scale;
+  return result;
+}
+
+void GenerateLods(MeshData& mesh, uint32_t lodCount, float reduction,
+                  float maxRelativeError) {
+  const uint32_t baseSubMeshCount = static_cast<uint32_t>(mesh.subMeshes.size());
+  mesh.lods.clear();
+  mesh.lods.push_back({0, baseSubMeshCount, 0.0f});
+  if (lodCount <= 1 || baseSubMeshCount == 0) {
+    return;
+  }
+
+  float maxError = std::numeric_limits<float>::max();
+  if (mesh.bounds.Valid()) {
+    const glm::vec3 extent = mesh.bounds.max - mesh.bounds.min;
+    maxError = std::max(std::max(extent.x, extent.y), extent.z) *
+               maxRelativeError;
+  }
+
+  // 每级都从LOD0简化，避免误差逐级累积
+  uint32_t previousIndexCount = 0;
+  for (const auto& subMesh : mesh.subMeshes) {
+    previousIndexCount += subMesh.indexCount;
+  }
+  float ratio = 1.0f;
+  for (uint32_t level = 1; level < lodCount; level++) {
+    ratio *= reduction;
+    MeshLod lod;
+    lod.firstSubMesh = static_cast<uint32_t>(mesh.subMeshes.size());
+    uint32_t lodIndexCount = 0;
+    for (uint32_t s = 0; s < baseSubMeshCount; s++) {
+      const SubMesh base = mesh.subMeshes[s];
+      const size_t target = size_t(base.indexCount * ratio) / 3 * 3;
+      auto simplified = SimplifyMesh(
+          mesh.vertices.data(), mesh.vertices.size(),
+          mesh.indices.data() + base.firstIndex, base.indexCount, target,
+          maxError);
+      if (simplified.indices.empty()) {
+        continue;
+      }
+      OptimizeVertexCache(simplified.indices.data(),
+                          simplified.indices.size(), mesh.vertices.size());
+      SubMesh subMesh = base;
+      subMesh.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+      subMesh.indexCount = static_cast<uint32_t>(simplified.indices.size());
+      mesh.indices.insert(mesh.indices.end(), simplified.indices.begin(),
+                          simplified.indices.end());
+      mesh.subMeshes.push_back(subMesh);
+      lod.error = std::max(lod.error, simplified.error);
+      lodIndexCount += subMesh.indexCount;
+    }
+    lod.subMeshCount =
+        static_cast<uint32_t>(mesh.subMeshes.size()) - lod.firstSubMesh;
+
+    // 已经简化不动了(或者什么都不剩)，丢掉这一级并停止
+    if (lodIndexCount >= previousIndexCount || lodIndexCount == 0) {
+      if (lod.subMeshCount > 0) {
+        mesh.indices.resize(mesh.subMeshes[lod.firstSubMesh].firstIndex);
+        mesh.subMeshes.resize(lod.firstSubMesh);
+      }
+      break;
+    }
+    mesh.lods.push_back(lod);
+    previousIndexCount = lodIndexCount;
+  }
+}
+
+}  // namespace sktr
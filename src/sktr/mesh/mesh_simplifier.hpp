@@ -0,0 +1,42 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 基于二次误差(QEM)的半边折叠简化
+ *
+ * 只把一个顶点合并到相邻的已有顶点上，不产生新顶点，
+ * 所以各级LOD可以共用同一个顶点缓冲，只需要新的索引。
+ * 属性接缝(同一位置有多个不同属性的顶点)上的顶点不会移动，
+ * 开放边界上的顶点只能沿边界移动
+ */
+struct SimplifyResult {
+  std::vector<uint32_t> indices;
+  // 折叠引入的最大几何误差，和模型坐标同单位
+  float error = 0.0f;
+};
+
+/**
+ * @brief  简化一段三角形列表
+ * @param  targetIndexCount: 目标索引数，达不到时尽量接近
+ * @param  maxError: 允许的最大误差(模型坐标单位)
+ */
+SimplifyResult SimplifyMesh(
+    const Vertex* vertices, size_t vertexCount, const uint32_t* indices,
+    size_t indexCount, size_t targetIndexCount,
+    float maxError = std::numeric_limits<float>::max());
+
+/**
+ * @brief  生成LOD链，每级的三角形数约为上一级的reduction倍
+ * @note   新的索引追加到mesh.indices后面，每级的subMesh追加到mesh.subMeshes，
+ *         mesh.lods[0]是原始网格。简化不动的级别会被丢弃
+ * @param  lodCount: 包含LOD0在内的总级数
+ * @param  maxRelativeError: 允许的最大误差，相对于包围盒的最大边长
+ */
+void GenerateLods(MeshData& mesh, uint32_t lodCount, float reduction = 0.5f,
+                  float maxRelativeError = 0.05f);
+
+}  // namespace sktr
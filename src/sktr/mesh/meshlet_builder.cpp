@@ -0,0 +1,221 @@
+#include "meshlet_builder.hpp"
+
+namespace sktr {
+
+static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+// 包围球取顶点包围盒的中心，法线锥取三角形法线的平均方向
+static void computeMeshletBounds(const Vertex* vertices,
+                                 const uint32_t* indices, uint32_t indexCount,
+                                 Meshlet& meshlet) {
+  Bounds box;
+  for (uint32_t i = 0; i < indexCount; i++) {
+    box.Expand(vertices[indices[i]].pos);
+  }
+  glm::vec3 center = (box.min + box.max) * 0.5f;
+  float radius = 0.0f;
+  for (uint32_t i = 0; i < indexCount; i++) {
+    radius = std::max(radius, glm::length(vertices[indices[i]].pos - center));
+  }
+  meshlet.sphere = glm::vec4(center, radius);
+
+  std::vector<glm::vec3> normals;
+  normals.reserve(indexCount / 3);
+  glm::vec3 sum(0.0f);
+  for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+    const glm::vec3& p0 = vertices[indices[i]].pos;
+    const glm::vec3& p1 = vertices[indices[i + 1]].pos;
+    const glm::vec3& p2 = vertices[indices[i + 2]].pos;
+    glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+    float length = glm::length(n);
+    // 退化三角形不可见，不影响锥的范围
+    if (length <= 0.0f) {
+      continue;
+    }
+    normals.push_back(n / length);
+    sum += normals.back();
+  }
+
+  meshlet.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+  float sumLength = glm::length(sum);
+  if (normals.empty() || sumLength < 1e-6f) {
+    return;
+  }
+  glm::vec3 axis = sum / sumLength;
+  float minDot = 1.0f;
+  for (const auto& n : normals) {
+    minDot = std::min(minDot, glm::dot(n, axis));
+  }
+  // 锥的半角接近90°时几乎不可能整体背对相机，不值得判断
+  float cutoff = minDot <= 0.1f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+  meshlet.cone = glm::vec4(axis, cutoff);
+}
+
+// 从种子三角形开始沿共享顶点贪心生长，优先选新增顶点最少、离当前中心最近的三角形
+static void buildSubMeshMeshlets(MeshData& mesh, uint32_t subMeshIndex) {
+  const SubMesh& subMesh = mesh.subMeshes[subMeshIndex];
+  const uint32_t triangleCount = subMesh.indexCount / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+  const uint32_t* indices = mesh.indices.data() + subMesh.firstIndex;
+  const Vertex* vertices = mesh.vertices.data() + subMesh.vertexOffset;
+
+  uint32_t minVertex = InvalidIndex;
+  uint32_t maxVertex = 0;
+  for (uint32_t i = 0; i < triangleCount * 3; i++) {
+    minVertex = std::min(minVertex, indices[i]);
+    maxVertex = std::max(maxVertex, indices[i]);
+  }
+  const uint32_t vertexRange = maxVertex - minVertex + 1;
+
+  // 顶点 -> 相邻三角形(CSR)
+  std::vector<uint32_t> adjacencyOffsets(vertexRange + 1, 0);
+  for (uint32_t i = 0; i < triangleCount * 3; i++) {
+    adjacencyOffsets[indices[i] - minVertex + 1]++;
+  }
+  for (uint32_t v = 0; v < vertexRange; v++) {
+    adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+  }
+  std::vector<uint32_t> adjacency(triangleCount * 3);
+  {
+    std::vector<uint32_t> cursor(adjacencyOffsets.begin(),
+                                 adjacencyOffsets.end() - 1);
+    for (uint32_t i = 0; i < triangleCount * 3; i++) {
+      adjacency[cursor[indices[i] - minVertex]++] = i / 3;
+    }
+  }
+
+  std::vector<bool> emitted(triangleCount, false);
+  // 记录顶点/候选三角形属于第几个meshlet，换meshlet时不需要清空
+  std::vector<uint32_t> vertexTag(vertexRange, InvalidIndex);
+  std::vector<uint32_t> candidateTag(triangleCount, InvalidIndex);
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> reordered;
+  reordered.reserve(triangleCount * 3);
+
+  uint32_t seedCursor = 0;
+  uint32_t tag = 0;
+  while (reordered.size() < triangleCount * 3) {
+    Meshlet meshlet;
+    meshlet.firstIndex =
+        subMesh.firstIndex + static_cast<uint32_t>(reordered.size());
+    meshlet.vertexOffset = subMesh.vertexOffset;
+    meshlet.subMesh = subMeshIndex;
+    uint32_t meshletVertexCount = 0;
+    uint32_t meshletTriangleCount = 0;
+    glm::vec3 positionSum(0.0f);
+    candidates.clear();
+
+    auto newVertexCount = [&](uint32_t triangle) {
+      uint32_t count = 0;
+      for (int k = 0; k < 3; k++) {
+        count += vertexTag[indices[triangle * 3 + k] - minVertex] != tag;
+      }
+      return count;
+    };
+
+    uint32_t triangle = InvalidIndex;
+    while (true) {
+      if (triangle == InvalidIndex) {
+        // 当前连通块已用完，从下一个未输出的三角形继续
+        while (seedCursor < triangleCount && emitted[seedCursor]) {
+          seedCursor++;
+        }
+        if (seedCursor == triangleCount ||
+            meshletVertexCount + newVertexCount(seedCursor) >
+                MeshletMaxVertices) {
+          break;
+        }
+        triangle = seedCursor;
+      }
+
+      emitted[triangle] = true;
+      meshletTriangleCount++;
+      for (int k = 0; k < 3; k++) {
+        uint32_t index = indices[triangle * 3 + k];
+        reordered.push_back(index);
+        uint32_t local = index - minVertex;
+        if (vertexTag[local] == tag) {
+          continue;
+        }
+        vertexTag[local] = tag;
+        meshletVertexCount++;
+        positionSum += vertices[index].pos;
+        for (uint32_t a = adjacencyOffsets[local];
+             a < adjacencyOffsets[local + 1]; a++) {
+          uint32_t neighbor = adjacency[a];
+          if (!emitted[neighbor] && candidateTag[neighbor] != tag) {
+            candidateTag[neighbor] = tag;
+            candidates.push_back(neighbor);
+          }
+        }
+      }
+      if (meshletTriangleCount == MeshletMaxTriangles) {
+        break;
+      }
+
+      const glm::vec3 centroid =
+          positionSum / static_cast<float>(meshletVertexCount);
+      triangle = InvalidIndex;
+      uint32_t bestNew = InvalidIndex;
+      float bestDistance = std::numeric_limits<float>::max();
+      bool hasCandidate = false;
+      for (size_t c = 0; c < candidates.size();) {
+        uint32_t candidate = candidates[c];
+        if (emitted[candidate]) {
+          candidates[c] = candidates.back();
+          candidates.pop_back();
+          continue;
+        }
+        c++;
+        hasCandidate = true;
+        uint32_t added = newVertexCount(candidate);
+        if (meshletVertexCount + added > MeshletMaxVertices ||
+            added > bestNew) {
+          continue;
+        }
+        const glm::vec3 center =
+            (vertices[indices[candidate * 3]].pos +
+             vertices[indices[candidate * 3 + 1]].pos +
+             vertices[indices[candidate * 3 + 2]].pos) /
+            3.0f;
+        float distance = glm::dot(center - centroid, center - centroid);
+        if (added < bestNew || distance < bestDistance) {
+          bestNew = added;
+          bestDistance = distance;
+          triangle = candidate;
+        }
+      }
+      // 还有相邻三角形但顶点已满，结束当前meshlet
+      if (triangle == InvalidIndex && hasCandidate) {
+        break;
+      }
+    }
+
+    meshlet.indexCount = meshletTriangleCount * 3;
+    computeMeshletBounds(vertices, reordered.data() + meshlet.firstIndex -
+                                       subMesh.firstIndex,
+                         meshlet.indexCount, meshlet);
+    mesh.meshlets.push_back(meshlet);
+    tag++;
+  }
+
+  std::copy(reordered.begin(), reordered.end(),
+            mesh.indices.begin() + subMesh.firstIndex);
+}
+
+void BuildMeshlets(MeshData& mesh) {
+  mesh.meshlets.clear();
+  uint32_t firstSubMesh = 0;
+  uint32_t subMeshCount = static_cast<uint32_t>(mesh.subMeshes.size());
+  if (!mesh.lods.empty()) {
+    firstSubMesh = mesh.lods[0].firstSubMesh;
+    subMeshCount = mesh.lods[0].subMeshCount;
+  }
+  for (uint32_t i = 0; i < subMeshCount; i++) {
+    buildSubMeshMeshlets(mesh, firstSubMesh + i);
+  }
+}
+
+}  // namespace sktr
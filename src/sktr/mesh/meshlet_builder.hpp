@@ -0,0 +1,33 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+// 每个meshlet最多引用的顶点数和三角形数
+constexpr uint32_t MeshletMaxVertices = 64;
+constexpr uint32_t MeshletMaxTriangles = 124;
+
+/**
+ * @brief  把LOD0的每个subMesh切成meshlet
+ * @note   每个subMesh内部的三角形会被重排，使每个meshlet的索引连续，
+ *         subMesh和其他级LOD的区间不变。结果写入mesh.meshlets
+ */
+void BuildMeshlets(MeshData& mesh);
+
+/**
+ * @brief  法线锥背面剔除，和meshlet_cull.comp中的判断相同
+ * @param  cameraPosition: 模型坐标下的相机位置
+ * @retval meshlet的所有三角形都背对相机时返回true
+ */
+inline bool MeshletBackfacing(const Meshlet& meshlet,
+                              const glm::vec3& cameraPosition) {
+  glm::vec3 center(meshlet.sphere);
+  glm::vec3 axis(meshlet.cone);
+  glm::vec3 view = center - cameraPosition;
+  return glm::dot(view, axis) >=
+         meshlet.cone.w * glm::length(view) + meshlet.sphere.w;
+}
+
+}  // namespace sktr
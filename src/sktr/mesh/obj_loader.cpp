@@ -0,0 +1,275 @@
+#include "obj_loader.hpp"
+#define TINYOBJLOADER_IMPLEMENTATION
+
+#include <tiny_obj_loader.h>
+
+#include "sktr/utils/thread_pool.hpp"
+
+namespace sktr {
+
+// 每个分块至少要有这么多索引，太小的模型分块只会更慢
+static constexpr uint32_t MinIndicesPerChunk = 1 << 16;
+// 合并分区的编号用uint8_t保存
+static constexpr uint32_t MaxChunks = 256;
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+static Vertex fetchVertex(const tinyobj::attrib_t& attrib,
+                          const tinyobj::index_t& index) {
+  Vertex vertex{};
+  vertex.pos = {attrib.vertices[3 * index.vertex_index + 0],
+                attrib.vertices[3 * index.vertex_index + 1],
+                attrib.vertices[3 * index.vertex_index + 2]};
+
+  vertex.normal = {attrib.normals[3 * index.normal_index + 0],
+                   attrib.normals[3 * index.normal_index + 1],
+                   attrib.normals[3 * index.normal_index + 2]};
+
+  vertex.texCoord = {attrib.texcoords[2 * index.texcoord_index + 0],
+                     1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
+
+  vertex.color = {1.0f, 1.0f, 1.0f};
+  return vertex;
+}
+
+namespace {
+struct WeldChunk {
+  std::vector<Vertex> vertices;
+  // 每个局部顶点归属的合并分区
+  std::vector<uint8_t> partitions;
+  // 块内的局部顶点编号
+  std::vector<uint32_t> indices;
+  // 该顶点第一次出现的位置: (chunk << 32) | localIndex
+  std::vector<uint64_t> owners;
+  // 局部编号 -> 全局编号
+  std::vector<uint32_t> remap;
+};
+}  // namespace
+
+MeshData LoadObjMesh(const std::string& modelPath, const std::string& mtlPath,
+                     const ObjLoadOptions& options, ObjLoadStats* stats) {
+  auto start = Clock::now();
+
+  tinyobj::attrib_t attrib;
+  std::vector<tinyobj::shape_t> shapes;
+  std::vector<tinyobj::material_t> materials_t;
+  std::string warn;
+  std::string err;
+
+  const char* mtlPathC =
+      mtlPath.empty() ? (const char*)__null : mtlPath.c_str();
+  if (!tinyobj::LoadObj(&attrib, &shapes, &materials_t, &err, modelPath.c_str(),
+                        mtlPathC)) {
+    throw std::runtime_error(warn + err);
+  }
+  if (stats) {
+    stats->parseMs = elapsedMs(start);
+  }
+  start = Clock::now();
+
+  MeshData mesh;
+  mesh.materialInfos.resize(materials_t.size());
+  for (auto i = 0; i < materials_t.size(); ++i) {
+    auto& material = materials_t[i];
+    mesh.materialInfos[i].diffuse = {material.diffuse[0], material.diffuse[1],
+                                     material.diffuse[2]};
+    mesh.materialInfos[i].specular = {
+        material.specular[0], material.specular[1], material.specular[2]};
+  }
+
+  // 所有shape的索引看作一个连续的数组，shapeStarts[i]是第i个shape的起点
+  std::vector<uint32_t> shapeStarts(shapes.size() + 1, 0);
+  for (size_t i = 0; i < shapes.size(); i++) {
+    shapeStarts[i + 1] =
+        shapeStarts[i] + static_cast<uint32_t>(shapes[i].mesh.indices.size());
+  }
+  const uint32_t indexCount = shapeStarts.back();
+
+  ThreadPool pool(options.threadCount);
+  const uint32_t chunkCount =
+      std::max(1u, std::min({pool.ThreadCount(), MaxChunks,
+                             indexCount / MinIndicesPerChunk}));
+  auto chunkBegin = [&](uint32_t chunk) {
+    return static_cast<uint32_t>(uint64_t(indexCount) * chunk / chunkCount);
+  };
+
+  // 1. 每个分块独立去重，局部编号按首次出现的顺序分配
+  std::vector<WeldChunk> chunks(chunkCount);
+  pool.ParallelFor(chunkCount, [&](uint32_t c) {
+    auto& chunk = chunks[c];
+    const uint32_t begin = chunkBegin(c);
+    const uint32_t end = chunkBegin(c + 1);
+    WeldTable uniqueVertices(end - begin, options.weldMode,
+                             options.weldEpsilon);
+    chunk.indices.reserve(end - begin);
+
+    size_t shape = std::upper_bound(shapeStarts.begin(), shapeStarts.end(),
+                                    begin) -
+                   shapeStarts.begin() - 1;
+    for (uint32_t i = begin; i < end; i++) {
+      while (i >= shapeStarts[shape + 1]) {
+        shape++;
+      }
+      const auto& index = shapes[shape].mesh.indices[i - shapeStarts[shape]];
+      Vertex vertex = fetchVertex(attrib, index);
+      auto key = uniqueVertices.MakeKey(vertex);
+      auto hash = WeldTable::HashKey(key);
+      auto result = uniqueVertices.Insert(vertex, key, hash);
+      if (result.second && chunkCount > 1) {
+        // 用哈希的高位分区，和表内槽位用的低位错开
+        chunk.partitions.push_back(
+            static_cast<uint8_t>((hash >> 40) % chunkCount));
+      }
+      chunk.indices.push_back(result.first);
+    }
+    chunk.vertices = uniqueVertices.TakeVertices();
+  });
+
+  if (chunkCount == 1) {
+    mesh.vertices = std::move(chunks[0].vertices);
+    mesh.indices = std::move(chunks[0].indices);
+  } else {
+    // 2. 按哈希分区并行合并：每个分区按(块, 局部编号)的顺序扫描属于自己的顶点，
+    //    记下每个顶点第一次出现的位置
+    for (auto& chunk : chunks) {
+      chunk.owners.resize(chunk.vertices.size());
+    }
+    pool.ParallelFor(chunkCount, [&](uint32_t p) {
+      size_t expected = 0;
+      for (auto& chunk : chunks) {
+        expected += chunk.vertices.size();
+      }
+      WeldTable uniqueVertices(expected / chunkCount + 1, options.weldMode,
+                               options.weldEpsilon);
+      std::vector<uint64_t> firstSeen;
+      for (uint32_t c = 0; c < chunkCount; c++) {
+        auto& chunk = chunks[c];
+        for (uint32_t i = 0; i < chunk.vertices.size(); i++) {
+          if (chunk.partitions[i] != p) {
+            continue;
+          }
+          auto result = uniqueVertices.Insert(chunk.vertices[i]);
+          if (result.second) {
+            firstSeen.push_back((uint64_t(c) << 32) | i);
+          }
+          chunk.owners[i] = firstSeen[result.first];
+        }
+      }
+    });
+
+    // 3. 第一次出现的顶点按块顺序编号，与单线程首次出现的顺序一致
+    std::vector<uint32_t> chunkBases(chunkCount + 1, 0);
+    for (uint32_t c = 0; c < chunkCount; c++) {
+      auto& chunk = chunks[c];
+      uint32_t count = 0;
+      for (uint32_t i = 0; i < chunk.owners.size(); i++) {
+        count += chunk.owners[i] == ((uint64_t(c) << 32) | i);
+      }
+      chunkBases[c + 1] = chunkBases[c] + count;
+    }
+    mesh.vertices.resize(chunkBases.back());
+    pool.ParallelFor(chunkCount, [&](uint32_t c) {
+      auto& chunk = chunks[c];
+      chunk.remap.resize(chunk.vertices.size());
+      uint32_t next = chunkBases[c];
+      for (uint32_t i = 0; i < chunk.owners.size(); i++) {
+        if (chunk.owners[i] == ((uint64_t(c) << 32) | i)) {
+          mesh.vertices[next] = chunk.vertices[i];
+          chunk.remap[i] = next++;
+        }
+      }
+    });
+    // 重复的顶点指向第一次出现的位置，它一定在更早或同一个块里，已经编号
+    pool.ParallelFor(chunkCount, [&](uint32_t c) {
+      auto& chunk = chunks[c];
+      for (uint32_t i = 0; i < chunk.owners.size(); i++) {
+        const uint64_t owner = chunk.owners[i];
+        if (owner != ((uint64_t(c) << 32) | i)) {
+          chunk.remap[i] = chunks[owner >> 32].remap[owner & 0xffffffffu];
+        }
+      }
+    });
+
+    // 4. 局部编号换成全局编号
+    mesh.indices.resize(indexCount);
+    pool.ParallelFor(chunkCount, [&](uint32_t c) {
+      auto& chunk = chunks[c];
+      uint32_t* dst = mesh.indices.data() + chunkBegin(c);
+      for (size_t i = 0; i < chunk.indices.size(); i++) {
+        dst[i] = chunk.remap[chunk.indices[i]];
+      }
+    });
+  }
+
+  for (const auto& vertex : mesh.vertices) {
+    mesh.bounds.Expand(vertex.pos);
+  }
+
+  // 按材质把三角形分组，同一材质的三角形连续存放，组内保持原来的顺序。
+  // 材质id+1作为桶号，没有材质(-1)的在最前面
+  const int32_t materialCount = static_cast<int32_t>(materials_t.size());
+  std::vector<int32_t> faceMaterials;
+  faceMaterials.reserve(indexCount / 3);
+  for (const auto& shape : shapes) {
+    const auto& ids = shape.mesh.material_ids;
+    for (size_t f = 0; f < shape.mesh.indices.size() / 3; f++) {
+      int32_t id = f < ids.size() ? ids[f] : -1;
+      faceMaterials.push_back(id >= 0 && id < materialCount ? id : -1);
+    }
+  }
+  std::vector<uint32_t> bucketStarts(materialCount + 2, 0);
+  for (int32_t id : faceMaterials) {
+    bucketStarts[id + 2] += 3;
+  }
+  for (size_t i = 1; i < bucketStarts.size(); i++) {
+    bucketStarts[i] += bucketStarts[i - 1];
+  }
+  if (!std::is_sorted(faceMaterials.begin(), faceMaterials.end())) {
+    std::vector<uint32_t> grouped(mesh.indices.size());
+    std::vector<uint32_t> cursor(bucketStarts.begin(), bucketStarts.end() - 1);
+    for (size_t f = 0; f < faceMaterials.size(); f++) {
+      uint32_t& dst = cursor[faceMaterials[f] + 1];
+      memcpy(&grouped[dst], &mesh.indices[f * 3], 3 * sizeof(uint32_t));
+      dst += 3;
+    }
+    mesh.indices = std::move(grouped);
+  }
+  for (int32_t id = -1; id < materialCount; id++) {
+    SubMesh subMesh;
+    subMesh.firstIndex = bucketStarts[id + 1];
+    subMesh.indexCount = bucketStarts[id + 2] - bucketStarts[id + 1];
+    subMesh.materialId = id;
+    if (subMesh.indexCount > 0) {
+      mesh.subMeshes.push_back(subMesh);
+    }
+  }
+
+  if (options.normalized && mesh.bounds.Valid()) {
+    auto minP = mesh.bounds.min;
+    auto extent = mesh.bounds.max - minP;
+    auto scale_factor =
+        2.0f / std::max(extent.x, std::max(extent.y, extent.z));
+    for (auto& vertex : mesh.vertices) {
+      vertex.pos.x = (vertex.pos.x - minP.x) * scale_factor - 1.0f;
+      vertex.pos.y = (vertex.pos.y - minP.y) * scale_factor - 1.0f;
+      vertex.pos.z = (vertex.pos.z - minP.z) * scale_factor;
+    }
+    mesh.bounds.min = {-1.0f, -1.0f, 0.0f};
+    mesh.bounds.max = {extent.x * scale_factor - 1.0f,
+                       extent.y * scale_factor - 1.0f,
+                       extent.z * scale_factor};
+  }
+
+  if (stats) {
+    stats->weldMs = elapsedMs(start);
+    stats->chunkCount = chunkCount;
+  }
+  return mesh;
+}
+
+}  // namespace sktr
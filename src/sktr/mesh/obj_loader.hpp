@@ -0,0 +1,40 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+#include "weld_table.hpp"
+
+namespace sktr {
+
+struct ObjLoadOptions {
+  // 把模型缩放到[-1, 1]
+  bool normalized = false;
+  // 顶点去重使用的线程数，0表示使用全部硬件线程
+  uint32_t threadCount = 1;
+  WeldMode weldMode = WeldMode::eExact;
+  // 只在eQuantized时使用
+  float weldEpsilon = WeldTable::DefaultEpsilon;
+};
+
+struct ObjLoadStats {
+  double parseMs = 0;
+  double weldMs = 0;
+  uint32_t chunkCount = 0;
+};
+
+/**
+ * @brief  用tinyobj解析.obj文件，并对顶点去重
+ * @note   不涉及任何GPU资源，可以在没有Context的情况下调用。
+ *         多线程时按索引区间分块去重再合并，结果与单线程完全一致。
+ *         三角形按材质分组，每个材质一个subMesh
+ * @param  modelPath: .obj文件路径
+ * @param  mtlPath: .mtl所在的目录，为空时不加载材质
+ * @param  options: 加载参数
+ * @param  stats: 可选，各阶段耗时
+ * @retval 去重后的网格
+ */
+MeshData LoadObjMesh(const std::string& modelPath, const std::string& mtlPath,
+                     const ObjLoadOptions& options = {},
+                     ObjLoadStats* stats = nullptr);
+
+}  // namespace sktr
@@ -0,0 +1,82 @@
+#include "vertex_packing.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+namespace sktr {
+
+VertexDequantization VertexDequantization::FromBounds(const Bounds& bounds) {
+  VertexDequantization dequantization;
+  if (!bounds.Valid()) {
+    return dequantization;
+  }
+  dequantization.offset = glm::vec4(bounds.min, 0.0f);
+  dequantization.scale = glm::vec4(bounds.max - bounds.min, 0.0f);
+  return dequantization;
+}
+
+static float signNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+glm::vec2 OctEncode(const glm::vec3& normal) {
+  const float l1 =
+      std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (l1 <= 0.0f) {
+    return glm::vec2(0.0f);
+  }
+  glm::vec2 e(normal.x / l1, normal.y / l1);
+  if (normal.z < 0.0f) {
+    // 下半球折叠到外侧的四个三角形
+    e = glm::vec2((1.0f - std::abs(e.y)) * signNotZero(e.x),
+                  (1.0f - std::abs(e.x)) * signNotZero(e.y));
+  }
+  return e;
+}
+
+glm::vec3 OctDecode(const glm::vec2& e) {
+  glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+  const float t = std::max(-n.z, 0.0f);
+  n.x += n.x >= 0.0f ? -t : t;
+  n.y += n.y >= 0.0f ? -t : t;
+  return glm::normalize(n);
+}
+
+static uint16_t toUnorm16(float v) {
+  v = std::min(std::max(v, 0.0f), 1.0f);
+  return static_cast<uint16_t>(std::lround(v * 65535.0f));
+}
+
+static int16_t toSnorm16(float v) {
+  v = std::min(std::max(v, -1.0f), 1.0f);
+  return static_cast<int16_t>(std::lround(v * 32767.0f));
+}
+
+PackedVertex PackVertex(const Vertex& vertex,
+                        const VertexDequantization& dequantization) {
+  PackedVertex packed;
+  for (int i = 0; i < 3; i++) {
+    const float scale = dequantization.scale[i];
+    // 包围盒在这个轴上没有厚度
+    const float t =
+        scale > 0.0f ? (vertex.pos[i] - dequantization.offset[i]) / scale
+                     : 0.0f;
+    packed.pos[i] = toUnorm16(t);
+  }
+  packed.pos[3] = 0;
+
+  const glm::vec2 normal = OctEncode(vertex.normal);
+  packed.normal[0] = toSnorm16(normal.x);
+  packed.normal[1] = toSnorm16(normal.y);
+
+  packed.texCoord[0] = glm::packHalf1x16(vertex.texCoord.x);
+  packed.texCoord[1] = glm::packHalf1x16(vertex.texCoord.y);
+  return packed;
+}
+
+void PackVertices(const Vertex* src, uint32_t count,
+                  const VertexDequantization& dequantization,
+                  PackedVertex* dst) {
+  for (uint32_t i = 0; i < count; i++) {
+    dst[i] = PackVertex(src[i], dequantization);
+  }
+}
+
+}  // namespace sktr
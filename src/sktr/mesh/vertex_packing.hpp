@@ -0,0 +1,30 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "sktr/pch.hpp"
+#include "sktr/utils/common.hpp"
+
+namespace sktr {
+
+// 还原PackedVertex位置的参数，作为push constant传给shader.vert
+// pos = offset + unorm * scale
+struct VertexDequantization {
+  alignas(16) glm::vec4 offset = glm::vec4(0.0f);
+  alignas(16) glm::vec4 scale = glm::vec4(1.0f);
+
+  static VertexDequantization FromBounds(const Bounds& bounds);
+};
+
+// 八面体编码，返回[-1, 1]^2
+glm::vec2 OctEncode(const glm::vec3& normal);
+glm::vec3 OctDecode(const glm::vec2& encoded);
+
+PackedVertex PackVertex(const Vertex& vertex,
+                        const VertexDequantization& dequantization);
+
+// dst可以直接是映射的staging buffer
+void PackVertices(const Vertex* src, uint32_t count,
+                  const VertexDequantization& dequantization,
+                  PackedVertex* dst);
+
+}  // namespace sktr
@@ -0,0 +1,111 @@
+#include "weld_table.hpp"
+
+namespace sktr {
+
+static size_t nextPowerOfTwo(size_t value) {
+  size_t result = 16;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+WeldTable::WeldTable(size_t expectedCount, WeldMode mode, float epsilon)
+    : mode_(mode), invEpsilon_(1.0 / epsilon) {
+  if (mode == WeldMode::eQuantized &&
+      !(epsilon > 0.0f && std::isfinite(epsilon))) {
+    throw std::runtime_error("weld epsilon must be positive and finite");
+  }
+  slots_.resize(nextPowerOfTwo(expectedCount * 2));
+  mask_ = slots_.size() - 1;
+  vertices_.reserve(expectedCount);
+  keys_.reserve(expectedCount);
+}
+
+WeldTable::Key WeldTable::MakeKey(const Vertex& vertex) const {
+  const float components[11] = {
+      vertex.pos.x,    vertex.pos.y,    vertex.pos.z,        vertex.color.x,
+      vertex.color.y,  vertex.color.z,  vertex.normal.x,     vertex.normal.y,
+      vertex.normal.z, vertex.texCoord.x, vertex.texCoord.y};
+  Key key;
+  if (mode_ == WeldMode::eExact) {
+    for (int i = 0; i < 11; i++) {
+      // +0.0f 把 -0.0 规范为 0.0
+      float value = components[i] + 0.0f;
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      key.words[i] = bits;
+    }
+  } else {
+    // 用double计算，1e-6的网格下坐标到1e12都不会截断。
+    // 超出范围时截断会让远处不同的顶点合并，直接拒绝
+    constexpr double limit = 4611686018427387904.0;
+    for (int i = 0; i < 11; i++) {
+      double scaled = std::floor(components[i] * invEpsilon_ + 0.5);
+      if (!(std::abs(scaled) < limit)) {
+        throw std::runtime_error(
+            std::isfinite(components[i])
+                ? "weld epsilon too small for vertex coordinate " +
+                      std::to_string(components[i])
+                : "can't weld vertex with non-finite component");
+      }
+      key.words[i] = static_cast<uint64_t>(static_cast<int64_t>(scaled));
+    }
+  }
+  return key;
+}
+
+uint64_t WeldTable::HashKey(const Key& key) {
+  uint64_t hash = 0x9e3779b97f4a7c15ull;
+  for (uint64_t word : key.words) {
+    hash = (hash ^ word) * 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 31;
+  }
+  // murmur3 fmix64
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+std::pair<uint32_t, bool> WeldTable::Insert(const Vertex& vertex,
+                                            const Key& key, uint64_t hash) {
+  if ((vertices_.size() + 1) * 2 > slots_.size()) {
+    rehash(slots_.size() * 2);
+  }
+
+  const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+  size_t slot = hash & mask_;
+  while (true) {
+    auto& entry = slots_[slot];
+    if (entry.id == EmptySlot) {
+      entry.tag = tag;
+      entry.id = static_cast<uint32_t>(vertices_.size());
+      vertices_.push_back(vertex);
+      keys_.push_back(key);
+      return {entry.id, true};
+    }
+    if (entry.tag == tag && keys_[entry.id] == key) {
+      return {entry.id, false};
+    }
+    slot = (slot + 1) & mask_;
+  }
+}
+
+void WeldTable::rehash(size_t slotCount) {
+  slots_.assign(slotCount, Slot{});
+  mask_ = slotCount - 1;
+  for (uint32_t id = 0; id < keys_.size(); id++) {
+    const uint64_t hash = HashKey(keys_[id]);
+    size_t slot = hash & mask_;
+    while (slots_[slot].id != EmptySlot) {
+      slot = (slot + 1) & mask_;
+    }
+    slots_[slot].tag = static_cast<uint32_t>(hash >> 32);
+    slots_[slot].id = id;
+  }
+}
+
+}  // namespace sktr
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+#include "sktr/utils/common.hpp"
+
+namespace sktr {
+
+enum class WeldMode {
+  // 所有分量按位相等才合并(-0.0与0.0视为相等)
+  eExact,
+  // 所有分量量化到epsilon的网格后相等就合并。
+  // 分量不能是NaN或无穷，|x| / epsilon不能超过2^62，否则抛出异常
+  eQuantized,
+};
+
+/*
+ * 用于顶点焊接的开放寻址哈希表
+ *
+ * 槽位只存 哈希高32位 + 顶点编号，线性探测；
+ * 顶点和比较用的键按插入顺序连续存放，编号就是首次插入的顺序。
+ * 构造时按预计的顶点数(通常用索引数)一次性分配，装载率超过1/2时扩容
+ */
+class WeldTable final {
+ public:
+  static constexpr float DefaultEpsilon = 1e-6f;
+
+  struct Key {
+    // pos, color, normal, texCoord 共11个分量，量化后的网格坐标可能超过32位
+    std::array<uint64_t, 11> words;
+    bool operator==(const Key& other) const { return words == other.words; }
+  };
+
+  WeldTable(size_t expectedCount, WeldMode mode = WeldMode::eExact,
+            float epsilon = DefaultEpsilon);
+
+  Key MakeKey(const Vertex& vertex) const;
+  static uint64_t HashKey(const Key& key);
+
+  // 查找或插入，返回顶点编号以及是否为新插入
+  std::pair<uint32_t, bool> Insert(const Vertex& vertex) {
+    Key key = MakeKey(vertex);
+    return Insert(vertex, key, HashKey(key));
+  }
+  std::pair<uint32_t, bool> Insert(const Vertex& vertex, const Key& key,
+                                   uint64_t hash);
+
+  size_t Size() const { return vertices_.size(); }
+  const std::vector<Vertex>& Vertices() const { return vertices_; }
+  std::vector<Vertex> TakeVertices() { return std::move(vertices_); }
+
+ private:
+  static constexpr uint32_t EmptySlot = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    uint32_t tag;
+    uint32_t id = EmptySlot;
+  };
+
+  WeldMode mode_;
+  double invEpsilon_;
+  std::vector<Slot> slots_;
+  size_t mask_;
+  std::vector<Vertex> vertices_;
+  std::vector<Key> keys_;
+
+  void rehash(size_t slotCount);
+};
+
+}  // namespace sktr
@@ -5,17 +5,25 @@
 namespace sktr {
 
 void Init(std::vector<const char *> &extensions, CreateSurfaceFunc func, int w,
-          int h) {
+          int h, bool occlusionCulling) {
   if (EnableValidationLayers) {
     extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     extensions.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
   }
   Context::Init(extensions, func);
   auto &ctx = Context::GetInstance();
+  ctx.occlusionCullingEnabled = occlusionCulling;
+  // ! MemoryAllocator before any Buffer or image
+  ctx.InitMemoryAllocator();
   // ! CommandPool before renderer
   ctx.InitCommandPool();
+  // ! StagingRing before any upload
+  ctx.InitStagingRing();
+  ctx.InitDeletionQueue();
+  ctx.InitGeometryPool();
   ctx.InitSwapchain(w, h);
   Shader::Init(ReadWholeFile("./shaders/vert.spv"),
+               ReadWholeFile("./shaders/vert_instanced.spv"),
                ReadWholeFile("./shaders/frag.spv"));
   ctx.InitRenderProcess(w, h);
   // ! after renderPass
@@ -28,9 +36,13 @@ void Init(std::vector<const char *> &extensions, CreateSurfaceFunc func, int w,
 void Quit() {
   auto &ctx = Context::GetInstance();
   ctx.device.waitIdle();
+  // ! GPU is idle, destroys everything still pending
+  ctx.DestroyDeletionQueue();
   ctx.DestroyRenderer();
   ctx.DestroySampler();
   // textureManager.clear is executed by ~renderer
+  // ! waits for pending uploads, before CommandPool
+  ctx.DestroyStagingRing();
   // ! can not deconstruct in ~Context and after render
   ctx.DestroyCommandPool();
   ctx.DestroyRenderProcess();
@@ -38,6 +50,8 @@ void Quit() {
   // it will also destroy Framebuffers
   ctx.DestroySwapchain();
   DescriptorSetManager::Quit();
+  ctx.DestroyGeometryPool();
+  ctx.DestroyMemoryAllocator();
   Context::Quit();
 }
 
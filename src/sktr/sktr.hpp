@@ -3,12 +3,25 @@
 #include "sktr/core/context.hpp"
 
 namespace sktr {
+// occlusionCulling: 深度附件不再使用transient内存，GpuScene可以做遮挡剔除
 void Init(std::vector<const char *> &extensions, CreateSurfaceFunc func, int w,
-          int h);
+          int h, bool occlusionCulling = false);
 void Quit();
 
 void ResizeSwapchainImage(int w, int h);
 
 inline Renderer &getRenderer() { return *Context::GetInstance().renderer; }
 
+inline MemoryStats getMemoryStats() {
+  return Context::GetInstance().memoryAllocator->GetStats();
+}
+
+inline std::vector<MemoryUsageReport> getMemoryUsageReport() {
+  return Context::GetInstance().memoryAllocator->Policy().Report();
+}
+
+inline std::vector<HeapBudget> getMemoryBudgets() {
+  return Context::GetInstance().memoryAllocator->GetHeapBudgets();
+}
+
 }  // namespace sktr
\ No newline at end of file
@@ -5,26 +5,19 @@
 namespace sktr {
 
 Buffer::Buffer(size_t size, vk::BufferUsageFlags usage,
-               vk::MemoryPropertyFlags propertyFlags)
+               MemoryUsage memoryUsage)
     : size(size) {
   createBuffer(size, usage);
-  auto info = queryBufferMemoryInfo(propertyFlags);
-  allocateMemory(info);
-  bindingMem2Buf();
-
-  if (propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible) {
-    map = Context::GetInstance().device.mapMemory(memory, 0, size);
-  } else {
-    map = nullptr;
-  }
+  auto& ctx = Context::GetInstance();
+  allocation = ctx.memoryAllocator->AllocateForBuffer(buffer, memoryUsage);
+  // 块在创建时已经映射，不能再对同一块内存mapMemory。
+  // eGpuOnly也可能选到host visible的内存，这时同样不映射
+  map = memoryUsage != MemoryUsage::eGpuOnly ? allocation.mapped : nullptr;
 }
 Buffer::~Buffer() {
-  auto& device = Context::GetInstance().device;
-  if (map) {
-    device.unmapMemory(memory);
-  }
-  device.freeMemory(memory);
-  device.destroyBuffer(buffer);
+  auto& ctx = Context::GetInstance();
+  ctx.device.destroyBuffer(buffer);
+  ctx.memoryAllocator->Free(allocation);
 }
 
 void Buffer::createBuffer(size_t size, vk::BufferUsageFlags usage) {
@@ -35,26 +28,4 @@ void Buffer::createBuffer(size_t size, vk::BufferUsageFlags usage) {
   buffer = Context::GetInstance().device.createBuffer(bufferInfo);
 }
 
-void Buffer::allocateMemory(MemoryInfo info) {
-  vk::MemoryAllocateInfo allocInfo;
-  allocInfo.setMemoryTypeIndex(info.index.value()).setAllocationSize(info.size);
-  memory = Context::GetInstance().device.allocateMemory(allocInfo);
-}
-
-void Buffer::bindingMem2Buf() {
-  Context::GetInstance().device.bindBufferMemory(buffer, memory, 0);
-}
-
-Buffer::MemoryInfo Buffer::queryBufferMemoryInfo(
-    vk::MemoryPropertyFlags propertyFlags) {
-  MemoryInfo info;
-  auto requirements =
-      Context::GetInstance().device.getBufferMemoryRequirements(buffer);
-  // * 不能直接用buffer的size，因为可能存在内存对齐的问题
-  info.size = requirements.size;
-
-  info.index = QueryMemoryTypeIndex(requirements.memoryTypeBits, propertyFlags);
-  return info;
-}
-
 }  // namespace sktr
\ No newline at end of file
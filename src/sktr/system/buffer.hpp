@@ -1,5 +1,6 @@
 #pragma once
 
+#include "memory_allocator.hpp"
 #include "sktr/pch.hpp"
 #include "sktr/utils/tools.hpp"
 
@@ -7,23 +8,16 @@ namespace sktr {
 class Buffer final {
  public:
   vk::Buffer buffer;
-  vk::DeviceMemory memory;
+  // 从MemoryAllocator的块中分配，和其他buffer共享同一个vk::DeviceMemory
+  MemoryAllocation allocation;
+  // host visible时指向allocation的映射地址
   void* map;
   size_t size;
 
-  Buffer(size_t size, vk::BufferUsageFlags usage,
-         vk::MemoryPropertyFlags propertyFlags);
+  Buffer(size_t size, vk::BufferUsageFlags usage, MemoryUsage memoryUsage);
   ~Buffer();
 
  private:
-  struct MemoryInfo final {
-    size_t size;
-    std::optional<uint32_t> index = std::nullopt;
-  };
   void createBuffer(size_t size, vk::BufferUsageFlags usage);
-  void allocateMemory(MemoryInfo info);
-  void bindingMem2Buf();
-
-  MemoryInfo queryBufferMemoryInfo(vk::MemoryPropertyFlags);
 };
 }  // namespace sktr
\ No newline at end of file
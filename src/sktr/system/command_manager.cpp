@@ -3,10 +3,14 @@
 #include "sktr/core/context.hpp"
 
 namespace sktr {
-CommandManager::CommandManager() { pool_ = createCommandPool(); }
+CommandManager::CommandManager() {
+  pool_ = createCommandPool();
+  fence_ = Context::GetInstance().device.createFence(vk::FenceCreateInfo{});
+}
 
 CommandManager::~CommandManager() {
   auto& ctx = Context::GetInstance();
+  ctx.device.destroyFence(fence_);
   ctx.device.destroyCommandPool(pool_);
 }
 
@@ -59,16 +63,36 @@ void CommandManager::ExecuteCmd(vk::Queue queue, RecordCmdFunc func) {
   vk::CommandBufferBeginInfo beginInfo;
   beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
   cmdBuff.begin(beginInfo);
+  auto& ctx = Context::GetInstance();
+  // 命令可能用到刚上传的资源，先获取所有权并等待上传完成
+  UploadHandle upload;
+  if (ctx.stagingRing) {
+    upload = ctx.stagingRing->RecordAcquires(cmdBuff);
+  }
   if (func) {
     func(cmdBuff);
   }
   cmdBuff.end();
 
   vk::SubmitInfo submitInfo;
+  vk::TimelineSemaphoreSubmitInfo timelineInfo;
+  vk::Semaphore timeline;
+  vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
   submitInfo.setCommandBuffers(cmdBuff);
-  queue.submit(submitInfo);
-  queue.waitIdle();
-  Context::GetInstance().device.waitIdle();
+  if (upload) {
+    timeline = ctx.stagingRing->Timeline();
+    timelineInfo.setWaitSemaphoreValues(upload.value);
+    submitInfo.setWaitSemaphores(timeline)
+        .setWaitDstStageMask(waitStage)
+        .setPNext(&timelineInfo);
+  }
+  queue.submit(submitInfo, fence_);
+  if (ctx.device.waitForFences(fence_, true,
+                               std::numeric_limits<uint64_t>::max()) !=
+      vk::Result::eSuccess) {
+    std::cout << "wait for command failed" << std::endl;
+  }
+  ctx.device.resetFences(fence_);
   FreeOneCommandBuffer(cmdBuff);
 }
 
@@ -17,10 +17,12 @@ class CommandManager final {
   void FreeOneCommandBuffer(vk::CommandBuffer& cmdBuff);
 
   using RecordCmdFunc = std::function<void(vk::CommandBuffer&)>;
+  // 提交到graphics队列族的queue并等待这一次提交完成，不等待其他帧
   void ExecuteCmd(vk::Queue, RecordCmdFunc);
 
  private:
   vk::CommandPool pool_;
+  vk::Fence fence_;
 
   vk::CommandPool createCommandPool();
 };
@@ -0,0 +1,78 @@
+#include "compute_pipeline.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+ComputePipeline::ComputePipeline(
+    const std::string& source,
+    const std::vector<std::vector<vk::DescriptorType>>& setBindings,
+    uint32_t pushConstantSize) {
+  vk::ShaderModuleCreateInfo shaderModuleInfo;
+  shaderModuleInfo.codeSize = source.size();
+  shaderModuleInfo.pCode = (uint32_t*)source.data();
+  module = Context::GetInstance().device.createShaderModule(shaderModuleInfo);
+
+  initSetLayouts(setBindings);
+  initPipelineLayout(pushConstantSize);
+  initPipeline();
+}
+
+ComputePipeline::~ComputePipeline() {
+  auto& device = Context::GetInstance().device;
+  device.destroyPipeline(pipeline);
+  device.destroyPipelineLayout(layout);
+  for (auto& setLayout : setLayouts) {
+    device.destroyDescriptorSetLayout(setLayout);
+  }
+  device.destroyShaderModule(module);
+}
+
+void ComputePipeline::initSetLayouts(
+    const std::vector<std::vector<vk::DescriptorType>>& setBindings) {
+  auto& device = Context::GetInstance().device;
+  for (const auto& types : setBindings) {
+    std::vector<vk::DescriptorSetLayoutBinding> bindings(types.size());
+    for (uint32_t i = 0; i < types.size(); i++) {
+      bindings[i]
+          .setBinding(i)
+          .setDescriptorCount(1)
+          .setDescriptorType(types[i])
+          .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+    vk::DescriptorSetLayoutCreateInfo setLayoutInfo;
+    setLayoutInfo.setBindings(bindings);
+    setLayouts.push_back(device.createDescriptorSetLayout(setLayoutInfo));
+  }
+}
+
+void ComputePipeline::initPipelineLayout(uint32_t pushConstantSize) {
+  vk::PipelineLayoutCreateInfo layoutInfo;
+  vk::PushConstantRange range;
+  range.setOffset(0)
+      .setSize(pushConstantSize)
+      .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+  layoutInfo.setSetLayouts(setLayouts);
+  if (pushConstantSize > 0) {
+    layoutInfo.setPushConstantRanges(range);
+  }
+  layout = Context::GetInstance().device.createPipelineLayout(layoutInfo);
+}
+
+void ComputePipeline::initPipeline() {
+  vk::PipelineShaderStageCreateInfo stage;
+  stage.setStage(vk::ShaderStageFlagBits::eCompute)
+      .setModule(module)
+      .setPName("main");
+  vk::ComputePipelineCreateInfo pipelineInfo;
+  pipelineInfo.setStage(stage).setLayout(layout);
+
+  auto result = Context::GetInstance().device.createComputePipeline(
+      nullptr, pipelineInfo);
+  if (result.result != vk::Result::eSuccess) {
+    throw std::runtime_error("create compute pipeline failed");
+  }
+  pipeline = result.value;
+}
+
+}  // namespace sktr
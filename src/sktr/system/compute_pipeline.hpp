@@ -0,0 +1,38 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 只有一个compute着色器的管线
+ *
+ * setBindings[i]是第i个descriptor set里各binding的类型，binding号即下标
+ */
+class ComputePipeline final {
+ public:
+  vk::ShaderModule module;
+  std::vector<vk::DescriptorSetLayout> setLayouts;
+  vk::PipelineLayout layout;
+  vk::Pipeline pipeline;
+
+  /**
+   * @brief
+   * @param  &source: compute着色器的SPIR-V
+   * @param  &setBindings: 每个set的binding类型
+   * @param  pushConstantSize: push constant的字节数，0表示不使用
+   */
+  ComputePipeline(
+      const std::string& source,
+      const std::vector<std::vector<vk::DescriptorType>>& setBindings,
+      uint32_t pushConstantSize);
+  ~ComputePipeline();
+
+ private:
+  void initSetLayouts(
+      const std::vector<std::vector<vk::DescriptorType>>& setBindings);
+  void initPipelineLayout(uint32_t pushConstantSize);
+  void initPipeline();
+};
+
+}  // namespace sktr
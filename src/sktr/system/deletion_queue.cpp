@@ -0,0 +1,41 @@
+#include "deletion_queue.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+void DeletionQueue::Push(Deleter deleter, UploadHandle upload) {
+  entries_.push_back({frame_, upload, std::move(deleter)});
+}
+
+void DeletionQueue::Push(vk::Pipeline pipeline) {
+  Push([pipeline]() {
+    Context::GetInstance().device.destroyPipeline(pipeline);
+  });
+}
+
+void DeletionQueue::Collect(uint64_t completedFrame) {
+  auto& stagingRing = Context::GetInstance().stagingRing;
+  size_t i = 0;
+  while (i < entries_.size() && entries_[i].frame <= completedFrame) {
+    auto& entry = entries_[i];
+    if (entry.upload && !stagingRing->IsComplete(entry.upload)) {
+      i++;
+      continue;
+    }
+    // deleter中可能再加入新的资源，先移出队列
+    auto deleter = std::move(entry.deleter);
+    entries_.erase(entries_.begin() + i);
+    deleter();
+  }
+}
+
+void DeletionQueue::Flush() {
+  while (!entries_.empty()) {
+    auto deleter = std::move(entries_.front().deleter);
+    entries_.pop_front();
+    deleter();
+  }
+}
+
+}  // namespace sktr
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <deque>
+
+#include "sktr/pch.hpp"
+#include "staging_ring.hpp"
+
+namespace sktr {
+
+/*
+ * 延迟销毁GPU资源
+ *
+ * 资源记录加入时正在录制的帧序号，Renderer在等待到这一帧的fence之后调用Collect才销毁，
+ * 同时要等资源的上传批次完成。卸载资源不需要等待GPU空闲
+ */
+class DeletionQueue final {
+ public:
+  using Deleter = std::function<void()>;
+
+  DeletionQueue() = default;
+  // 之前需要等待GPU空闲
+  ~DeletionQueue() { Flush(); }
+
+  DeletionQueue(const DeletionQueue&) = delete;
+  DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+  /**
+   * @brief  当前帧和upload都执行完之后调用deleter
+   * @param  deleter: 销毁资源，如释放描述符集
+   * @param  upload: 资源最后一次上传的批次
+   */
+  void Push(Deleter deleter, UploadHandle upload = {});
+  // 接管Buffer、ImageResource、Material等，为空时什么都不做
+  template <typename T>
+  void Push(std::unique_ptr<T> resource, UploadHandle upload = {}) {
+    if (!resource) {
+      return;
+    }
+    auto raw = resource.release();
+    Push([raw]() { delete raw; }, upload);
+  }
+  void Push(vk::Pipeline pipeline);
+
+  // 序号不超过completedFrame的帧都已经执行完
+  void Collect(uint64_t completedFrame);
+  // 提交一帧之后调用
+  void EndFrame() { frame_++; }
+  // 正在录制的帧的序号，从1开始
+  uint64_t Frame() const { return frame_; }
+  // 立即销毁所有资源，调用前需要等待GPU空闲
+  void Flush();
+
+  size_t PendingCount() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    uint64_t frame;
+    UploadHandle upload;
+    Deleter deleter;
+  };
+
+  uint64_t frame_ = 1;
+  // 按frame从小到大排列
+  std::deque<Entry> entries_;
+};
+
+}  // namespace sktr
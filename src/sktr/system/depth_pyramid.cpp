@@ -0,0 +1,163 @@
+#include "depth_pyramid.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+static uint32_t previousPow2(uint32_t value) {
+  uint32_t result = 1;
+  while (result * 2 <= value) {
+    result *= 2;
+  }
+  return result;
+}
+
+DepthPyramid::DepthPyramid(vk::Extent2D depthExtent, vk::ImageView depthView)
+    : depthExtent_(depthExtent) {
+  // 第0层比深度附件小，一个texel最多覆盖3x3个深度
+  extent_ = {previousPow2(depthExtent.width),
+             previousPow2(depthExtent.height)};
+  levelCount_ = 1;
+  while ((std::max(extent_.width, extent_.height) >> levelCount_) > 0) {
+    levelCount_++;
+  }
+  image_.reset(new ImageResource{ImageResource::CreateColorResource(
+      extent_.width, extent_.height, levelCount_, vk::SampleCountFlagBits::e1,
+      vk::Format::eR32Sfloat, vk::ImageTiling::eOptimal,
+      vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
+      MemoryUsage::eGpuOnly)});
+  createLevelViews();
+  createSampler();
+  updateDescriptorSets(depthView);
+}
+
+DepthPyramid::~DepthPyramid() {
+  auto& device = Context::GetInstance().device;
+  for (const auto& set : sets_) {
+    DescriptorSetManager::GetInstance().FreeComputeImageSet(set);
+  }
+  for (auto view : levelViews_) {
+    device.destroyImageView(view);
+  }
+  device.destroySampler(sampler_);
+}
+
+void DepthPyramid::createLevelViews() {
+  for (uint32_t level = 0; level < levelCount_; level++) {
+    vk::ImageSubresourceRange range;
+    range.setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1)
+        .setBaseMipLevel(level)
+        .setLevelCount(1);
+    vk::ImageViewCreateInfo viewInfo;
+    viewInfo.setImage(image_->image)
+        .setViewType(vk::ImageViewType::e2D)
+        .setFormat(vk::Format::eR32Sfloat)
+        .setSubresourceRange(range);
+    levelViews_.push_back(
+        Context::GetInstance().device.createImageView(viewInfo));
+  }
+}
+
+void DepthPyramid::createSampler() {
+  // 只用texelFetch，不过滤
+  vk::SamplerCreateInfo createInfo;
+  createInfo.setMagFilter(vk::Filter::eNearest)
+      .setMinFilter(vk::Filter::eNearest)
+      .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+      .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+      .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+      .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+      .setMinLod(0.0f)
+      .setMaxLod(static_cast<float>(levelCount_));
+  sampler_ = Context::GetInstance().device.createSampler(createInfo);
+}
+
+void DepthPyramid::updateDescriptorSets(vk::ImageView depthView) {
+  auto& pipeline = *Context::GetInstance().renderProcess->depthReducePipeline;
+  vk::DescriptorImageInfo depthInfo;
+  depthInfo.setImageView(depthView)
+      .setSampler(sampler_)
+      .setImageLayout(vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+  for (uint32_t level = 0; level < levelCount_; level++) {
+    sets_.push_back(DescriptorSetManager::GetInstance().AllocComputeImageSet(
+        pipeline.setLayouts[0]));
+    // 第0层不读取上一层，随便绑定一个有效的view
+    vk::DescriptorImageInfo srcInfo;
+    srcInfo.setImageView(levelViews_[level == 0 ? 0 : level - 1])
+        .setImageLayout(vk::ImageLayout::eGeneral);
+    vk::DescriptorImageInfo dstInfo;
+    dstInfo.setImageView(levelViews_[level])
+        .setImageLayout(vk::ImageLayout::eGeneral);
+
+    std::array<vk::WriteDescriptorSet, 3> writeInfos;
+    writeInfos[0]
+        .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+        .setImageInfo(depthInfo);
+    writeInfos[1]
+        .setDescriptorType(vk::DescriptorType::eStorageImage)
+        .setImageInfo(srcInfo);
+    writeInfos[2]
+        .setDescriptorType(vk::DescriptorType::eStorageImage)
+        .setImageInfo(dstInfo);
+    for (uint32_t i = 0; i < writeInfos.size(); i++) {
+      writeInfos[i]
+          .setDstBinding(i)
+          .setDstSet(sets_.back().set)
+          .setDstArrayElement(0)
+          .setDescriptorCount(1);
+    }
+    Context::GetInstance().device.updateDescriptorSets(writeInfos, {});
+  }
+}
+
+void DepthPyramid::Build(vk::CommandBuffer cmdBuff) {
+  auto& ctx = Context::GetInstance();
+  auto& pipeline = *ctx.renderProcess->depthReducePipeline;
+
+  vk::ImageMemoryBarrier barrier;
+  barrier.setImage(image_->image)
+      .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+      .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+      .setOldLayout(initialized_ ? vk::ImageLayout::eGeneral
+                                 : vk::ImageLayout::eUndefined)
+      .setNewLayout(vk::ImageLayout::eGeneral)
+      .setSrcAccessMask(vk::AccessFlagBits::eShaderRead)
+      .setDstAccessMask(vk::AccessFlagBits::eShaderWrite)
+      .setSubresourceRange({vk::ImageAspectFlagBits::eColor, 0, levelCount_,
+                            0, 1});
+  cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                          vk::PipelineStageFlagBits::eComputeShader, {}, {},
+                          {}, barrier);
+  initialized_ = true;
+
+  cmdBuff.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.pipeline);
+  DepthReducePushConstants pushConstants{};
+  pushConstants.sampleCount = static_cast<uint32_t>(ctx.sampler.msaaSamples);
+  vk::Extent2D src = depthExtent_;
+  for (uint32_t level = 0; level < levelCount_; level++) {
+    vk::Extent2D dst{std::max(extent_.width >> level, 1u),
+                     std::max(extent_.height >> level, 1u)};
+    pushConstants.srcSize = {src.width, src.height};
+    pushConstants.dstSize = {dst.width, dst.height};
+    pushConstants.level = level;
+    cmdBuff.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                               pipeline.layout, 0, sets_[level].set, {});
+    cmdBuff.pushConstants(pipeline.layout, vk::ShaderStageFlagBits::eCompute,
+                          0, sizeof(pushConstants), &pushConstants);
+    cmdBuff.dispatch((dst.width + 7) / 8, (dst.height + 7) / 8, 1);
+
+    // 下一层和之后的遮挡测试读取这一层
+    barrier.setOldLayout(vk::ImageLayout::eGeneral)
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+        .setSubresourceRange({vk::ImageAspectFlagBits::eColor, level, 1, 0, 1});
+    cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                            vk::PipelineStageFlagBits::eComputeShader, {}, {},
+                            {}, barrier);
+    src = dst;
+  }
+}
+
+}  // namespace sktr
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "descriptor_manager.hpp"
+#include "sktr/core/texture.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 遮挡剔除用的深度金字塔(HiZ)
+ *
+ * 第0层是深度附件的大小向下取2的幂，之后每层减半到1x1，
+ * 每个texel是覆盖区域中最远的深度。图像一直是General布局，
+ * 由RenderProcess::depthReducePipeline逐层生成。
+ * 深度附件重新创建后要重新创建金字塔
+ */
+class DepthPyramid final {
+ public:
+  DepthPyramid(vk::Extent2D depthExtent, vk::ImageView depthView);
+  ~DepthPyramid();
+
+  DepthPyramid(const DepthPyramid&) = delete;
+  DepthPyramid& operator=(const DepthPyramid&) = delete;
+
+  /**
+   * @brief  从深度附件生成所有层
+   * @note   在render pass之外录制，深度附件是DepthStencilReadOnlyOptimal。
+   *         之前对金字塔的读取完成后才开始写入，结束时可以被compute读取
+   */
+  void Build(vk::CommandBuffer cmdBuff);
+
+  // 包含所有层，texelFetch读取
+  vk::ImageView View() const { return image_->view; }
+  vk::Sampler Sampler() const { return sampler_; }
+  // 第0层的大小
+  vk::Extent2D Extent() const { return extent_; }
+  uint32_t LevelCount() const { return levelCount_; }
+
+ private:
+  std::unique_ptr<ImageResource> image_;
+  // 每层一个view和一个set，第i层读取第i-1层
+  std::vector<vk::ImageView> levelViews_;
+  std::vector<DescriptorSetManager::SetInfo> sets_;
+  vk::Sampler sampler_;
+  vk::Extent2D depthExtent_;
+  vk::Extent2D extent_;
+  uint32_t levelCount_;
+  // 第一次Build之前是Undefined布局
+  bool initialized_ = false;
+
+  void createLevelViews();
+  void createSampler();
+  void updateDescriptorSets(vk::ImageView depthView);
+};
+
+}  // namespace sktr
@@ -4,6 +4,12 @@
 
 namespace sktr {
 
+// 按需增长的pool每个能分配的set数
+static constexpr uint32_t GrowableSetsPerPool = 16;
+static constexpr uint32_t StorageBindingsPerSet = 4;
+// 深度金字塔和遮挡剔除的set，每种类型最多的binding数
+static constexpr uint32_t ImageBindingsPerSet = 2;
+
 DescriptorSetManager::DescriptorSetManager(uint32_t maxFlight)
     : maxFlight_(maxFlight) {
   createBufferSetPool();
@@ -20,20 +26,24 @@ DescriptorSetManager::~DescriptorSetManager() {
   for (auto pool : avalibleImageSetPool_) {
     device.destroyDescriptorPool(pool.pool_);
   }
+  for (auto pool : storageSetPools_) {
+    device.destroyDescriptorPool(pool.pool_);
+  }
+  for (auto pool : computeImageSetPools_) {
+    device.destroyDescriptorPool(pool.pool_);
+  }
 }
 
 void DescriptorSetManager::createBufferSetPool() {
   vk::DescriptorPoolSize size;
-  // ×2是因为有world和material两个UniformBuffer
-
-  size.setType(vk::DescriptorType::eUniformBuffer)
-      .setDescriptorCount(maxFlight_ * 2);
+  // 一个world set(VP和light)和一个material set，每帧的数据通过dynamic offset区分
+  size.setType(vk::DescriptorType::eUniformBufferDynamic).setDescriptorCount(3);
   vk::DescriptorPoolCreateInfo descriptorPoolInfo;
-  descriptorPoolInfo.setMaxSets(maxFlight_ * 2).setPoolSizes(size);
+  descriptorPoolInfo.setMaxSets(2).setPoolSizes(size);
   auto pool =
       Context::GetInstance().device.createDescriptorPool(descriptorPoolInfo);
   bufferSetPool_.pool_ = pool;
-  bufferSetPool_.remainNum_ = maxFlight_ * 2;
+  bufferSetPool_.remainNum_ = 2;
 }
 
 void DescriptorSetManager::addImageSetPool() {
@@ -50,43 +60,81 @@ void DescriptorSetManager::addImageSetPool() {
   avalibleImageSetPool_.push_back({pool, maxFlight_});
 }
 
-std::vector<DescriptorSetManager::SetInfo>
-DescriptorSetManager::AllocWorldBufferSets(uint32_t num) {
-  std::vector<vk::DescriptorSetLayout> layouts(
-      maxFlight_, Shader::GetInstance().descriptorSetLayouts[0]);
+void DescriptorSetManager::addGrowablePool(
+    std::vector<PoolInfo>& pools,
+    const std::vector<vk::DescriptorPoolSize>& sizesPerSet) {
+  std::vector<vk::DescriptorPoolSize> sizes = sizesPerSet;
+  for (auto& size : sizes) {
+    size.descriptorCount *= GrowableSetsPerPool;
+  }
+  vk::DescriptorPoolCreateInfo createInfo;
+  createInfo.setMaxSets(GrowableSetsPerPool)
+      .setPoolSizes(sizes)
+      .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+  auto pool = Context::GetInstance().device.createDescriptorPool(createInfo);
+  pools.push_back({pool, GrowableSetsPerPool});
+}
+
+DescriptorSetManager::SetInfo DescriptorSetManager::allocFromPools(
+    std::vector<PoolInfo>& pools,
+    const std::vector<vk::DescriptorPoolSize>& sizesPerSet,
+    vk::DescriptorSetLayout layout) {
+  auto it =
+      std::find_if(pools.begin(), pools.end(), [](const PoolInfo& poolInfo) {
+        return poolInfo.remainNum_ > 0;
+      });
+  if (it == pools.end()) {
+    addGrowablePool(pools, sizesPerSet);
+    it = pools.end() - 1;
+  }
   vk::DescriptorSetAllocateInfo allocInfo;
-  allocInfo.setDescriptorPool(bufferSetPool_.pool_)
-      .setDescriptorSetCount(num)
-      .setSetLayouts(layouts);
+  allocInfo.setDescriptorPool(it->pool_)
+      .setDescriptorSetCount(1)
+      .setSetLayouts(layout);
   auto sets = Context::GetInstance().device.allocateDescriptorSets(allocInfo);
+  it->remainNum_--;
 
-  std::vector<SetInfo> result(num);
+  SetInfo result;
+  result.pool = it->pool_;
+  result.set = sets[0];
+  return result;
+}
 
-  for (int i = 0; i < num; i++) {
-    result[i].set = sets[i];
-    result[i].pool = bufferSetPool_.pool_;
+void DescriptorSetManager::freeToPools(std::vector<PoolInfo>& pools,
+                                       const SetInfo& info) {
+  auto it = std::find_if(
+      pools.begin(), pools.end(),
+      [&](const PoolInfo& poolInfo) { return poolInfo.pool_ == info.pool; });
+  if (it == pools.end()) {
+    return;
   }
-
-  return result;
+  Context::GetInstance().device.freeDescriptorSets(info.pool, info.set);
+  it->remainNum_++;
 }
 
-DescriptorSetManager::SetInfo DescriptorSetManager::AllocMaterialBufferSet() {
-  std::vector<vk::DescriptorSetLayout> layouts(
-      maxFlight_, Shader::GetInstance().descriptorSetLayouts[2]);
+DescriptorSetManager::SetInfo DescriptorSetManager::allocBufferSet(
+    vk::DescriptorSetLayout layout) {
   vk::DescriptorSetAllocateInfo allocInfo;
   allocInfo.setDescriptorPool(bufferSetPool_.pool_)
       .setDescriptorSetCount(1)
-      .setSetLayouts(layouts);
+      .setSetLayouts(layout);
   auto sets = Context::GetInstance().device.allocateDescriptorSets(allocInfo);
+  bufferSetPool_.remainNum_--;
 
   SetInfo result;
-
   result.set = sets[0];
   result.pool = bufferSetPool_.pool_;
-
   return result;
 }
 
+DescriptorSetManager::SetInfo DescriptorSetManager::AllocWorldBufferSet() {
+  return allocBufferSet(Shader::GetInstance().descriptorSetLayouts[0]);
+}
+
+DescriptorSetManager::SetInfo DescriptorSetManager::AllocMaterialBufferSet() {
+  return allocBufferSet(Shader::GetInstance().descriptorSetLayouts[2]);
+}
+
 DescriptorSetManager::SetInfo DescriptorSetManager::AllocImageSet() {
   auto& ctx = Context::GetInstance();
   auto& poolInfo = getAvaliableImagePoolInfo();
@@ -134,6 +182,31 @@ void DescriptorSetManager::FreeImageSet(const SetInfo& info) {
   Context::GetInstance().device.freeDescriptorSets(info.pool, info.set);
 }
 
+DescriptorSetManager::SetInfo DescriptorSetManager::AllocStorageBufferSet(
+    vk::DescriptorSetLayout layout) {
+  return allocFromPools(
+      storageSetPools_,
+      {{vk::DescriptorType::eStorageBuffer, StorageBindingsPerSet}}, layout);
+}
+
+void DescriptorSetManager::FreeStorageBufferSet(const SetInfo& info) {
+  freeToPools(storageSetPools_, info);
+}
+
+DescriptorSetManager::SetInfo DescriptorSetManager::AllocComputeImageSet(
+    vk::DescriptorSetLayout layout) {
+  return allocFromPools(
+      computeImageSetPools_,
+      {{vk::DescriptorType::eCombinedImageSampler, ImageBindingsPerSet},
+       {vk::DescriptorType::eStorageImage, ImageBindingsPerSet},
+       {vk::DescriptorType::eStorageBuffer, ImageBindingsPerSet}},
+      layout);
+}
+
+void DescriptorSetManager::FreeComputeImageSet(const SetInfo& info) {
+  freeToPools(computeImageSetPools_, info);
+}
+
 DescriptorSetManager::PoolInfo&
 DescriptorSetManager::getAvaliableImagePoolInfo() {
   if (avalibleImageSetPool_.empty()) {
@@ -14,13 +14,21 @@ class DescriptorSetManager : public Singlton<DescriptorSetManager> {
   DescriptorSetManager(uint32_t maxFlight);
   ~DescriptorSetManager();
 
-  std::vector<SetInfo> AllocWorldBufferSets(uint32_t num);
+  // world和material各只有一个set，指向Renderer的UniformAllocator，随pool一起销毁
+  SetInfo AllocWorldBufferSet();
   SetInfo AllocMaterialBufferSet();
 
   SetInfo AllocImageSet();
 
   void FreeImageSet(const SetInfo&);
 
+  // 存储缓冲的set，layout由compute管线提供，每个set最多StorageBindingsPerSet个binding
+  SetInfo AllocStorageBufferSet(vk::DescriptorSetLayout layout);
+  void FreeStorageBufferSet(const SetInfo&);
+  // compute管线中带图像的set，采样图像、存储图像和存储缓冲各最多2个binding
+  SetInfo AllocComputeImageSet(vk::DescriptorSetLayout layout);
+  void FreeComputeImageSet(const SetInfo&);
+
  private:
   struct PoolInfo {
     vk::DescriptorPool pool_;
@@ -32,8 +40,19 @@ class DescriptorSetManager : public Singlton<DescriptorSetManager> {
   std::vector<PoolInfo> fulledImageSetPool_;
   std::vector<PoolInfo> avalibleImageSetPool_;
 
+  std::vector<PoolInfo> storageSetPools_;
+  std::vector<PoolInfo> computeImageSetPools_;
+
   void addImageSetPool();
+  // sizesPerSet是一个set需要的各类型描述符数
+  void addGrowablePool(std::vector<PoolInfo>& pools,
+                       const std::vector<vk::DescriptorPoolSize>& sizesPerSet);
+  SetInfo allocFromPools(std::vector<PoolInfo>& pools,
+                         const std::vector<vk::DescriptorPoolSize>& sizesPerSet,
+                         vk::DescriptorSetLayout layout);
+  void freeToPools(std::vector<PoolInfo>& pools, const SetInfo& info);
   void createBufferSetPool();
+  SetInfo allocBufferSet(vk::DescriptorSetLayout layout);
   PoolInfo& getAvaliableImagePoolInfo();
 
   uint32_t maxFlight_;
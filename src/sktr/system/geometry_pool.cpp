@@ -0,0 +1,90 @@
+#include "geometry_pool.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+GeometryPool::GeometryPool(uint32_t vertexCapacity, uint32_t indexCapacity)
+    : vertexCapacity_(vertexCapacity), indexCapacity_(indexCapacity) {}
+
+GeometryPool::Range GeometryPool::AllocateVertices(uint32_t stride,
+                                                   uint32_t count) {
+  return allocate(stride,
+                  vk::BufferUsageFlagBits::eVertexBuffer |
+                      vk::BufferUsageFlagBits::eTransferDst,
+                  vertexCapacity_, count);
+}
+
+GeometryPool::Range GeometryPool::AllocateIndices(vk::IndexType type,
+                                                  uint32_t count) {
+  uint32_t stride =
+      type == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+  return allocate(stride,
+                  vk::BufferUsageFlagBits::eIndexBuffer |
+                      vk::BufferUsageFlagBits::eTransferDst,
+                  indexCapacity_, count);
+}
+
+GeometryPool::Range GeometryPool::allocate(uint32_t stride,
+                                           vk::BufferUsageFlags usage,
+                                           uint32_t capacity, uint32_t count) {
+  Range range;
+  if (count == 0 || count > capacity) {
+    return range;
+  }
+  Pool* pool = nullptr;
+  for (auto& candidate : pools_) {
+    if (candidate->stride == stride && candidate->usage == usage) {
+      pool = candidate.get();
+      break;
+    }
+  }
+  if (!pool) {
+    pools_.emplace_back(new Pool{
+        stride, usage,
+        std::unique_ptr<Buffer>(new Buffer{vk::DeviceSize(capacity) * stride,
+                                           usage, MemoryUsage::eGpuOnly}),
+        BuddyAllocator{capacity, MinElements}});
+    pool = pools_.back().get();
+  }
+  auto first = pool->buddy.Allocate(count);
+  if (!first) {
+    return range;
+  }
+  range.buffer = pool->buffer->buffer;
+  range.first = static_cast<uint32_t>(*first);
+  range.count = count;
+  range.stride = stride;
+  return range;
+}
+
+void GeometryPool::Free(Range& range) {
+  if (!range) {
+    return;
+  }
+  for (auto& pool : pools_) {
+    if (pool->buffer->buffer == range.buffer) {
+      pool->buddy.Free(range.first);
+      break;
+    }
+  }
+  range = Range{};
+}
+
+vk::DeviceSize GeometryPool::UsedBytes() const {
+  vk::DeviceSize bytes = 0;
+  for (const auto& pool : pools_) {
+    bytes += pool->buddy.UsedBytes() * pool->stride;
+  }
+  return bytes;
+}
+
+vk::DeviceSize GeometryPool::CapacityBytes() const {
+  vk::DeviceSize bytes = 0;
+  for (const auto& pool : pools_) {
+    bytes += pool->buddy.Size() * pool->stride;
+  }
+  return bytes;
+}
+
+}  // namespace sktr
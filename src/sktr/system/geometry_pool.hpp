@@ -0,0 +1,68 @@
+#pragma once
+
+#include "buffer.hpp"
+#include "sktr/pch.hpp"
+#include "sktr/utils/buddy_allocator.hpp"
+
+namespace sktr {
+
+/*
+ * 所有模型共享的顶点和索引缓冲
+ *
+ * 每种顶点stride和索引类型各有一个device local的大buffer，第一次使用时创建，
+ * 以元素为单位用伙伴算法分配。模型记录自己的baseVertex和firstIndex，
+ * 绘制时加到vertexOffset和firstIndex上，连续绘制多个模型不需要重新绑定，
+ * 也可以合并成间接绘制。放不下时返回空的Range，由调用方单独创建buffer
+ */
+class GeometryPool final {
+ public:
+  static constexpr uint32_t DefaultVertexCapacity = 1u << 21;
+  static constexpr uint32_t DefaultIndexCapacity = 1u << 23;
+  // 伙伴算法的最小节点，以元素为单位
+  static constexpr uint32_t MinElements = 64;
+
+  // 池中的一段，以元素(顶点或索引)为单位
+  struct Range {
+    vk::Buffer buffer;
+    uint32_t first = 0;
+    uint32_t count = 0;
+    uint32_t stride = 0;
+
+    operator bool() const { return static_cast<bool>(buffer); }
+    vk::DeviceSize ByteOffset() const { return vk::DeviceSize(first) * stride; }
+    vk::DeviceSize ByteSize() const { return vk::DeviceSize(count) * stride; }
+  };
+
+  // 容量以元素为单位，需要是2的幂
+  GeometryPool(uint32_t vertexCapacity = DefaultVertexCapacity,
+               uint32_t indexCapacity = DefaultIndexCapacity);
+
+  GeometryPool(const GeometryPool&) = delete;
+  GeometryPool& operator=(const GeometryPool&) = delete;
+
+  Range AllocateVertices(uint32_t stride, uint32_t count);
+  Range AllocateIndices(vk::IndexType type, uint32_t count);
+  // 需要等使用它的帧和上传都完成，之后range为空
+  void Free(Range& range);
+
+  // 所有池中已分配节点的字节数和总容量
+  vk::DeviceSize UsedBytes() const;
+  vk::DeviceSize CapacityBytes() const;
+
+ private:
+  struct Pool {
+    uint32_t stride;
+    vk::BufferUsageFlags usage;
+    std::unique_ptr<Buffer> buffer;
+    BuddyAllocator buddy;
+  };
+
+  uint32_t vertexCapacity_;
+  uint32_t indexCapacity_;
+  std::vector<std::unique_ptr<Pool>> pools_;
+
+  Range allocate(uint32_t stride, vk::BufferUsageFlags usage,
+                 uint32_t capacity, uint32_t count);
+};
+
+}  // namespace sktr
@@ -0,0 +1,327 @@
+#include "memory_allocator.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+struct MemoryBlock {
+  vk::DeviceMemory memory;
+  uint8_t* mapped = nullptr;
+  BuddyAllocator buddy;
+  uint32_t poolIndex;
+
+  MemoryBlock(vk::DeviceSize size, uint32_t poolIndex)
+      : buddy(size, MemoryAllocator::MinAllocationSize),
+        poolIndex(poolIndex) {}
+};
+
+std::ostream& operator<<(std::ostream& os, const MemoryStats& stats) {
+  auto toMB = [](vk::DeviceSize bytes) { return bytes / (1024.0 * 1024.0); };
+  os << "blocks " << stats.blockCount << ", dedicated "
+     << stats.dedicatedCount << ", allocations " << stats.allocationCount
+     << ", reserved " << toMB(stats.reservedBytes) << " MB, used "
+     << toMB(stats.usedBytes) << " MB, wasted " << toMB(stats.wastedBytes)
+     << " MB, fragmentation " << stats.fragmentation;
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const HeapBudget& budget) {
+  auto toMB = [](vk::DeviceSize bytes) { return bytes / (1024.0 * 1024.0); };
+  os << (budget.deviceLocal ? "device" : "host") << " heap "
+     << toMB(budget.size) << " MB, budget " << toMB(budget.budget)
+     << " MB, usage " << toMB(budget.usage) << " MB, allocated "
+     << toMB(budget.allocated) << " MB, used " << toMB(budget.used) << " MB";
+  return os;
+}
+
+MemoryAllocator::MemoryAllocator()
+    : properties_(Context::GetInstance().memoryProperties),
+      policy_(properties_) {
+  heapAllocated_.resize(properties_.memoryHeapCount, 0);
+  heapUsed_.resize(properties_.memoryHeapCount, 0);
+  overBudget_.resize(properties_.memoryHeapCount, false);
+}
+
+MemoryAllocator::~MemoryAllocator() {
+  auto stats = GetStats();
+  if (stats.allocationCount > 0) {
+    std::cout << "[MemoryAllocator] " << stats.allocationCount
+              << " allocations not freed" << std::endl;
+  }
+  for (auto& pool : pools_) {
+    for (auto& block : pool.blocks) {
+      destroyBlock(*block);
+    }
+  }
+}
+
+MemoryAllocator::Pool& MemoryAllocator::getPool(uint32_t memoryTypeIndex,
+                                                ResourceTiling tiling) {
+  for (auto& pool : pools_) {
+    if (pool.memoryTypeIndex == memoryTypeIndex && pool.tiling == tiling) {
+      return pool;
+    }
+  }
+  Pool pool;
+  pool.memoryTypeIndex = memoryTypeIndex;
+  pool.tiling = tiling;
+  pool.hostVisible = policy_.IsHostVisible(memoryTypeIndex);
+  pools_.push_back(std::move(pool));
+  return pools_.back();
+}
+
+MemoryBlock& MemoryAllocator::createBlock(Pool& pool) {
+  auto& device = Context::GetInstance().device;
+  auto poolIndex = static_cast<uint32_t>(&pool - pools_.data());
+  std::unique_ptr<MemoryBlock> block(new MemoryBlock{BlockSize, poolIndex});
+  vk::MemoryAllocateInfo allocInfo;
+  allocInfo.setMemoryTypeIndex(pool.memoryTypeIndex)
+      .setAllocationSize(BlockSize);
+  block->memory = device.allocateMemory(allocInfo);
+  if (pool.hostVisible) {
+    block->mapped =
+        static_cast<uint8_t*>(device.mapMemory(block->memory, 0, BlockSize));
+  }
+  heapAllocated_[heapOf(pool.memoryTypeIndex)] += BlockSize;
+  pool.blocks.push_back(std::move(block));
+  return *pool.blocks.back();
+}
+
+void MemoryAllocator::destroyBlock(MemoryBlock& block) {
+  auto& device = Context::GetInstance().device;
+  if (block.mapped) {
+    device.unmapMemory(block.memory);
+  }
+  device.freeMemory(block.memory);
+}
+
+MemoryAllocation MemoryAllocator::allocateDedicated(vk::DeviceSize size,
+                                                    uint32_t memoryTypeIndex,
+                                                    bool hostVisible) {
+  auto& device = Context::GetInstance().device;
+  MemoryAllocation allocation;
+  vk::MemoryAllocateInfo allocInfo;
+  allocInfo.setMemoryTypeIndex(memoryTypeIndex).setAllocationSize(size);
+  allocation.memory = device.allocateMemory(allocInfo);
+  allocation.size = size;
+  allocation.memoryTypeIndex = memoryTypeIndex;
+  if (hostVisible) {
+    allocation.mapped = device.mapMemory(allocation.memory, 0, size);
+  }
+  dedicatedCount_++;
+  dedicatedBytes_ += size;
+  heapAllocated_[heapOf(memoryTypeIndex)] += size;
+  heapUsed_[heapOf(memoryTypeIndex)] += size;
+  return allocation;
+}
+
+MemoryAllocation MemoryAllocator::Allocate(
+    const vk::MemoryRequirements& requirements, MemoryUsage usage,
+    ResourceTiling tiling) {
+  auto memoryTypeIndex = policy_.Find(requirements.memoryTypeBits, usage);
+  MemoryAllocation allocation;
+  // 向驱动申请了新的内存
+  bool grew = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Pool& pool = getPool(memoryTypeIndex, tiling);
+    if (requirements.size > BlockSize / 2) {
+      allocation = allocateDedicated(requirements.size, memoryTypeIndex,
+                                     pool.hostVisible);
+    } else {
+      MemoryBlock* block = nullptr;
+      std::optional<uint64_t> offset;
+      for (auto& candidate : pool.blocks) {
+        offset = candidate->buddy.Allocate(requirements.size,
+                                           requirements.alignment);
+        if (offset) {
+          block = candidate.get();
+          grew = false;
+          break;
+        }
+      }
+      if (!block) {
+        block = &createBlock(pool);
+        offset =
+            block->buddy.Allocate(requirements.size, requirements.alignment);
+      }
+
+      allocation.memory = block->memory;
+      allocation.offset = offset.value();
+      allocation.size = requirements.size;
+      allocation.mapped = block->mapped ? block->mapped + *offset : nullptr;
+      allocation.block = block;
+      allocation.memoryTypeIndex = memoryTypeIndex;
+      usedBytes_ += requirements.size;
+      heapUsed_[heapOf(memoryTypeIndex)] += requirements.size;
+    }
+  }
+  // 回调中可能释放资源，不能持有锁
+  if (grew) {
+    CheckBudget();
+  }
+  return allocation;
+}
+
+MemoryAllocation MemoryAllocator::AllocateForBuffer(vk::Buffer buffer,
+                                                    MemoryUsage usage) {
+  auto& device = Context::GetInstance().device;
+  auto allocation = Allocate(device.getBufferMemoryRequirements(buffer), usage,
+                             ResourceTiling::eLinear);
+  device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+  return allocation;
+}
+
+MemoryAllocation MemoryAllocator::AllocateForImage(vk::Image image,
+                                                   MemoryUsage usage,
+                                                   ResourceTiling tiling) {
+  auto& device = Context::GetInstance().device;
+  auto allocation =
+      Allocate(device.getImageMemoryRequirements(image), usage, tiling);
+  device.bindImageMemory(image, allocation.memory, allocation.offset);
+  return allocation;
+}
+
+void MemoryAllocator::Free(MemoryAllocation& allocation) {
+  if (!allocation) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto heapIndex = heapOf(allocation.memoryTypeIndex);
+  heapUsed_[heapIndex] -= allocation.size;
+  if (!allocation.block) {
+    auto& device = Context::GetInstance().device;
+    if (allocation.mapped) {
+      device.unmapMemory(allocation.memory);
+    }
+    device.freeMemory(allocation.memory);
+    dedicatedCount_--;
+    dedicatedBytes_ -= allocation.size;
+    heapAllocated_[heapIndex] -= allocation.size;
+    allocation = MemoryAllocation{};
+    return;
+  }
+
+  MemoryBlock* block = allocation.block;
+  block->buddy.Free(allocation.offset);
+  usedBytes_ -= allocation.size;
+  allocation = MemoryAllocation{};
+  if (!block->buddy.Empty()) {
+    return;
+  }
+  // 每组最多保留一个空块，避免反复申请释放
+  auto& blocks = pools_[block->poolIndex].blocks;
+  auto emptyCount = std::count_if(
+      blocks.begin(), blocks.end(),
+      [](const std::unique_ptr<MemoryBlock>& b) { return b->buddy.Empty(); });
+  if (emptyCount > 1) {
+    heapAllocated_[heapIndex] -= BlockSize;
+    destroyBlock(*block);
+    blocks.erase(std::find_if(blocks.begin(), blocks.end(),
+                              [&](const std::unique_ptr<MemoryBlock>& b) {
+                                return b.get() == block;
+                              }));
+  }
+}
+
+MemoryStats MemoryAllocator::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  MemoryStats stats;
+  vk::DeviceSize nodeBytes = 0;
+  vk::DeviceSize freeBytes = 0;
+  vk::DeviceSize largestFree = 0;
+  for (const auto& pool : pools_) {
+    for (const auto& block : pool.blocks) {
+      stats.blockCount++;
+      stats.allocationCount += block->buddy.AllocationCount();
+      stats.reservedBytes += block->buddy.Size();
+      nodeBytes += block->buddy.UsedBytes();
+      freeBytes += block->buddy.FreeBytes();
+      largestFree += block->buddy.LargestFreeNode();
+    }
+  }
+  stats.dedicatedCount = dedicatedCount_;
+  stats.allocationCount += dedicatedCount_;
+  stats.reservedBytes += dedicatedBytes_;
+  stats.usedBytes = usedBytes_ + dedicatedBytes_;
+  stats.wastedBytes = nodeBytes - usedBytes_;
+  stats.fragmentation =
+      freeBytes > 0 ? 1.0f - static_cast<float>(largestFree) / freeBytes
+                    : 0.0f;
+  return stats;
+}
+
+std::vector<HeapBudget> MemoryAllocator::GetHeapBudgets() const {
+  auto& ctx = Context::GetInstance();
+  vk::PhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties;
+  vk::PhysicalDeviceMemoryProperties2 properties2;
+  if (ctx.memoryBudgetEnabled) {
+    properties2.setPNext(&budgetProperties);
+    ctx.phyDevice.getMemoryProperties2(&properties2);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<HeapBudget> budgets(properties_.memoryHeapCount);
+  for (uint32_t i = 0; i < properties_.memoryHeapCount; i++) {
+    auto& budget = budgets[i];
+    const auto& heap = properties_.memoryHeaps[i];
+    budget.size = heap.size;
+    budget.deviceLocal = static_cast<bool>(
+        heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+    budget.allocated = heapAllocated_[i];
+    budget.used = heapUsed_[i];
+    if (ctx.memoryBudgetEnabled) {
+      budget.budget = budgetProperties.heapBudget[i];
+      budget.usage = budgetProperties.heapUsage[i];
+    } else {
+      budget.budget =
+          static_cast<vk::DeviceSize>(heap.size * DefaultBudgetFraction);
+      budget.usage = heapAllocated_[i];
+    }
+  }
+  return budgets;
+}
+
+uint32_t MemoryAllocator::AddBudgetCallback(BudgetCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto id = nextCallbackId_++;
+  callbacks_.emplace_back(id, std::move(callback));
+  return id;
+}
+
+void MemoryAllocator::RemoveBudgetCallback(uint32_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  callbacks_.erase(
+      std::remove_if(callbacks_.begin(), callbacks_.end(),
+                     [=](const auto& entry) { return entry.first == id; }),
+      callbacks_.end());
+}
+
+void MemoryAllocator::CheckBudget() {
+  auto budgets = GetHeapBudgets();
+  std::vector<uint32_t> exceeded;
+  std::vector<BudgetCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t i = 0; i < budgets.size(); i++) {
+      bool over = budgets[i].usage > budgets[i].budget * softBudget_;
+      if (over && !overBudget_[i]) {
+        exceeded.push_back(i);
+      }
+      overBudget_[i] = over;
+    }
+    if (exceeded.empty()) {
+      return;
+    }
+    for (const auto& entry : callbacks_) {
+      callbacks.push_back(entry.second);
+    }
+  }
+  for (auto heapIndex : exceeded) {
+    for (const auto& callback : callbacks) {
+      callback(heapIndex, budgets[heapIndex]);
+    }
+  }
+}
+
+}  // namespace sktr
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <mutex>
+
+#include "memory_policy.hpp"
+#include "sktr/pch.hpp"
+#include "sktr/utils/buddy_allocator.hpp"
+
+namespace sktr {
+
+// 资源在内存中的排布，linear和optimal不能放在同一个块里，避免bufferImageGranularity冲突
+enum class ResourceTiling {
+  // buffer和linear tiling的image
+  eLinear,
+  // optimal tiling的image
+  eOptimal,
+};
+
+struct MemoryBlock;
+
+// 从MemoryAllocator得到的一段设备内存
+struct MemoryAllocation {
+  vk::DeviceMemory memory;
+  vk::DeviceSize offset = 0;
+  vk::DeviceSize size = 0;
+  // host visible时指向offset处，整个块只映射一次
+  void* mapped = nullptr;
+  // 独占分配时为空
+  MemoryBlock* block = nullptr;
+  uint32_t memoryTypeIndex = 0;
+
+  operator bool() const { return static_cast<bool>(memory); }
+};
+
+struct MemoryStats {
+  uint32_t blockCount = 0;
+  uint32_t dedicatedCount = 0;
+  uint32_t allocationCount = 0;
+  // 向驱动申请的内存，即所有块和独占分配的大小之和
+  vk::DeviceSize reservedBytes = 0;
+  // 资源实际需要的大小之和
+  vk::DeviceSize usedBytes = 0;
+  // 取整到2的幂多占用的部分
+  vk::DeviceSize wastedBytes = 0;
+  // 1 - 各块最大空闲节点之和 / 空闲总量，空闲空间越零碎越接近1
+  float fragmentation = 0.0f;
+};
+
+std::ostream& operator<<(std::ostream& os, const MemoryStats& stats);
+
+// 一个内存堆的预算和使用量
+struct HeapBudget {
+  vk::DeviceSize size = 0;
+  // 驱动给出的预算，没有VK_EXT_memory_budget时为堆大小乘DefaultBudgetFraction
+  vk::DeviceSize budget = 0;
+  // 驱动统计的整个进程的使用量，没有扩展时等于allocated
+  vk::DeviceSize usage = 0;
+  // 通过MemoryAllocator向驱动申请的，即块和独占分配
+  vk::DeviceSize allocated = 0;
+  // 其中资源实际需要的
+  vk::DeviceSize used = 0;
+  bool deviceLocal = false;
+};
+
+std::ostream& operator<<(std::ostream& os, const HeapBudget& budget);
+
+/*
+ * 设备内存的块分配器
+ *
+ * 每个内存类型和ResourceTiling各有一组BlockSize大小的块，块内用伙伴算法分配。
+ * 超过BlockSize一半的资源单独申请(独占分配)。
+ * host visible的块在创建时映射，分配直接得到映射地址
+ */
+class MemoryAllocator final {
+ public:
+  static constexpr vk::DeviceSize BlockSize = 64ull << 20;
+  static constexpr vk::DeviceSize MinAllocationSize = 256;
+  // 没有VK_EXT_memory_budget时假定可以使用堆大小的这个比例
+  static constexpr float DefaultBudgetFraction = 0.8f;
+
+  using BudgetCallback =
+      std::function<void(uint32_t heapIndex, const HeapBudget& budget)>;
+
+  MemoryAllocator();
+  ~MemoryAllocator();
+
+  MemoryAllocator(const MemoryAllocator&) = delete;
+  MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+  /**
+   * @brief  按内存需求分配
+   * @note   内存类型由MemoryTypePolicy按用途选择，失败时抛出异常
+   * @param  requirements: getBufferMemoryRequirements等的结果
+   * @param  usage: 资源的用途
+   * @param  tiling: 决定放在哪一组块中
+   */
+  MemoryAllocation Allocate(const vk::MemoryRequirements& requirements,
+                            MemoryUsage usage, ResourceTiling tiling);
+  // 分配并绑定到buffer
+  MemoryAllocation AllocateForBuffer(vk::Buffer buffer, MemoryUsage usage);
+  // 分配并绑定到image
+  MemoryAllocation AllocateForImage(vk::Image image, MemoryUsage usage,
+                                    ResourceTiling tiling);
+  void Free(MemoryAllocation& allocation);
+
+  MemoryStats GetStats() const;
+  const MemoryTypePolicy& Policy() const { return policy_; }
+
+  // 按heap下标排列
+  std::vector<HeapBudget> GetHeapBudgets() const;
+  /**
+   * @brief  某个堆的usage超过budget * softBudget时调用
+   * @note   向驱动申请新内存之后和CheckBudget时检查。超过时只通知一次，
+   *         降到软预算以下后重新生效。回调中可以释放资源
+   * @return 用于RemoveBudgetCallback
+   */
+  uint32_t AddBudgetCallback(BudgetCallback callback);
+  void RemoveBudgetCallback(uint32_t id);
+  // 默认0.9
+  void SetSoftBudget(float fraction) { softBudget_ = fraction; }
+  // 其他进程也会占用预算，streaming系统可以每帧调用
+  void CheckBudget();
+
+ private:
+  struct Pool {
+    uint32_t memoryTypeIndex;
+    ResourceTiling tiling;
+    bool hostVisible;
+    std::vector<std::unique_ptr<MemoryBlock>> blocks;
+  };
+
+  mutable std::mutex mutex_;
+  std::vector<Pool> pools_;
+  uint32_t dedicatedCount_ = 0;
+  vk::DeviceSize dedicatedBytes_ = 0;
+  vk::DeviceSize usedBytes_ = 0;
+
+  vk::PhysicalDeviceMemoryProperties properties_;
+  MemoryTypePolicy policy_;
+  // 按heap统计的allocated和used
+  std::vector<vk::DeviceSize> heapAllocated_;
+  std::vector<vk::DeviceSize> heapUsed_;
+  // 已经通知过超出软预算的堆
+  std::vector<bool> overBudget_;
+  float softBudget_ = 0.9f;
+  std::vector<std::pair<uint32_t, BudgetCallback>> callbacks_;
+  uint32_t nextCallbackId_ = 1;
+
+  uint32_t heapOf(uint32_t memoryTypeIndex) const {
+    return properties_.memoryTypes[memoryTypeIndex].heapIndex;
+  }
+
+  Pool& getPool(uint32_t memoryTypeIndex, ResourceTiling tiling);
+  MemoryAllocation allocateDedicated(vk::DeviceSize size,
+                                     uint32_t memoryTypeIndex,
+                                     bool hostVisible);
+  MemoryBlock& createBlock(Pool& pool);
+  void destroyBlock(MemoryBlock& block);
+};
+
+}  // namespace sktr
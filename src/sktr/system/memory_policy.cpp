@@ -0,0 +1,94 @@
+#include "memory_policy.hpp"
+
+namespace sktr {
+
+const char* ToString(MemoryUsage usage) {
+  switch (usage) {
+    case MemoryUsage::eGpuOnly:
+      return "gpu only";
+    case MemoryUsage::eCpuToGpu:
+      return "cpu to gpu";
+    case MemoryUsage::eGpuToCpu:
+      return "gpu to cpu";
+    case MemoryUsage::eStaging:
+      return "staging";
+    case MemoryUsage::eTransient:
+      return "transient";
+  }
+  return "unknown";
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryUsageReport& report) {
+  os << ToString(report.usage) << ": type " << report.memoryTypeIndex
+     << ", heap " << report.heapIndex << ", "
+     << vk::to_string(report.flags);
+  if (report.rank > 0) {
+    os << " (fallback " << report.rank << ")";
+  }
+  return os;
+}
+
+std::vector<MemoryTypePolicy::Candidate> MemoryTypePolicy::candidates(
+    MemoryUsage usage) {
+  using Flag = vk::MemoryPropertyFlagBits;
+  const vk::MemoryPropertyFlags host = Flag::eHostVisible | Flag::eHostCoherent;
+  switch (usage) {
+    case MemoryUsage::eGpuOnly:
+      // 集成显卡上所有内存都是host visible，最后不做限制
+      return {{Flag::eDeviceLocal, Flag::eHostVisible},
+              {Flag::eDeviceLocal, {}},
+              {{}, {}}};
+    case MemoryUsage::eCpuToGpu:
+      // ReBAR直接写显存，不需要staging
+      return {{Flag::eDeviceLocal | host, {}}, {host, {}}};
+    case MemoryUsage::eGpuToCpu:
+      // 读取非cached的内存非常慢
+      return {{host | Flag::eHostCached, {}}, {host, {}}};
+    case MemoryUsage::eStaging:
+      // 不占用ReBAR的显存
+      return {{host, Flag::eDeviceLocal}, {host, {}}};
+    case MemoryUsage::eTransient:
+      // tile-based GPU上不分配实际内存
+      return {{Flag::eDeviceLocal | Flag::eLazilyAllocated, {}},
+              {Flag::eDeviceLocal, {}}};
+  }
+  return {{{}, {}}};
+}
+
+uint32_t MemoryTypePolicy::Find(uint32_t memoryTypeBits, MemoryUsage usage,
+                                uint32_t* rank) const {
+  auto list = candidates(usage);
+  for (uint32_t c = 0; c < list.size(); c++) {
+    for (uint32_t i = 0; i < properties_.memoryTypeCount; i++) {
+      auto flags = properties_.memoryTypes[i].propertyFlags;
+      if ((1u << i) & memoryTypeBits &&
+          (flags & list[c].required) == list[c].required &&
+          !(flags & list[c].avoided)) {
+        if (rank) {
+          *rank = c;
+        }
+        return i;
+      }
+    }
+  }
+  throw std::runtime_error(std::string("failed to find memory type for ") +
+                           ToString(usage));
+}
+
+std::vector<MemoryUsageReport> MemoryTypePolicy::Report() const {
+  std::vector<MemoryUsageReport> reports;
+  for (auto usage :
+       {MemoryUsage::eGpuOnly, MemoryUsage::eCpuToGpu, MemoryUsage::eGpuToCpu,
+        MemoryUsage::eStaging, MemoryUsage::eTransient}) {
+    MemoryUsageReport report;
+    report.usage = usage;
+    report.memoryTypeIndex = Find(~0u, usage, &report.rank);
+    const auto& type = properties_.memoryTypes[report.memoryTypeIndex];
+    report.heapIndex = type.heapIndex;
+    report.flags = type.propertyFlags;
+    reports.push_back(report);
+  }
+  return reports;
+}
+
+}  // namespace sktr
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+// 资源的用途，决定放在哪种内存中
+enum class MemoryUsage {
+  // 只有GPU访问，如顶点、索引、贴图
+  eGpuOnly,
+  // CPU每帧写入、GPU读取，如uniform
+  eCpuToGpu,
+  // GPU写入、CPU读回
+  eGpuToCpu,
+  // CPU写入后拷贝到其他资源
+  eStaging,
+  // 只在一个render pass内使用的附件
+  eTransient,
+};
+
+const char* ToString(MemoryUsage usage);
+
+// 一种用途最终选择的内存类型
+struct MemoryUsageReport {
+  MemoryUsage usage;
+  uint32_t memoryTypeIndex;
+  uint32_t heapIndex;
+  vk::MemoryPropertyFlags flags;
+  // 在候选列表中的位置，0为首选
+  uint32_t rank;
+};
+
+std::ostream& operator<<(std::ostream& os, const MemoryUsageReport& report);
+
+/*
+ * 按用途选择内存类型
+ *
+ * 每种用途有按优先级排列的候选，每个候选包含必须的属性和尽量避开的属性。
+ * 例如eCpuToGpu首选device local + host visible(ReBAR)，
+ * 没有时退回普通的host visible；eGpuToCpu首选host cached。
+ * 内存属性在创建时缓存，选择时不再查询驱动
+ */
+class MemoryTypePolicy final {
+ public:
+  explicit MemoryTypePolicy(
+      const vk::PhysicalDeviceMemoryProperties& properties)
+      : properties_(properties) {}
+
+  /**
+   * @brief  在memoryTypeBits允许的类型中选择最合适的
+   * @note   没有满足最后一个候选的类型时抛出异常
+   * @param  memoryTypeBits: 资源的memory requirements
+   * @param  rank: 不为空时写入使用的候选位置
+   */
+  uint32_t Find(uint32_t memoryTypeBits, MemoryUsage usage,
+                uint32_t* rank = nullptr) const;
+  bool IsHostVisible(uint32_t memoryTypeIndex) const {
+    const auto& type = properties_.memoryTypes[memoryTypeIndex];
+    return static_cast<bool>(type.propertyFlags &
+                             vk::MemoryPropertyFlagBits::eHostVisible);
+  }
+
+  // 不考虑资源限制时每种用途的选择结果
+  std::vector<MemoryUsageReport> Report() const;
+
+ private:
+  struct Candidate {
+    vk::MemoryPropertyFlags required;
+    vk::MemoryPropertyFlags avoided;
+  };
+
+  vk::PhysicalDeviceMemoryProperties properties_;
+
+  static std::vector<Candidate> candidates(MemoryUsage usage);
+};
+
+}  // namespace sktr
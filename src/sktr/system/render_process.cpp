@@ -11,19 +11,66 @@ RenderProcess::RenderProcess(int w, int h) {
   initPipelineLayout();
   pipelineCache_ = createPipelineCache();
   initPipeline(w, h);
+  meshletCullPipeline.reset(new ComputePipeline{
+      ReadWholeFile("./shaders/meshlet_cull.spv"),
+      {{vk::DescriptorType::eStorageBuffer},
+       {vk::DescriptorType::eStorageBuffer,
+        vk::DescriptorType::eStorageBuffer}},
+      sizeof(MeshletCullPushConstants)});
+  objectCullPipeline.reset(new ComputePipeline{
+      ReadWholeFile("./shaders/object_cull.spv"),
+      {{vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer},
+       {vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer,
+        vk::DescriptorType::eStorageBuffer}},
+      sizeof(ObjectCullPushConstants)});
+  auto& ctx = Context::GetInstance();
+  if (ctx.occlusionCullingEnabled) {
+    objectOcclusionCullPipeline.reset(new ComputePipeline{
+        ReadWholeFile("./shaders/object_cull_occlusion.spv"),
+        {{vk::DescriptorType::eStorageBuffer,
+          vk::DescriptorType::eStorageBuffer},
+         {vk::DescriptorType::eStorageBuffer,
+          vk::DescriptorType::eStorageBuffer,
+          vk::DescriptorType::eStorageBuffer},
+         {vk::DescriptorType::eCombinedImageSampler,
+          vk::DescriptorType::eStorageBuffer}},
+        sizeof(ObjectCullPushConstants)});
+    // 多重采样的深度要用sampler2DMS读取
+    bool multisampled = ctx.sampler.msaaSamples != vk::SampleCountFlagBits::e1;
+    depthReducePipeline.reset(new ComputePipeline{
+        ReadWholeFile(multisampled ? "./shaders/depth_reduce_ms.spv"
+                                   : "./shaders/depth_reduce.spv"),
+        {{vk::DescriptorType::eCombinedImageSampler,
+          vk::DescriptorType::eStorageImage,
+          vk::DescriptorType::eStorageImage}},
+        sizeof(DepthReducePushConstants)});
+  }
 }
 
 RenderProcess::~RenderProcess() {
   auto& device = Context::GetInstance().device;
+  meshletCullPipeline.reset();
+  objectCullPipeline.reset();
+  objectOcclusionCullPipeline.reset();
+  depthReducePipeline.reset();
   device.destroyPipelineCache(pipelineCache_);
   device.destroyRenderPass(renderPass);
+  if (occlusionEarlyPass) {
+    device.destroyRenderPass(occlusionEarlyPass);
+    device.destroyRenderPass(occlusionLatePass);
+  }
   device.destroyPipelineLayout(pipelineLayout);
   device.destroyPipeline(graphicsPipelineWithLineTopology);
   device.destroyPipeline(graphicsPipelineWithTriangleTopology);
+  device.destroyPipeline(graphicsPipelineWithPackedVertex);
+  device.destroyPipeline(graphicsPipelineInstanced);
+  device.destroyPipeline(graphicsPipelineInstancedWithPackedVertex);
 }
 
 vk::Pipeline RenderProcess::createPipeline(int width, int height,
-                                           vk::PrimitiveTopology topology) {
+                                           vk::PrimitiveTopology topology,
+                                           VertexFormat vertexFormat,
+                                           bool instanced) {
   vk::GraphicsPipelineCreateInfo graphicsPipelineInfo;
 
   // dynamic state
@@ -39,10 +86,25 @@ vk::Pipeline RenderProcess::createPipeline(int width, int height,
 
   // 1. vertex input
   vk::PipelineVertexInputStateCreateInfo pipelineVertexInputeStateInfo;
-  auto attribute = Vertex::GetAttributeDescriptions();
-  auto binding = Vertex::GetBindingDescriptions();
-  pipelineVertexInputeStateInfo.setVertexBindingDescriptions(binding)
-      .setVertexAttributeDescriptions(attribute);
+  std::vector<vk::VertexInputBindingDescription> bindings;
+  std::vector<vk::VertexInputAttributeDescription> attributes;
+  if (vertexFormat == VertexFormat::ePacked) {
+    auto packedAttribute = PackedVertex::GetAttributeDescriptions();
+    bindings.push_back(PackedVertex::GetBindingDescriptions());
+    attributes.assign(packedAttribute.begin(), packedAttribute.end());
+  } else {
+    auto attribute = Vertex::GetAttributeDescriptions();
+    bindings.push_back(Vertex::GetBindingDescriptions());
+    attributes.assign(attribute.begin(), attribute.end());
+  }
+  if (instanced) {
+    auto instanceAttribute = InstanceData::GetAttributeDescriptions();
+    bindings.push_back(InstanceData::GetBindingDescriptions());
+    attributes.insert(attributes.end(), instanceAttribute.begin(),
+                      instanceAttribute.end());
+  }
+  pipelineVertexInputeStateInfo.setVertexBindingDescriptions(bindings)
+      .setVertexAttributeDescriptions(attributes);
   graphicsPipelineInfo.setPVertexInputState(&pipelineVertexInputeStateInfo);
 
   // 2. vertex assembly
@@ -61,7 +123,16 @@ vk::Pipeline RenderProcess::createPipeline(int width, int height,
   graphicsPipelineInfo.setPInputAssemblyState(&pipelineInputAssemblyStateInfo);
 
   // 3. shader
-  auto stages = Shader::GetInstance().GetStages();
+  // 实例化的顶点着色器声明了location 4到8，只能和提供它们的pipeline一起用
+  auto stages = Shader::GetInstance().GetStages(instanced);
+  // shader.vert中constant_id = 0，是否需要解码PackedVertex
+  vk::Bool32 packedVertex = vertexFormat == VertexFormat::ePacked;
+  vk::SpecializationMapEntry vertexConstantEntry{0, 0, sizeof(vk::Bool32)};
+  vk::SpecializationInfo vertexSpecialization;
+  vertexSpecialization.setMapEntries(vertexConstantEntry)
+      .setDataSize(sizeof(packedVertex))
+      .setPData(&packedVertex);
+  stages[0].setPSpecializationInfo(&vertexSpecialization);
   graphicsPipelineInfo.setStages(stages);
 
   // 4. viewport
@@ -160,6 +231,15 @@ void RenderProcess::initPipeline(int width, int height) {
       createPipeline(width, height, vk::PrimitiveTopology::eTriangleList);
   graphicsPipelineWithLineTopology =
       createPipeline(width, height, vk::PrimitiveTopology::eLineList);
+  graphicsPipelineWithPackedVertex =
+      createPipeline(width, height, vk::PrimitiveTopology::eTriangleList,
+                     VertexFormat::ePacked);
+  graphicsPipelineInstanced =
+      createPipeline(width, height, vk::PrimitiveTopology::eTriangleList,
+                     VertexFormat::eFull, true);
+  graphicsPipelineInstancedWithPackedVertex =
+      createPipeline(width, height, vk::PrimitiveTopology::eTriangleList,
+                     VertexFormat::ePacked, true);
 }
 
 void RenderProcess::initPipelineLayout() {
@@ -174,7 +254,17 @@ void RenderProcess::initPipelineLayout() {
 }
 
 void RenderProcess::initRenderPass() {
+  renderPass = createRenderPass(PassKind::eSingle);
+  if (Context::GetInstance().occlusionCullingEnabled) {
+    occlusionEarlyPass = createRenderPass(PassKind::eOcclusionEarly);
+    occlusionLatePass = createRenderPass(PassKind::eOcclusionLate);
+  }
+}
+
+vk::RenderPass RenderProcess::createRenderPass(PassKind kind) {
   auto& ctx = Context::GetInstance();
+  const bool early = kind == PassKind::eOcclusionEarly;
+  const bool late = kind == PassKind::eOcclusionLate;
 
   // 纹理附件的描述
 
@@ -183,13 +273,17 @@ void RenderProcess::initRenderPass() {
   colorAttachment
       .setFormat(ctx.swapchain->info.surfaceFormat.format)
       // 初始渲染布局
-      .setInitialLayout(vk::ImageLayout::eUndefined)
+      .setInitialLayout(late ? vk::ImageLayout::eColorAttachmentOptimal
+                             : vk::ImageLayout::eUndefined)
       // 出去的布局
       .setFinalLayout(vk::ImageLayout::eColorAttachmentOptimal)
       // 加载时进行的操作
-      .setLoadOp(vk::AttachmentLoadOp::eClear)
-      // 绘制完成后如何存储
-      .setStoreOp(vk::AttachmentStoreOp::eStore)
+      .setLoadOp(late ? vk::AttachmentLoadOp::eLoad
+                      : vk::AttachmentLoadOp::eClear)
+      // 绘制完成后如何存储，resolve之后不再需要，可以使用transient内存。
+      // 遮挡剔除的early之后还要继续绘制
+      .setStoreOp(early ? vk::AttachmentStoreOp::eStore
+                        : vk::AttachmentStoreOp::eDontCare)
       // 模板缓冲
       .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
       .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
@@ -215,16 +309,20 @@ void RenderProcess::initRenderPass() {
   colorAttachmentResolveRef.setAttachment(2);
   colorAttachmentResolveRef.setLayout(vk::ImageLayout::eColorAttachmentOptimal);
 
-  // depth
+  // depth，遮挡剔除时early保存下来生成深度金字塔，late在此基础上继续测试
   vk::AttachmentDescription depthAttachment{};
   depthAttachment.setFormat(findDepthFormat())
       .setSamples(ctx.sampler.msaaSamples)
-      .setLoadOp(vk::AttachmentLoadOp::eClear)
-      .setStoreOp(vk::AttachmentStoreOp::eDontCare)
+      .setLoadOp(late ? vk::AttachmentLoadOp::eLoad
+                      : vk::AttachmentLoadOp::eClear)
+      .setStoreOp(early ? vk::AttachmentStoreOp::eStore
+                        : vk::AttachmentStoreOp::eDontCare)
       .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
       .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
-      .setInitialLayout(vk::ImageLayout::eUndefined)
-      .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+      .setInitialLayout(late ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                             : vk::ImageLayout::eUndefined)
+      .setFinalLayout(early ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                            : vk::ImageLayout::eDepthStencilAttachmentOptimal);
 
   vk::AttachmentReference depthAttachmentRef{};
   depthAttachmentRef.setAttachment(1);
@@ -261,9 +359,35 @@ void RenderProcess::initRenderPass() {
                        vk::PipelineStageFlagBits::eEarlyFragmentTests)
       .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput |
                        vk::PipelineStageFlagBits::eEarlyFragmentTests);
-  renderPassInfo.setDependencies(dependency);
+  if (late) {
+    // early写入的颜色和深度，以及生成金字塔时对深度的读取
+    dependency
+        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite |
+                          vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead |
+                          vk::AccessFlagBits::eColorAttachmentWrite |
+                          vk::AccessFlagBits::eDepthStencilAttachmentRead |
+                          vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                         vk::PipelineStageFlagBits::eLateFragmentTests |
+                         vk::PipelineStageFlagBits::eComputeShader);
+  }
+  std::vector<vk::SubpassDependency> dependencies = {dependency};
+  if (early) {
+    // 结束后compute读取深度
+    vk::SubpassDependency depthRead;
+    depthRead.setSrcSubpass(0)
+        .setDstSubpass(VK_SUBPASS_EXTERNAL)
+        .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eEarlyFragmentTests |
+                         vk::PipelineStageFlagBits::eLateFragmentTests)
+        .setDstStageMask(vk::PipelineStageFlagBits::eComputeShader);
+    dependencies.push_back(depthRead);
+  }
+  renderPassInfo.setDependencies(dependencies);
 
-  renderPass = Context::GetInstance().device.createRenderPass(renderPassInfo);
+  return Context::GetInstance().device.createRenderPass(renderPassInfo);
 }
 
 vk::PipelineCache RenderProcess::createPipelineCache() {
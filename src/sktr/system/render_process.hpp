@@ -1,16 +1,83 @@
 #pragma once
+#include "compute_pipeline.hpp"
 #include "sktr/pch.hpp"
+#include "sktr/utils/common.hpp"
 namespace sktr {
 
+// meshlet_cull.comp的push constant，平面和相机位置都在模型坐标下
+struct MeshletCullPushConstants {
+  glm::vec4 frustumPlanes[6];
+  glm::vec4 cameraPosition;
+  uint32_t meshletCount;
+  uint32_t commandOffset;
+  uint32_t flags;
+  uint32_t padding;
+};
+constexpr uint32_t MeshletCullFrustum = 1;
+constexpr uint32_t MeshletCullCone = 2;
+
+// object_cull.comp的push constant，平面在世界坐标下
+struct ObjectCullPushConstants {
+  glm::vec4 frustumPlanes[6];
+  uint32_t drawCount;
+  uint32_t flags;
+  // 遮挡剔除的阶段，0: 按上一帧的深度，1: 重新测试被遮挡的对象
+  uint32_t pass;
+  // 第二阶段仍被遮挡的数量写在counts[bucketCount * 2]
+  uint32_t bucketCount;
+};
+// 可见的命令按桶紧凑写入，数量由drawIndexedIndirectCount读取。
+// 否则写在固定位置，不可见的instanceCount为0
+constexpr uint32_t ObjectCullCompact = 1;
+// 用深度金字塔测试遮挡，没有有效的金字塔时不设置
+constexpr uint32_t ObjectCullOcclusion = 2;
+
+// object_cull_occlusion的set 2 binding 1，每帧写入
+struct OcclusionCullParams {
+  // 生成金字塔时的VP，[0]给第一阶段，[1]给第二阶段
+  glm::mat4 viewProj[2];
+  // 金字塔第0层的大小
+  glm::vec2 pyramidSize;
+  uint32_t levelCount;
+  uint32_t padding;
+};
+
+// depth_reduce.comp的push constant
+struct DepthReducePushConstants {
+  // 第0层的源是深度附件，之后是上一层
+  glm::uvec2 srcSize;
+  glm::uvec2 dstSize;
+  uint32_t level;
+  uint32_t sampleCount;
+  uint32_t padding[2];
+};
 class RenderProcess final {
  public:
   // 管线只负责渲染的具体的步骤，不关心要渲染什么
   vk::Pipeline graphicsPipelineWithTriangleTopology;
   vk::Pipeline graphicsPipelineWithLineTopology;
+  // 使用PackedVertex的模型
+  vk::Pipeline graphicsPipelineWithPackedVertex;
+  // DrawModelInstanced使用，binding 1是InstanceData
+  vk::Pipeline graphicsPipelineInstanced;
+  vk::Pipeline graphicsPipelineInstancedWithPackedVertex;
+  // set 0: meshlets; set 1: 绘制命令, 可见数量
+  std::unique_ptr<ComputePipeline> meshletCullPipeline;
+  // set 0: 实例, 绘制项; set 1: 绘制命令, 每个桶的数量, 被遮挡的标记
+  std::unique_ptr<ComputePipeline> objectCullPipeline;
+  // 以下只在Context::occlusionCullingEnabled时创建
+  // 和objectCullPipeline相同，加上set 2: 深度金字塔, OcclusionCullParams
+  std::unique_ptr<ComputePipeline> objectOcclusionCullPipeline;
+  // set 0: 深度附件, 上一层, 这一层
+  std::unique_ptr<ComputePipeline> depthReducePipeline;
 
   // 传递数据（例如Uniform）在shader中的布局
   vk::PipelineLayout pipelineLayout;
   vk::RenderPass renderPass;
+  // GpuScene遮挡剔除的两个阶段，和renderPass兼容，共用framebuffer和pipeline。
+  // early清空并保存颜色和深度，结束时深度可以被compute采样；late加载后继续绘制
+  vk::RenderPass occlusionEarlyPass = nullptr;
+  vk::RenderPass occlusionLatePass = nullptr;
 
   RenderProcess(int w, int h);
   ~RenderProcess();
@@ -20,10 +87,13 @@ class RenderProcess final {
   vk::PipelineCache createPipelineCache();
 
   void initPipeline(int width, int height);
-  vk::Pipeline createPipeline(int width, int height,
-                              vk::PrimitiveTopology topology);
+  vk::Pipeline createPipeline(
+      int width, int height, vk::PrimitiveTopology topology,
+      VertexFormat vertexFormat = VertexFormat::eFull, bool instanced = false);
   void initPipelineLayout();
   void initRenderPass();
+  enum class PassKind { eSingle, eOcclusionEarly, eOcclusionLate };
+  vk::RenderPass createRenderPass(PassKind kind);
 };
 
 }  // namespace sktr
\ No newline at end of file
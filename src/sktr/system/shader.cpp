@@ -1,10 +1,13 @@
 #include "shader.hpp"
 
 #include "sktr/core/context.hpp"
+#include "sktr/mesh/vertex_packing.hpp"
 
 namespace sktr {
 
-Shader::Shader(const std::string &vertexSource, const std::string &fragSource) {
+Shader::Shader(const std::string &vertexSource,
+               const std::string &instancedVertexSource,
+               const std::string &fragSource) {
   vk::ShaderModuleCreateInfo shaderModuleInfo;
   // 读入二进制文件时，一般都是读成char，所以用这种方式而不用↓
   // shaderModuleInfo.setCode()
@@ -13,6 +16,11 @@ Shader::Shader(const std::string &vertexSource, const std::string &fragSource) {
   vertexModule =
       Context::GetInstance().device.createShaderModule(shaderModuleInfo);
 
+  shaderModuleInfo.codeSize = instancedVertexSource.size();
+  shaderModuleInfo.pCode = (uint32_t *)instancedVertexSource.data();
+  instancedVertexModule =
+      Context::GetInstance().device.createShaderModule(shaderModuleInfo);
+
   shaderModuleInfo.codeSize = fragSource.size();
   shaderModuleInfo.pCode = (uint32_t *)fragSource.data();
   fragmentModule =
@@ -28,11 +36,17 @@ Shader::~Shader() {
     device.destroyDescriptorSetLayout(layout);
   }
   device.destroyShaderModule(vertexModule);
+  device.destroyShaderModule(instancedVertexModule);
   device.destroyShaderModule(fragmentModule);
 }
 
-std::vector<vk::PipelineShaderStageCreateInfo> Shader::GetStages() {
-  return stages_;
+std::vector<vk::PipelineShaderStageCreateInfo> Shader::GetStages(
+    bool instanced) {
+  auto stages = stages_;
+  if (instanced) {
+    stages[0].setModule(instancedVertexModule);
+  }
+  return stages;
 }
 
 void Shader::initStage() {
@@ -55,15 +69,16 @@ void Shader::initDescriptorSetLayouts() {
 
   auto &device = Context::GetInstance().device;
   // world: include 0: view, projection; 1: light
+  // uniform都在Renderer的UniformAllocator中，绑定时用dynamic offset选择
   vk::DescriptorSetLayoutBinding uboLayoutBinding;
   uboLayoutBinding.setBinding(0)
       .setDescriptorCount(1)
-      .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+      .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
       .setStageFlags(vk::ShaderStageFlagBits::eVertex);
   vk::DescriptorSetLayoutBinding lightBinding;
   lightBinding.setBinding(1)
       .setDescriptorCount(1)
-      .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+      .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
       .setStageFlags(vk::ShaderStageFlagBits::eFragment);
   vk::DescriptorSetLayoutCreateInfo worldSetLayoutInfo;
   std::array<vk::DescriptorSetLayoutBinding, 2> bindings{uboLayoutBinding,
@@ -89,7 +104,7 @@ void Shader::initDescriptorSetLayouts() {
   vk::DescriptorSetLayoutBinding materialLayoutBinding;
   materialLayoutBinding.setBinding(0)
       .setDescriptorCount(1)
-      .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+      .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
       .setStageFlags(vk::ShaderStageFlagBits::eFragment);
 
   vk::DescriptorSetLayoutCreateInfo materialSetLayoutInfo;
@@ -99,7 +114,7 @@ void Shader::initDescriptorSetLayouts() {
 }
 
 std::vector<vk::PushConstantRange> Shader::GetPushConstantRange() const {
-  std::vector<vk::PushConstantRange> ranges(2);
+  std::vector<vk::PushConstantRange> ranges(3);
   ranges[0]
       .setOffset(0)
       .setSize(sizeof(Mat4))
@@ -108,6 +123,11 @@ std::vector<vk::PushConstantRange> Shader::GetPushConstantRange() const {
       .setOffset(sizeof(Mat4))
       .setSize(sizeof(Color))
       .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+  // PackedVertex的反量化参数
+  ranges[2]
+      .setOffset(PushConstantDequantizationOffset)
+      .setSize(sizeof(VertexDequantization))
+      .setStageFlags(vk::ShaderStageFlagBits::eVertex);
   return ranges;
 }
 
@@ -5,9 +5,14 @@
 
 namespace sktr {
 
+// mat4 model(vertex) | vec3 color(fragment) | VertexDequantization(vertex)
+constexpr uint32_t PushConstantDequantizationOffset = 80;
+
 class Shader final : public Singlton<Shader> {
  public:
   vk::ShaderModule vertexModule;
+  // 用-DINSTANCED编译的shader.vert，实例化的pipeline使用
+  vk::ShaderModule instancedVertexModule;
   vk::ShaderModule fragmentModule;
   std::vector<vk::DescriptorSetLayout> descriptorSetLayouts;
 
@@ -15,13 +20,18 @@ class Shader final : public Singlton<Shader> {
    * @brief
    * @note
    * @param  &verteSource:定点着色器的源代码
+   * @param  &instancedVertexSource:实例化的顶点着色器的源代码
    * @param  &fragSource:片段着色器的源代码
    * @retval None
    */
-  Shader(const std::string &verteSource, const std::string &fragSource);
+  Shader(const std::string &verteSource,
+         const std::string &instancedVertexSource,
+         const std::string &fragSource);
   ~Shader();
 
-  std::vector<vk::PipelineShaderStageCreateInfo> GetStages();
+  // instanced为true时使用instancedVertexModule
+  std::vector<vk::PipelineShaderStageCreateInfo> GetStages(
+      bool instanced = false);
 
   std::vector<vk::PushConstantRange> GetPushConstantRange() const;
 
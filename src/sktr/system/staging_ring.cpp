@@ -0,0 +1,321 @@
+#include "staging_ring.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+StagingRing::StagingRing(vk::DeviceSize capacity) : capacity_(capacity) {
+  auto& ctx = Context::GetInstance();
+  buffer_.reset(new Buffer{capacity, vk::BufferUsageFlagBits::eTransferSrc,
+                           MemoryUsage::eStaging});
+  queue_ = ctx.transferQueue;
+  graphicsFamily_ = ctx.queueFamilyIndices.graphicsQueue.value();
+  transferFamily_ =
+      ctx.queueFamilyIndices.transferQueue.value_or(graphicsFamily_);
+
+  vk::CommandPoolCreateInfo poolInfo;
+  poolInfo.setFlags(vk::CommandPoolCreateFlagBits::eTransient)
+      .setQueueFamilyIndex(transferFamily_);
+  pool_ = ctx.device.createCommandPool(poolInfo);
+
+  vk::SemaphoreTypeCreateInfo typeInfo;
+  typeInfo.setSemaphoreType(vk::SemaphoreType::eTimeline).setInitialValue(0);
+  vk::SemaphoreCreateInfo semaphoreInfo;
+  semaphoreInfo.setPNext(&typeInfo);
+  timeline_ = ctx.device.createSemaphore(semaphoreInfo);
+}
+
+StagingRing::~StagingRing() {
+  Flush();
+  auto& device = Context::GetInstance().device;
+  device.destroySemaphore(timeline_);
+  device.destroyCommandPool(pool_);
+}
+
+uint64_t StagingRing::completedValue() const {
+  return Context::GetInstance().device.getSemaphoreCounterValue(timeline_);
+}
+
+bool StagingRing::IsComplete(UploadHandle handle) const {
+  return handle.value <= completedValue();
+}
+
+void StagingRing::Wait(UploadHandle handle) {
+  // 等待的可能是还在录制的批次
+  if (!inFlight_.empty() && inFlight_.back().open &&
+      inFlight_.back().value <= handle.value) {
+    close();
+  }
+  while (!inFlight_.empty() && inFlight_.front().value <= handle.value) {
+    retire(true);
+  }
+}
+
+void StagingRing::Flush() {
+  if (!inFlight_.empty() && inFlight_.back().open) {
+    close();
+  }
+  while (!inFlight_.empty()) {
+    retire(true);
+  }
+}
+
+void StagingRing::retire(bool wait) {
+  auto& device = Context::GetInstance().device;
+  if (wait && !inFlight_.empty()) {
+    vk::SemaphoreWaitInfo waitInfo;
+    waitInfo.setSemaphores(timeline_).setValues(inFlight_.front().value);
+    if (device.waitSemaphores(waitInfo,
+                              std::numeric_limits<uint64_t>::max()) !=
+        vk::Result::eSuccess) {
+      std::cout << "wait for staging upload failed" << std::endl;
+    }
+  }
+  // 录制中的批次的值还没有提交，不会被回收
+  auto completed = completedValue();
+  while (!inFlight_.empty() && inFlight_.front().value <= completed) {
+    device.freeCommandBuffers(pool_, inFlight_.front().cmdBuff);
+    inFlight_.pop_front();
+    retiredCount_++;
+  }
+  if (inFlight_.empty()) {
+    head_ = 0;
+  }
+}
+
+std::optional<vk::DeviceSize> StagingRing::tryAllocate(vk::DeviceSize size) {
+  // 只使用独立staging的批次不占用环形区域
+  auto front = std::find_if(
+      inFlight_.begin(), inFlight_.end(),
+      [](const Submission& submission) { return submission.usesRing; });
+  if (front == inFlight_.end()) {
+    return size <= capacity_ ? std::optional<vk::DeviceSize>(0) : std::nullopt;
+  }
+  // 正在使用的区域是[tail, head_)，可能绕回了开头
+  const vk::DeviceSize tail = front->begin;
+  const vk::DeviceSize offset = (head_ + Alignment - 1) & ~(Alignment - 1);
+  if (head_ > tail) {
+    if (offset + size <= capacity_) {
+      return offset;
+    }
+    if (size <= tail) {
+      return 0;
+    }
+    return std::nullopt;
+  }
+  if (offset + size <= tail) {
+    return offset;
+  }
+  return std::nullopt;
+}
+
+UploadHandle StagingRing::UploadBuffer(vk::Buffer dst, vk::DeviceSize size,
+                                       const WriteFunc& write,
+                                       vk::DeviceSize dstOffset) {
+  return upload(size, write, [&](vk::CommandBuffer& cmdBuff, vk::Buffer src,
+                                 vk::DeviceSize offset) {
+    vk::BufferCopy region;
+    region.setSize(size).setSrcOffset(offset).setDstOffset(dstOffset);
+    cmdBuff.copyBuffer(src, dst, region);
+    if (!DedicatedQueue()) {
+      return;
+    }
+    // 释放和获取的barrier除了access之外参数要一致
+    vk::BufferMemoryBarrier barrier;
+    barrier.setBuffer(dst)
+        .setOffset(dstOffset)
+        .setSize(size)
+        .setSrcQueueFamilyIndex(transferFamily_)
+        .setDstQueueFamilyIndex(graphicsFamily_)
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+    cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eBottomOfPipe, {}, {},
+                            barrier, {});
+    barrier.setSrcAccessMask({}).setDstAccessMask(
+        vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+    batchAcquires_.buffers.push_back(barrier);
+  });
+}
+
+UploadHandle StagingRing::UploadImage(vk::Image dst, uint32_t w, uint32_t h,
+                                      uint32_t mipLevels,
+                                      const WriteFunc& write) {
+  vk::DeviceSize size = vk::DeviceSize(w) * h * 4;
+  return upload(size, write, [&](vk::CommandBuffer& cmdBuff, vk::Buffer src,
+                                 vk::DeviceSize offset) {
+    vk::ImageSubresourceRange range;
+    range.setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setBaseMipLevel(0)
+        .setLevelCount(mipLevels)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1);
+    // undefined的内容不需要保留，不用转移所有权就可以在传输队列上转换
+    vk::ImageMemoryBarrier barrier;
+    barrier.setImage(dst)
+        .setSubresourceRange(range)
+        .setOldLayout(vk::ImageLayout::eUndefined)
+        .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+    cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                            vk::PipelineStageFlagBits::eTransfer, {}, {}, {},
+                            barrier);
+
+    vk::ImageSubresourceLayers subSource;
+    subSource.setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setBaseArrayLayer(0)
+        .setMipLevel(0)
+        .setLayerCount(1);
+    vk::BufferImageCopy region;
+    // 0：告诉vulkan图像就是紧凑存储
+    region.setBufferOffset(offset)
+        .setBufferRowLength(0)
+        .setBufferImageHeight(0)
+        .setImageOffset(0)
+        .setImageExtent({w, h, 1})
+        .setImageSubresource(subSource);
+    cmdBuff.copyBufferToImage(src, dst, vk::ImageLayout::eTransferDstOptimal,
+                              region);
+    if (!DedicatedQueue()) {
+      return;
+    }
+    barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+        .setSrcQueueFamilyIndex(transferFamily_)
+        .setDstQueueFamilyIndex(graphicsFamily_)
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask({});
+    cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eBottomOfPipe, {}, {},
+                            {}, barrier);
+    barrier.setSrcAccessMask({}).setDstAccessMask(
+        vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+    batchAcquires_.images.push_back(barrier);
+  });
+}
+
+UploadHandle StagingRing::RecordAcquires(vk::CommandBuffer& cmdBuff) {
+  if (acquires_.buffers.empty() && acquires_.images.empty()) {
+    return {};
+  }
+  cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                          vk::PipelineStageFlagBits::eAllCommands, {}, {},
+                          acquires_.buffers, acquires_.images);
+  acquires_ = Acquires{};
+  return {acquireValue_};
+}
+
+UploadHandle StagingRing::EndBatch() {
+  if (batchDepth_ == 0 || --batchDepth_ > 0) {
+    return {submittedValue_};
+  }
+  UploadHandle handle{submittedValue_};
+  if (!inFlight_.empty() && inFlight_.back().open) {
+    close();
+  }
+  if (!enabled_) {
+    Flush();
+  }
+  return handle;
+}
+
+UploadHandle StagingRing::upload(vk::DeviceSize size, const WriteFunc& write,
+                                 const RecordFunc& record) {
+  retire(false);
+  if (inFlight_.empty() || !inFlight_.back().open) {
+    open();
+  }
+  vk::Buffer src;
+  vk::DeviceSize offset = 0;
+  if (!enabled_ || size > capacity_ / 2) {
+    auto& dedicated = inFlight_.back().dedicated;
+    dedicated.emplace_back(
+        new Buffer{size, vk::BufferUsageFlagBits::eTransferSrc,
+                   MemoryUsage::eStaging});
+    write(dedicated.back()->map);
+    src = dedicated.back()->buffer;
+  } else {
+    auto allocated = tryAllocate(size);
+    if (!allocated) {
+      // 录制中的批次也占用环形区域，先提交才能等到它完成
+      close();
+      while (!(allocated = tryAllocate(size))) {
+        stallCount_++;
+        retire(true);
+      }
+      open();
+    }
+    auto& submission = inFlight_.back();
+    if (!submission.usesRing) {
+      submission.usesRing = true;
+      submission.begin = *allocated;
+    }
+    offset = *allocated;
+    head_ = offset + size;
+    write(static_cast<uint8_t*>(buffer_->map) + offset);
+    src = buffer_->buffer;
+  }
+
+  auto& submission = inFlight_.back();
+  record(submission.cmdBuff, src, offset);
+  UploadHandle handle{submission.value};
+  if (batchDepth_ == 0) {
+    close();
+    if (!enabled_) {
+      Flush();
+    }
+  }
+  return handle;
+}
+
+void StagingRing::open() {
+  auto& device = Context::GetInstance().device;
+  Submission submission;
+  vk::CommandBufferAllocateInfo allocateInfo;
+  allocateInfo.setCommandPool(pool_)
+      .setCommandBufferCount(1)
+      .setLevel(vk::CommandBufferLevel::ePrimary);
+  submission.cmdBuff = device.allocateCommandBuffers(allocateInfo)[0];
+  submission.value = ++submittedValue_;
+
+  vk::CommandBufferBeginInfo beginInfo;
+  beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+  submission.cmdBuff.begin(beginInfo);
+  inFlight_.push_back(std::move(submission));
+}
+
+void StagingRing::close() {
+  auto& submission = inFlight_.back();
+  auto& cmdBuff = submission.cmdBuff;
+  if (DedicatedQueue()) {
+    auto& buffers = acquires_.buffers;
+    auto& images = acquires_.images;
+    buffers.insert(buffers.end(), batchAcquires_.buffers.begin(),
+                   batchAcquires_.buffers.end());
+    images.insert(images.end(), batchAcquires_.images.begin(),
+                  batchAcquires_.images.end());
+    batchAcquires_ = Acquires{};
+    acquireValue_ = submission.value;
+  } else {
+    // 同一个队列，之后提交的命令不论在哪个阶段读取，都要等拷贝写完
+    vk::MemoryBarrier barrier;
+    barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eMemoryRead |
+                          vk::AccessFlagBits::eMemoryWrite);
+    cmdBuff.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eAllCommands, {},
+                            barrier, {}, {});
+  }
+  cmdBuff.end();
+
+  vk::TimelineSemaphoreSubmitInfo timelineInfo;
+  timelineInfo.setSignalSemaphoreValues(submission.value);
+  vk::SubmitInfo submitInfo;
+  submitInfo.setCommandBuffers(cmdBuff)
+      .setSignalSemaphores(timeline_)
+      .setPNext(&timelineInfo);
+  queue_.submit(submitInfo);
+  submission.open = false;
+}
+
+}  // namespace sktr
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <deque>
+
+#include "buffer.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+// 上传批次在timeline semaphore上的值，0表示不需要等待
+struct UploadHandle {
+  uint64_t value = 0;
+
+  operator bool() const { return value != 0; }
+};
+
+/*
+ * 常驻映射的staging环形缓冲，所有上传都从这里分配并提交到传输队列
+ *
+ * 有独立的传输队列族时使用它，否则使用graphics队列。
+ * 每次上传或BeginBatch/EndBatch之间的上传是一个批次，
+ * 完成时timeline semaphore到达批次的值，提交后不等待GPU。
+ * 分配时回收已经完成的区域，空间不够时等待最早的批次。
+ * 超过容量一半的上传单独创建staging buffer，同样在批次完成后释放。
+ * 使用独立的传输队列时，目标资源在拷贝后释放所有权，
+ * graphics队列在第一次使用前通过RecordAcquires获取
+ */
+class StagingRing final {
+ public:
+  static constexpr vk::DeviceSize DefaultCapacity = 32ull << 20;
+  // bufferImageCopy要求偏移是texel大小的整数倍
+  static constexpr vk::DeviceSize Alignment = 16;
+
+  using WriteFunc = std::function<void(void*)>;
+
+  explicit StagingRing(vk::DeviceSize capacity = DefaultCapacity);
+  ~StagingRing();
+
+  StagingRing(const StagingRing&) = delete;
+  StagingRing& operator=(const StagingRing&) = delete;
+
+  /**
+   * @brief  写入staging并提交到dst中[dstOffset, dstOffset + size)的拷贝
+   * @note   返回时拷贝可能还没有完成，dst在完成前不能销毁。
+   *         只转移这一段的所有权，同一个buffer的其他部分可以同时在使用
+   * @param  dst: 需要eTransferDst，这一段之前的内容不会保留
+   * @param  size: 上传的字节数
+   * @param  write: 向映射的staging内存写入数据
+   */
+  UploadHandle UploadBuffer(vk::Buffer dst, vk::DeviceSize size,
+                            const WriteFunc& write,
+                            vk::DeviceSize dstOffset = 0);
+  /**
+   * @brief  写入staging并拷贝到image的第0级
+   * @note   image从undefined转换为eTransferDstOptimal，拷贝后保持这个布局。
+   *         数据为紧凑存储的RGBA8
+   */
+  UploadHandle UploadImage(vk::Image dst, uint32_t w, uint32_t h,
+                           uint32_t mipLevels, const WriteFunc& write);
+
+  /**
+   * @brief  在graphics队列的命令中获取之前上传资源的所有权
+   * @note   返回提交这些命令时需要等待的timeline值，不需要时返回空的handle。
+   *         和传输队列是同一个队列族时什么都不录制
+   */
+  UploadHandle RecordAcquires(vk::CommandBuffer& cmdBuff);
+  vk::Semaphore Timeline() const { return timeline_; }
+
+  // 之间的上传录制到同一个命令缓冲，EndBatch时一起提交，可以嵌套。
+  // 环形空间不够时会提前提交已经录制的部分
+  void BeginBatch() { batchDepth_++; }
+  UploadHandle EndBatch();
+
+  bool IsComplete(UploadHandle handle) const;
+  void Wait(UploadHandle handle);
+  // 等待所有上传完成
+  void Flush();
+
+  // 关闭时每次上传单独创建staging buffer并阻塞等待，即原来的做法，用于对比
+  void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+  vk::DeviceSize Capacity() const { return capacity_; }
+  // 使用独立的传输队列
+  bool DedicatedQueue() const { return transferFamily_ != graphicsFamily_; }
+  // 回收过的区域数，以及因为空间不够而等待GPU的次数
+  uint32_t RetiredCount() const { return retiredCount_; }
+  uint32_t StallCount() const { return stallCount_; }
+
+ private:
+  using RecordFunc = std::function<void(vk::CommandBuffer&, vk::Buffer src,
+                                        vk::DeviceSize srcOffset)>;
+
+  struct Submission {
+    uint64_t value = 0;
+    vk::CommandBuffer cmdBuff;
+    // 还在录制，没有提交
+    bool open = true;
+    // 占用的环形区域从begin开始，一个批次中的区域是连续分配的
+    bool usesRing = false;
+    vk::DeviceSize begin = 0;
+    // 超过容量的上传使用的独立staging
+    std::vector<std::unique_ptr<Buffer>> dedicated;
+  };
+
+  std::unique_ptr<Buffer> buffer_;
+  vk::DeviceSize capacity_;
+  // 下一次分配的起点
+  vk::DeviceSize head_ = 0;
+  std::deque<Submission> inFlight_;
+  bool enabled_ = true;
+  uint32_t retiredCount_ = 0;
+  uint32_t stallCount_ = 0;
+
+  vk::Queue queue_;
+  uint32_t transferFamily_;
+  uint32_t graphicsFamily_;
+  vk::CommandPool pool_;
+  vk::Semaphore timeline_;
+  uint64_t submittedValue_ = 0;
+  uint32_t batchDepth_ = 0;
+
+  struct Acquires {
+    std::vector<vk::BufferMemoryBarrier> buffers;
+    std::vector<vk::ImageMemoryBarrier> images;
+  };
+  // 正在录制的批次中的资源，提交后移到acquires_
+  Acquires batchAcquires_;
+  // 已经提交、等待graphics队列获取所有权的资源
+  Acquires acquires_;
+  // 这些资源所在批次中最新的一个
+  uint64_t acquireValue_ = 0;
+
+  std::optional<vk::DeviceSize> tryAllocate(vk::DeviceSize size);
+  uint64_t completedValue() const;
+  // wait为true时至少回收最早的一个批次
+  void retire(bool wait);
+  UploadHandle upload(vk::DeviceSize size, const WriteFunc& write,
+                      const RecordFunc& record);
+  // 开始录制新的批次，放在inFlight_的最后
+  void open();
+  // 提交正在录制的批次
+  void close();
+};
+
+}  // namespace sktr
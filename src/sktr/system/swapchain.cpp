@@ -4,6 +4,9 @@
 
 namespace sktr {
 
+// 每次创建附件加1，用于判断依赖附件的资源是否需要重新创建
+static uint64_t attachmentCounter = 0;
+
 Swapchain::Swapchain(int w, int h) : width(w), height(h) { createSwapchain(); }
 
 void Swapchain::createSwapchain() {
@@ -67,8 +70,8 @@ void Swapchain::Recreate() {
 Swapchain::~Swapchain() { Cleanup(); }
 
 void Swapchain::Cleanup() {
-  depthResource.reset();
-  colorResource.reset();
+  attachments.reset();
+  depth.reset();
   for (auto& framebuffer : framebuffers) {
     Context::GetInstance().device.destroyFramebuffer(framebuffer);
   }
@@ -128,26 +131,42 @@ void Swapchain::createImageViews() {
 }
 
 void Swapchain::createImageResource(int w, int h) {
-  auto& msaa = Context::GetInstance().sampler.msaaSamples;
-  colorResource.reset(new ImageResource(ImageResource::CreateColorResource(
-      w, h, 1, msaa, info.surfaceFormat.format, vk::ImageTiling::eOptimal,
-      vk::ImageUsageFlagBits::eTransientAttachment |
-          vk::ImageUsageFlagBits::eColorAttachment,
-      vk::MemoryPropertyFlagBits::eDeviceLocal)));
-  depthResource.reset(new ImageResource(ImageResource::CreateDepthResource(
-      w, h, 1, msaa, findDepthFormat(), vk::ImageTiling::eOptimal,
-      vk::ImageUsageFlagBits::eDepthStencilAttachment,
-      vk::MemoryPropertyFlagBits::eDeviceLocal)));
+  auto& ctx = Context::GetInstance();
+  auto& msaa = ctx.sampler.msaaSamples;
+  // 颜色resolve到交换链图像，深度不保存，两者在同一个subpass中使用
+  std::vector<TransientAttachments::Desc> descs = {
+      {info.surfaceFormat.format, vk::ImageUsageFlagBits::eColorAttachment,
+       vk::ImageAspectFlagBits::eColor},
+  };
+  vk::Extent2D extent{static_cast<uint32_t>(w), static_cast<uint32_t>(h)};
+  attachmentExtent = extent;
+  attachmentGeneration = ++attachmentCounter;
+  if (ctx.occlusionCullingEnabled) {
+    // 深度要在render pass之间保存，并用来生成深度金字塔
+    depth.reset(new ImageResource{ImageResource::CreateDepthResource(
+        extent.width, extent.height, 1, msaa, findDepthFormat(),
+        vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eDepthStencilAttachment |
+            vk::ImageUsageFlagBits::eSampled,
+        MemoryUsage::eGpuOnly)});
+  } else {
+    descs.push_back({findDepthFormat(),
+                     vk::ImageUsageFlagBits::eDepthStencilAttachment,
+                     vk::ImageAspectFlagBits::eDepth});
+  }
+  attachments.reset(new TransientAttachments{extent, msaa, descs});
+  std::cout << "[swapchain] transient " << attachments->GetReport()
+            << std::endl;
 }
 
 void Swapchain::CreateFramebuffers(int w, int h) {
   framebuffers.resize(images.size());
   for (int i = 0; i < framebuffers.size(); i++) {
     auto& framebuffer = framebuffers[i];
-    std::array<vk::ImageView, 3> attachments = {
-        colorResource->view, depthResource->view, imageViews[i]};
+    std::array<vk::ImageView, 3> views = {attachments->View(0), DepthView(),
+                                          imageViews[i]};
     vk::FramebufferCreateInfo framebufferInfo;
-    framebufferInfo.setAttachments(attachments)
+    framebufferInfo.setAttachments(views)
         .setWidth(w)
         .setHeight(h)
         .setRenderPass(Context::GetInstance().renderProcess->renderPass)
@@ -17,6 +17,7 @@
 
 #include "sktr/core/texture.hpp"
 #include "sktr/pch.hpp"
+#include "transient_attachments.hpp"
 
 namespace sktr {
 class Swapchain final {
@@ -45,11 +46,20 @@ class Swapchain final {
   SwapchainInfo info;
   std::vector<vk::Image> images;
   std::vector<vk::ImageView> imageViews;
-  std::unique_ptr<ImageResource> colorResource;
-  std::unique_ptr<ImageResource> depthResource;
+  // 0: MSAA颜色，1: 深度，只在render pass内使用
+  std::unique_ptr<TransientAttachments> attachments;
+  // 开启遮挡剔除时深度不是transient的，可以保存和采样
+  std::unique_ptr<ImageResource> depth;
+  // 附件的大小
+  vk::Extent2D attachmentExtent;
+  // 重新创建附件后改变，view的句柄可能和之前相同
+  uint64_t attachmentGeneration = 0;
   std::vector<vk::Framebuffer> framebuffers;
 
   void CreateFramebuffers(int w, int h);
+  vk::ImageView DepthView() const {
+    return depth ? depth->view : attachments->View(1);
+  }
 
   void Cleanup();
   void Recreate();
@@ -0,0 +1,131 @@
+#include "transient_attachments.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+std::ostream& operator<<(std::ostream& os,
+                         const TransientAttachments::Report& report) {
+  auto toMB = [](vk::DeviceSize bytes) { return bytes / (1024.0 * 1024.0); };
+  os << report.extent.width << "x" << report.extent.height << " "
+     << vk::to_string(report.samples) << ", " << report.attachmentCount
+     << " attachments " << toMB(report.requestedBytes) << " MB";
+  if (report.lazilyAllocated) {
+    os << ", lazily allocated, saved up to " << toMB(report.SavedBytes())
+       << " MB";
+  } else {
+    os << ", " << report.backingCount << " allocations "
+       << toMB(report.backingBytes) << " MB, saved "
+       << toMB(report.SavedBytes()) << " MB";
+  }
+  return os;
+}
+
+TransientAttachments::TransientAttachments(vk::Extent2D extent,
+                                           vk::SampleCountFlagBits samples,
+                                           const std::vector<Desc>& descs) {
+  auto& ctx = Context::GetInstance();
+  auto& device = ctx.device;
+  auto& allocator = *ctx.memoryAllocator;
+  report_.extent = extent;
+  report_.samples = samples;
+  report_.attachmentCount = static_cast<uint32_t>(descs.size());
+
+  std::vector<vk::MemoryRequirements> requirements;
+  bool lazy = true;
+  for (const auto& desc : descs) {
+    vk::ImageCreateInfo imageInfo;
+    imageInfo.setImageType(vk::ImageType::e2D)
+        .setArrayLayers(1)
+        .setMipLevels(1)
+        .setExtent({extent.width, extent.height, 1})
+        .setFormat(desc.format)
+        .setTiling(vk::ImageTiling::eOptimal)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setUsage(desc.usage | vk::ImageUsageFlagBits::eTransientAttachment)
+        .setSamples(samples);
+    attachments_.push_back({device.createImage(imageInfo), nullptr});
+    requirements.push_back(
+        device.getImageMemoryRequirements(attachments_.back().image));
+    report_.requestedBytes += requirements.back().size;
+    // 首选的候选就是lazily allocated
+    uint32_t rank = 0;
+    allocator.Policy().Find(requirements.back().memoryTypeBits,
+                            MemoryUsage::eTransient, &rank);
+    lazy = lazy && rank == 0;
+  }
+  report_.lazilyAllocated = lazy;
+
+  for (uint32_t i = 0; i < descs.size(); i++) {
+    Backing* backing = nullptr;
+    // lazily allocated的内存不实际占用，不需要共享
+    for (auto& candidate : backings_) {
+      if (lazy) {
+        break;
+      }
+      if (!(candidate.requirements.memoryTypeBits &
+            requirements[i].memoryTypeBits)) {
+        continue;
+      }
+      bool overlap = false;
+      for (auto other : candidate.attachments) {
+        overlap = overlap ||
+                  (descs[i].firstSubpass <= descs[other].lastSubpass &&
+                   descs[other].firstSubpass <= descs[i].lastSubpass);
+      }
+      if (!overlap) {
+        backing = &candidate;
+        break;
+      }
+    }
+    if (backing) {
+      auto& merged = backing->requirements;
+      merged.size = std::max(merged.size, requirements[i].size);
+      merged.alignment = std::max(merged.alignment, requirements[i].alignment);
+      merged.memoryTypeBits &= requirements[i].memoryTypeBits;
+    } else {
+      backings_.push_back({requirements[i], {}, {}});
+      backing = &backings_.back();
+    }
+    backing->attachments.push_back(i);
+  }
+
+  for (auto& backing : backings_) {
+    backing.allocation = allocator.Allocate(
+        backing.requirements, MemoryUsage::eTransient, ResourceTiling::eOptimal);
+    report_.backingBytes += backing.requirements.size;
+    for (auto i : backing.attachments) {
+      device.bindImageMemory(attachments_[i].image, backing.allocation.memory,
+                             backing.allocation.offset);
+    }
+  }
+  report_.backingCount = static_cast<uint32_t>(backings_.size());
+
+  for (uint32_t i = 0; i < descs.size(); i++) {
+    vk::ImageSubresourceRange range;
+    range.setAspectMask(descs[i].aspect)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1)
+        .setBaseMipLevel(0)
+        .setLevelCount(1);
+    vk::ImageViewCreateInfo viewInfo;
+    viewInfo.setImage(attachments_[i].image)
+        .setViewType(vk::ImageViewType::e2D)
+        .setFormat(descs[i].format)
+        .setSubresourceRange(range);
+    attachments_[i].view = device.createImageView(viewInfo);
+  }
+}
+
+TransientAttachments::~TransientAttachments() {
+  auto& ctx = Context::GetInstance();
+  for (auto& attachment : attachments_) {
+    ctx.device.destroyImageView(attachment.view);
+    ctx.device.destroyImage(attachment.image);
+  }
+  for (auto& backing : backings_) {
+    ctx.memoryAllocator->Free(backing.allocation);
+  }
+}
+
+}  // namespace sktr
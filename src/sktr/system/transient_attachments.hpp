@@ -0,0 +1,74 @@
+#pragma once
+
+#include "memory_allocator.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 只在render pass内使用、不需要保存内容的附件，如MSAA的颜色和深度
+ *
+ * 支持lazily allocated内存时使用它，tile-based GPU上不会实际分配显存。
+ * 否则按使用的subpass范围，把生命周期不重叠的附件放在同一块内存上(aliasing)，
+ * 每块的大小是其中最大的附件。附件的initialLayout需要是undefined
+ */
+class TransientAttachments final {
+ public:
+  struct Desc {
+    vk::Format format;
+    vk::ImageUsageFlags usage;
+    vk::ImageAspectFlags aspect;
+    // 第一个和最后一个使用这个附件的subpass
+    uint32_t firstSubpass = 0;
+    uint32_t lastSubpass = 0;
+  };
+
+  struct Report {
+    vk::Extent2D extent;
+    vk::SampleCountFlagBits samples;
+    uint32_t attachmentCount = 0;
+    // 每个附件单独分配需要的大小
+    vk::DeviceSize requestedBytes = 0;
+    // 实际分配的大小，lazily allocated时是最多会使用的大小
+    vk::DeviceSize backingBytes = 0;
+    uint32_t backingCount = 0;
+    bool lazilyAllocated = false;
+
+    // lazily allocated时是最多节省的大小
+    vk::DeviceSize SavedBytes() const {
+      return lazilyAllocated ? requestedBytes : requestedBytes - backingBytes;
+    }
+  };
+
+  TransientAttachments(vk::Extent2D extent, vk::SampleCountFlagBits samples,
+                       const std::vector<Desc>& descs);
+  ~TransientAttachments();
+
+  TransientAttachments(const TransientAttachments&) = delete;
+  TransientAttachments& operator=(const TransientAttachments&) = delete;
+
+  // 按descs的顺序
+  vk::ImageView View(size_t index) const { return attachments_[index].view; }
+  const Report& GetReport() const { return report_; }
+
+ private:
+  struct Attachment {
+    vk::Image image;
+    vk::ImageView view;
+  };
+  // 共享一块内存的附件
+  struct Backing {
+    vk::MemoryRequirements requirements;
+    std::vector<uint32_t> attachments;
+    MemoryAllocation allocation;
+  };
+
+  std::vector<Attachment> attachments_;
+  std::vector<Backing> backings_;
+  Report report_;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const TransientAttachments::Report& report);
+
+}  // namespace sktr
@@ -0,0 +1,34 @@
+#include "uniform_allocator.hpp"
+
+#include "sktr/core/context.hpp"
+
+namespace sktr {
+
+UniformAllocator::UniformAllocator(uint32_t frameCount,
+                                   vk::DeviceSize frameSize) {
+  auto& ctx = Context::GetInstance();
+  alignment_ =
+      ctx.phyDevice.getProperties().limits.minUniformBufferOffsetAlignment;
+  // 每段的起点也要满足对齐
+  frameSize_ = (frameSize + alignment_ - 1) / alignment_ * alignment_;
+  buffer_.reset(new Buffer{frameSize_ * frameCount,
+                           vk::BufferUsageFlagBits::eUniformBuffer,
+                           MemoryUsage::eCpuToGpu});
+}
+
+void UniformAllocator::BeginFrame(uint32_t frameIndex) {
+  frameBegin_ = frameSize_ * frameIndex;
+  head_ = frameBegin_;
+}
+
+uint32_t UniformAllocator::Push(const void* data, vk::DeviceSize size) {
+  if (head_ + size > frameBegin_ + frameSize_) {
+    throw std::runtime_error("uniform allocator out of space in this frame");
+  }
+  auto offset = head_;
+  memcpy(static_cast<uint8_t*>(buffer_->map) + offset, data, size);
+  head_ = (offset + size + alignment_ - 1) / alignment_ * alignment_;
+  return static_cast<uint32_t>(offset);
+}
+
+}  // namespace sktr
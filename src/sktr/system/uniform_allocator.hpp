@@ -0,0 +1,53 @@
+#pragma once
+
+#include "buffer.hpp"
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 每帧线性分配的uniform数据
+ *
+ * 一个常驻映射的buffer按maxFlightCount分成多段，每帧只写自己的一段，
+ * 等到这一帧的fence之后才会重新使用，不会覆盖GPU正在读取的数据。
+ * 描述符使用eUniformBufferDynamic指向buffer开头，绘制时通过dynamic offset选择数据
+ */
+class UniformAllocator final {
+ public:
+  static constexpr vk::DeviceSize DefaultFrameSize = 4ull << 20;
+
+  explicit UniformAllocator(uint32_t frameCount,
+                            vk::DeviceSize frameSize = DefaultFrameSize);
+
+  UniformAllocator(const UniformAllocator&) = delete;
+  UniformAllocator& operator=(const UniformAllocator&) = delete;
+
+  // 等待这一帧的fence之后调用，丢弃这一段之前的数据
+  void BeginFrame(uint32_t frameIndex);
+
+  /**
+   * @brief  在当前帧的段中分配并拷贝数据
+   * @note   空间不够时抛出异常
+   * @retval 绑定描述符集时的dynamic offset
+   */
+  uint32_t Push(const void* data, vk::DeviceSize size);
+  template <typename T>
+  uint32_t Push(const T& data) {
+    return Push(&data, sizeof(T));
+  }
+
+  vk::Buffer GetBuffer() const { return buffer_->buffer; }
+  vk::DeviceSize FrameSize() const { return frameSize_; }
+  // 当前帧已经使用的字节数
+  vk::DeviceSize UsedBytes() const { return head_ - frameBegin_; }
+
+ private:
+  std::unique_ptr<Buffer> buffer_;
+  vk::DeviceSize frameSize_;
+  // minUniformBufferOffsetAlignment
+  vk::DeviceSize alignment_;
+  vk::DeviceSize frameBegin_ = 0;
+  vk::DeviceSize head_ = 0;
+};
+
+}  // namespace sktr
@@ -0,0 +1,92 @@
+#include "buddy_allocator.hpp"
+
+namespace sktr {
+
+static uint64_t nextPowerOfTwo(uint64_t value) {
+  uint64_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t minNodeSize)
+    : size_(nextPowerOfTwo(size)),
+      minNodeSize_(nextPowerOfTwo(std::max<uint64_t>(minNodeSize, 1))) {
+  maxOrder_ = orderOf(size_);
+  freeLists_.resize(maxOrder_ + 1);
+  freeLists_[maxOrder_].insert(0);
+}
+
+uint32_t BuddyAllocator::orderOf(uint64_t nodeSize) const {
+  uint32_t order = 0;
+  while ((minNodeSize_ << order) < nodeSize) {
+    order++;
+  }
+  return order;
+}
+
+uint64_t BuddyAllocator::NodeSize(uint64_t size, uint64_t alignment) const {
+  return std::max({nextPowerOfTwo(size), nextPowerOfTwo(alignment),
+                   minNodeSize_});
+}
+
+std::optional<uint64_t> BuddyAllocator::Allocate(uint64_t size,
+                                                 uint64_t alignment) {
+  uint64_t nodeSize = NodeSize(size, alignment);
+  if (size == 0 || nodeSize > size_) {
+    return std::nullopt;
+  }
+  const uint32_t order = orderOf(nodeSize);
+  uint32_t found = order;
+  while (found <= maxOrder_ && freeLists_[found].empty()) {
+    found++;
+  }
+  if (found > maxOrder_) {
+    return std::nullopt;
+  }
+  // 取偏移最小的节点，让分配尽量集中在块的前部
+  uint64_t offset = *freeLists_[found].begin();
+  freeLists_[found].erase(freeLists_[found].begin());
+  // 逐级对半拆分，后一半放回空闲链表
+  while (found > order) {
+    found--;
+    freeLists_[found].insert(offset + (minNodeSize_ << found));
+  }
+  allocated_[offset] = order;
+  usedBytes_ += minNodeSize_ << order;
+  return offset;
+}
+
+void BuddyAllocator::Free(uint64_t offset) {
+  auto it = allocated_.find(offset);
+  if (it == allocated_.end()) {
+    return;
+  }
+  uint32_t order = it->second;
+  allocated_.erase(it);
+  usedBytes_ -= minNodeSize_ << order;
+  // 伙伴也空闲时合并成上一级
+  while (order < maxOrder_) {
+    uint64_t buddy = offset ^ (minNodeSize_ << order);
+    auto buddyIt = freeLists_[order].find(buddy);
+    if (buddyIt == freeLists_[order].end()) {
+      break;
+    }
+    freeLists_[order].erase(buddyIt);
+    offset = std::min(offset, buddy);
+    order++;
+  }
+  freeLists_[order].insert(offset);
+}
+
+uint64_t BuddyAllocator::LargestFreeNode() const {
+  for (uint32_t order = maxOrder_ + 1; order-- > 0;) {
+    if (!freeLists_[order].empty()) {
+      return minNodeSize_ << order;
+    }
+  }
+  return 0;
+}
+
+}  // namespace sktr
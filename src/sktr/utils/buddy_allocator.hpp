@@ -0,0 +1,50 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 伙伴算法的区间分配，只管理偏移，不涉及实际的内存
+ *
+ * 总大小和最小分配单位都是2的幂。每次分配向上取整到2的幂，
+ * 起始偏移是这个大小的整数倍，所以2的幂的对齐要求自然满足
+ */
+class BuddyAllocator final {
+ public:
+  BuddyAllocator(uint64_t size, uint64_t minNodeSize);
+
+  // 空间不够时返回空
+  std::optional<uint64_t> Allocate(uint64_t size, uint64_t alignment = 1);
+  void Free(uint64_t offset);
+
+  uint64_t Size() const { return size_; }
+  // 已分配节点的大小之和，包括取整多出来的部分
+  uint64_t UsedBytes() const { return usedBytes_; }
+  uint64_t FreeBytes() const { return size_ - usedBytes_; }
+  // 能一次分配出的最大连续空间
+  uint64_t LargestFreeNode() const;
+  uint32_t AllocationCount() const {
+    return static_cast<uint32_t>(allocated_.size());
+  }
+  bool Empty() const { return allocated_.empty(); }
+
+  // 实际占用的节点大小
+  uint64_t NodeSize(uint64_t size, uint64_t alignment = 1) const;
+
+ private:
+  uint64_t size_;
+  uint64_t minNodeSize_;
+  uint32_t maxOrder_;
+  uint64_t usedBytes_ = 0;
+  // freeLists_[order]中节点的大小为minNodeSize_ << order，按偏移排序方便查找伙伴
+  std::vector<std::set<uint64_t>> freeLists_;
+  // 已分配节点的偏移 -> order
+  std::unordered_map<uint64_t, uint32_t> allocated_;
+
+  uint32_t orderOf(uint64_t nodeSize) const;
+};
+
+}  // namespace sktr
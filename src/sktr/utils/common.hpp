@@ -11,6 +11,8 @@ struct QueueFamilyIndices {
   std::optional<uint32_t> graphicsQueue;
   // 支持surface的队列
   std::optional<uint32_t> presentQueue;
+  // 只支持传输的队列，用于异步上传，没有时使用graphics队列
+  std::optional<uint32_t> transferQueue;
 
   operator bool() const {
     return graphicsQueue.has_value() && presentQueue.has_value();
@@ -67,10 +69,103 @@ struct Vertex {
 
   bool operator==(const Vertex& other) const {
     return pos == other.pos && color == other.color &&
-           texCoord == other.texCoord;
+           normal == other.normal && texCoord == other.texCoord;
   }
 };
 
+// 顶点在GPU上的存储格式
+enum class VertexFormat {
+  // 即Vertex，44字节的float
+  eFull,
+  // 即PackedVertex，16字节
+  ePacked,
+};
+
+// 压缩后的顶点，color恒为白色所以不存
+struct PackedVertex {
+  // 相对于模型包围盒的位置，unorm16，w不使用
+  uint16_t pos[4];
+  // 八面体编码的法线，snorm16
+  int16_t normal[2];
+  // half float
+  uint16_t texCoord[2];
+
+  static vk::VertexInputBindingDescription GetBindingDescriptions() {
+    vk::VertexInputBindingDescription bindingDescription{};
+
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(PackedVertex);
+    bindingDescription.inputRate = vk::VertexInputRate::eVertex;
+    return bindingDescription;
+  }
+
+  // location和Vertex保持一致，shader中按specialization constant解码
+  static std::array<vk::VertexInputAttributeDescription, 3>
+  GetAttributeDescriptions() {
+    std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = vk::Format::eR16G16B16A16Unorm;
+    attributeDescriptions[0].offset = offsetof(PackedVertex, pos);
+
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 2;
+    attributeDescriptions[1].format = vk::Format::eR16G16Snorm;
+    attributeDescriptions[1].offset = offsetof(PackedVertex, normal);
+
+    attributeDescriptions[2].binding = 0;
+    attributeDescriptions[2].location = 3;
+    attributeDescriptions[2].format = vk::Format::eR16G16Sfloat;
+    attributeDescriptions[2].offset = offsetof(PackedVertex, texCoord);
+
+    return attributeDescriptions;
+  }
+};
+static_assert(sizeof(PackedVertex) == 16);
+
+inline uint32_t VertexStride(VertexFormat format) {
+  return format == VertexFormat::ePacked ? sizeof(PackedVertex)
+                                         : sizeof(Vertex);
+}
+
+// DrawModelInstanced每个实例的数据，按实例从binding 1读取
+struct InstanceData {
+  glm::mat4 model;
+  glm::vec4 color;
+
+  static vk::VertexInputBindingDescription GetBindingDescriptions() {
+    vk::VertexInputBindingDescription bindingDescription{};
+
+    bindingDescription.binding = 1;
+    bindingDescription.stride = sizeof(InstanceData);
+    bindingDescription.inputRate = vk::VertexInputRate::eInstance;
+    return bindingDescription;
+  }
+
+  // mat4占location 4到7，每列一个
+  static std::array<vk::VertexInputAttributeDescription, 5>
+  GetAttributeDescriptions() {
+    std::array<vk::VertexInputAttributeDescription, 5> attributeDescriptions{};
+
+    for (uint32_t i = 0; i < 4; i++) {
+      attributeDescriptions[i].binding = 1;
+      attributeDescriptions[i].location = 4 + i;
+      attributeDescriptions[i].format = vk::Format::eR32G32B32A32Sfloat;
+      attributeDescriptions[i].offset =
+          offsetof(InstanceData, model) + sizeof(glm::vec4) * i;
+    }
+
+    attributeDescriptions[4].binding = 1;
+    attributeDescriptions[4].location = 8;
+    attributeDescriptions[4].format = vk::Format::eR32G32B32A32Sfloat;
+    attributeDescriptions[4].offset = offsetof(InstanceData, color);
+
+    return attributeDescriptions;
+  }
+};
+static_assert(sizeof(InstanceData) == 80);
+
 struct ViewProjectMatrices {
   alignas(16) glm::mat4 view;
   alignas(16) glm::mat4 proj;
@@ -92,10 +187,21 @@ namespace std {
 template <>
 struct hash<sktr::Vertex> {
   size_t operator()(sktr::Vertex const& vertex) const {
-    return ((hash<glm::vec3>()(vertex.pos) ^
-             (hash<glm::vec3>()(vertex.color) << 1)) >>
-            1) ^
-           (hash<glm::vec2>()(vertex.texCoord) << 1);
+    const float components[] = {
+        vertex.pos.x,    vertex.pos.y,      vertex.pos.z,
+        vertex.color.x,  vertex.color.y,    vertex.color.z,
+        vertex.normal.x, vertex.normal.y,   vertex.normal.z,
+        vertex.texCoord.x, vertex.texCoord.y};
+    uint64_t seed = 0x9e3779b97f4a7c15ull;
+    for (float component : components) {
+      // +0.0f 把 -0.0 规范为 0.0，与 operator== 保持一致
+      component += 0.0f;
+      uint32_t bits;
+      memcpy(&bits, &component, sizeof(bits));
+      seed = (seed ^ bits) * 0xbf58476d1ce4e5b9ull;
+      seed ^= seed >> 31;
+    }
+    return static_cast<size_t>(seed);
   }
 };
 }  // namespace std
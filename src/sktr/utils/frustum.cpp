@@ -0,0 +1,155 @@
+#include "frustum.hpp"
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace sktr {
+
+Frustum Frustum::FromMatrix(const glm::mat4& matrix) {
+  auto row = [&](int i) {
+    return glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+  };
+  Frustum frustum;
+  frustum.planes[0] = row(3) + row(0);
+  frustum.planes[1] = row(3) - row(0);
+  frustum.planes[2] = row(3) + row(1);
+  frustum.planes[3] = row(3) - row(1);
+  frustum.planes[4] = row(2);
+  frustum.planes[5] = row(3) - row(2);
+  for (auto& plane : frustum.planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+  return frustum;
+}
+
+bool Frustum::Intersects(const glm::vec4& sphere) const {
+  for (const auto& plane : planes) {
+    float distance = (plane.x * sphere.x + plane.y * sphere.y) +
+                     (plane.z * sphere.z + plane.w);
+    if (!(distance + sphere.w > 0.0f)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SphereBoundsSoA::Clear() {
+  x.clear();
+  y.clear();
+  z.clear();
+  radius.clear();
+}
+
+void SphereBoundsSoA::Push(const glm::vec3& center, float r) {
+  x.push_back(center.x);
+  y.push_back(center.y);
+  z.push_back(center.z);
+  radius.push_back(r);
+}
+
+// [begin, end)逐个计算
+static uint32_t cullRange(const Frustum& frustum,
+                          const SphereBoundsSoA& spheres, size_t begin,
+                          size_t end, uint8_t* visible) {
+  uint32_t count = 0;
+  for (size_t i = begin; i < end; i++) {
+    bool inside = true;
+    for (const auto& plane : frustum.planes) {
+      // 和SIMD的计算顺序一致，结果相同
+      float distance = (plane.x * spheres.x[i] + plane.y * spheres.y[i]) +
+                       (plane.z * spheres.z[i] + plane.w);
+      inside = inside && distance + spheres.radius[i] > 0.0f;
+    }
+    visible[i] = inside;
+    count += inside;
+  }
+  return count;
+}
+
+uint32_t CullSpheresScalar(const Frustum& frustum,
+                           const SphereBoundsSoA& spheres, uint8_t* visible) {
+  return cullRange(frustum, spheres, 0, spheres.Size(), visible);
+}
+
+#if defined(__AVX__)
+
+uint32_t CullSpheres(const Frustum& frustum, const SphereBoundsSoA& spheres,
+                     uint8_t* visible) {
+  const size_t size = spheres.Size();
+  const size_t batched = size / 8 * 8;
+  uint32_t count = 0;
+  for (size_t i = 0; i < batched; i += 8) {
+    __m256 x = _mm256_loadu_ps(spheres.x.data() + i);
+    __m256 y = _mm256_loadu_ps(spheres.y.data() + i);
+    __m256 z = _mm256_loadu_ps(spheres.z.data() + i);
+    // distance > -r 即 distance + r > 0
+    __m256 r = _mm256_loadu_ps(spheres.radius.data() + i);
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (const auto& plane : frustum.planes) {
+      __m256 distance = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x),
+                        _mm256_mul_ps(_mm256_set1_ps(plane.y), y)),
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), z),
+                        _mm256_set1_ps(plane.w)));
+      inside = _mm256_and_ps(
+          inside, _mm256_cmp_ps(_mm256_add_ps(distance, r),
+                                _mm256_setzero_ps(), _CMP_GT_OQ));
+    }
+    int mask = _mm256_movemask_ps(inside);
+    for (int lane = 0; lane < 8; lane++) {
+      visible[i + lane] = (mask >> lane) & 1;
+      count += (mask >> lane) & 1;
+    }
+  }
+  return count + cullRange(frustum, spheres, batched, size, visible);
+}
+
+const char* CullSpheresIsa() { return "avx"; }
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+uint32_t CullSpheres(const Frustum& frustum, const SphereBoundsSoA& spheres,
+                     uint8_t* visible) {
+  const size_t size = spheres.Size();
+  const size_t batched = size / 4 * 4;
+  uint32_t count = 0;
+  for (size_t i = 0; i < batched; i += 4) {
+    __m128 x = _mm_loadu_ps(spheres.x.data() + i);
+    __m128 y = _mm_loadu_ps(spheres.y.data() + i);
+    __m128 z = _mm_loadu_ps(spheres.z.data() + i);
+    // distance > -r 即 distance + r > 0
+    __m128 r = _mm_loadu_ps(spheres.radius.data() + i);
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (const auto& plane : frustum.planes) {
+      __m128 distance =
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x),
+                                _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+                     _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), z),
+                                _mm_set1_ps(plane.w)));
+      inside = _mm_and_ps(
+          inside, _mm_cmpgt_ps(_mm_add_ps(distance, r), _mm_setzero_ps()));
+    }
+    int mask = _mm_movemask_ps(inside);
+    for (int lane = 0; lane < 4; lane++) {
+      visible[i + lane] = (mask >> lane) & 1;
+      count += (mask >> lane) & 1;
+    }
+  }
+  return count + cullRange(frustum, spheres, batched, size, visible);
+}
+
+const char* CullSpheresIsa() { return "sse"; }
+
+#else
+
+uint32_t CullSpheres(const Frustum& frustum, const SphereBoundsSoA& spheres,
+                     uint8_t* visible) {
+  return CullSpheresScalar(frustum, spheres, visible);
+}
+
+const char* CullSpheresIsa() { return "scalar"; }
+
+#endif
+
+}  // namespace sktr
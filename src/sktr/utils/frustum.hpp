@@ -0,0 +1,48 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 视锥的6个平面，xyz是归一化的朝内法线，dot(xyz, p) + w >= 0时在内侧
+ */
+struct Frustum {
+  glm::vec4 planes[6];
+
+  // 从mvp矩阵的行组合出平面(Gribb-Hartmann)，深度范围[0, 1]。
+  // 传入proj * view时平面在世界坐标下
+  static Frustum FromMatrix(const glm::mat4& matrix);
+  // 球心xyz，半径w，和CullSpheres的判断相同
+  bool Intersects(const glm::vec4& sphere) const;
+};
+
+/*
+ * SoA布局的包围球，每个分量连续存放，按SIMD宽度批量剔除
+ */
+struct SphereBoundsSoA {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+  std::vector<float> radius;
+
+  size_t Size() const { return x.size(); }
+  void Clear();
+  void Push(const glm::vec3& center, float r);
+};
+
+/**
+ * @brief  剔除一批包围球，和球心距离大于半径的任一平面外侧即不可见
+ * @note   编译时开启AVX时每次8个，SSE每次4个，剩下的和其他平台逐个计算
+ * @param  visible: 输出，每个球一个字节，1为可见
+ * @retval 可见的数量
+ */
+uint32_t CullSpheres(const Frustum& frustum, const SphereBoundsSoA& spheres,
+                     uint8_t* visible);
+// 不使用SIMD，用于对比
+uint32_t CullSpheresScalar(const Frustum& frustum,
+                           const SphereBoundsSoA& spheres, uint8_t* visible);
+// CullSpheres使用的指令集: "avx", "sse"或"scalar"
+const char* CullSpheresIsa();
+
+}  // namespace sktr
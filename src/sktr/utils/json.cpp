@@ -0,0 +1,273 @@
+#include "json.hpp"
+
+namespace sktr {
+
+static const Json NullJson;
+
+// 递归下降，嵌套深度不超过MaxDepth
+class JsonParser final {
+ public:
+  explicit JsonParser(std::string_view text) : text_(text) {}
+
+  Json ParseDocument() {
+    Json value = parseValue(0);
+    skipWhitespace();
+    if (pos_ != text_.size()) {
+      fail("unexpected trailing characters");
+    }
+    return value;
+  }
+
+ private:
+  static constexpr int MaxDepth = 256;
+
+  std::string_view text_;
+  size_t pos_ = 0;
+
+  [[noreturn]] void fail(const char* message) {
+    throw std::runtime_error("json: " + std::string(message) + " at offset " +
+                             std::to_string(pos_));
+  }
+
+  void skipWhitespace() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+            text_[pos_] == '\n' || text_[pos_] == '\r')) {
+      pos_++;
+    }
+  }
+
+  char peek() {
+    skipWhitespace();
+    if (pos_ >= text_.size()) {
+      fail("unexpected end of input");
+    }
+    return text_[pos_];
+  }
+
+  void expect(char c) {
+    if (peek() != c) {
+      fail("unexpected character");
+    }
+    pos_++;
+  }
+
+  bool consumeLiteral(std::string_view literal) {
+    if (text_.substr(pos_, literal.size()) != literal) {
+      return false;
+    }
+    pos_ += literal.size();
+    return true;
+  }
+
+  Json parseValue(int depth) {
+    if (depth > MaxDepth) {
+      fail("nesting too deep");
+    }
+    Json value;
+    char c = peek();
+    if (c == '{') {
+      value.type_ = Json::Type::eObject;
+      pos_++;
+      if (peek() == '}') {
+        pos_++;
+        return value;
+      }
+      while (true) {
+        if (peek() != '"') {
+          fail("expected object key");
+        }
+        value.keys_.push_back(parseString());
+        expect(':');
+        value.values_.push_back(parseValue(depth + 1));
+        if (peek() == ',') {
+          pos_++;
+          continue;
+        }
+        expect('}');
+        return value;
+      }
+    }
+    if (c == '[') {
+      value.type_ = Json::Type::eArray;
+      pos_++;
+      if (peek() == ']') {
+        pos_++;
+        return value;
+      }
+      while (true) {
+        value.values_.push_back(parseValue(depth + 1));
+        if (peek() == ',') {
+          pos_++;
+          continue;
+        }
+        expect(']');
+        return value;
+      }
+    }
+    if (c == '"') {
+      value.type_ = Json::Type::eString;
+      value.string_ = parseString();
+      return value;
+    }
+    if (consumeLiteral("true")) {
+      value.type_ = Json::Type::eBool;
+      value.bool_ = true;
+      return value;
+    }
+    if (consumeLiteral("false")) {
+      value.type_ = Json::Type::eBool;
+      return value;
+    }
+    if (consumeLiteral("null")) {
+      return value;
+    }
+    value.type_ = Json::Type::eNumber;
+    value.number_ = parseNumber();
+    return value;
+  }
+
+  double parseNumber() {
+    size_t start = pos_;
+    auto isNumberChar = [](char c) {
+      return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+             c == 'e' || c == 'E';
+    };
+    while (pos_ < text_.size() && isNumberChar(text_[pos_])) {
+      pos_++;
+    }
+    if (start == pos_) {
+      fail("unexpected character");
+    }
+    // strtod需要以'\0'结尾
+    std::string number(text_.substr(start, pos_ - start));
+    char* end = nullptr;
+    double result = std::strtod(number.c_str(), &end);
+    if (end != number.c_str() + number.size()) {
+      fail("invalid number");
+    }
+    return result;
+  }
+
+  uint32_t parseHex4() {
+    if (pos_ + 4 > text_.size()) {
+      fail("invalid unicode escape");
+    }
+    uint32_t code = 0;
+    for (int i = 0; i < 4; i++) {
+      char c = text_[pos_++];
+      code <<= 4;
+      if (c >= '0' && c <= '9') {
+        code |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        code |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        code |= c - 'A' + 10;
+      } else {
+        fail("invalid unicode escape");
+      }
+    }
+    return code;
+  }
+
+  static void appendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+      out += static_cast<char>(code);
+    } else if (code < 0x800) {
+      out += static_cast<char>(0xC0 | (code >> 6));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      out += static_cast<char>(0xE0 | (code >> 12));
+      out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (code >> 18));
+      out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  std::string parseString() {
+    expect('"');
+    std::string result;
+    while (true) {
+      if (pos_ >= text_.size()) {
+        fail("unterminated string");
+      }
+      char c = text_[pos_++];
+      if (c == '"') {
+        return result;
+      }
+      if (c != '\\') {
+        result += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) {
+        fail("unterminated string");
+      }
+      char escape = text_[pos_++];
+      switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+          result += escape;
+          break;
+        case 'b':
+          result += '\b';
+          break;
+        case 'f':
+          result += '\f';
+          break;
+        case 'n':
+          result += '\n';
+          break;
+        case 'r':
+          result += '\r';
+          break;
+        case 't':
+          result += '\t';
+          break;
+        case 'u': {
+          uint32_t code = parseHex4();
+          // UTF-16代理对
+          if (code >= 0xD800 && code < 0xDC00 &&
+              text_.substr(pos_, 2) == "\\u") {
+            pos_ += 2;
+            uint32_t low = parseHex4();
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          appendUtf8(result, code);
+          break;
+        }
+        default:
+          fail("invalid escape");
+      }
+    }
+  }
+};
+
+Json Json::Parse(std::string_view text) {
+  return JsonParser(text).ParseDocument();
+}
+
+bool Json::Has(std::string_view key) const {
+  return std::find(keys_.begin(), keys_.end(), key) != keys_.end();
+}
+
+const Json& Json::operator[](std::string_view key) const {
+  if (type_ != Type::eObject) {
+    return NullJson;
+  }
+  auto it = std::find(keys_.begin(), keys_.end(), key);
+  return it == keys_.end() ? NullJson : values_[it - keys_.begin()];
+}
+
+const Json& Json::operator[](size_t index) const {
+  if (type_ != Type::eArray || index >= values_.size()) {
+    return NullJson;
+  }
+  return values_[index];
+}
+
+}  // namespace sktr
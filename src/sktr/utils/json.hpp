@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string_view>
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 只读的最小JSON DOM，用于解析glTF
+ *
+ * 对象按出现顺序保存键值，查找是线性的，glTF中的对象都很小。
+ * 访问不存在的键或越界的下标返回null值，不抛异常
+ */
+class Json final {
+ public:
+  enum class Type { eNull, eBool, eNumber, eString, eArray, eObject };
+
+  // 语法错误时抛出std::runtime_error
+  static Json Parse(std::string_view text);
+
+  Type GetType() const { return type_; }
+  bool IsNull() const { return type_ == Type::eNull; }
+  bool IsNumber() const { return type_ == Type::eNumber; }
+  bool IsString() const { return type_ == Type::eString; }
+  bool IsArray() const { return type_ == Type::eArray; }
+  bool IsObject() const { return type_ == Type::eObject; }
+
+  bool AsBool(bool fallback = false) const {
+    return type_ == Type::eBool ? bool_ : fallback;
+  }
+  double AsNumber(double fallback = 0.0) const {
+    return type_ == Type::eNumber ? number_ : fallback;
+  }
+  int64_t AsInt(int64_t fallback = 0) const {
+    return type_ == Type::eNumber ? static_cast<int64_t>(number_) : fallback;
+  }
+  const std::string& AsString() const { return string_; }
+
+  // 数组的元素个数或对象的键值个数
+  size_t Size() const { return values_.size(); }
+  bool Has(std::string_view key) const;
+  const Json& operator[](std::string_view key) const;
+  const Json& operator[](size_t index) const;
+
+ private:
+  Type type_ = Type::eNull;
+  bool bool_ = false;
+  double number_ = 0.0;
+  std::string string_;
+  // 数组和对象的值，对象的键在keys_中一一对应
+  std::vector<Json> values_;
+  std::vector<std::string> keys_;
+
+  friend class JsonParser;
+};
+
+}  // namespace sktr
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+// 只读的文件内存映射，映射失败时为空
+class MappedFile final {
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  const uint8_t* Data() const { return data_; }
+  size_t Size() const { return size_; }
+  operator bool() const { return data_ != nullptr; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+
+  void close();
+};
+
+}  // namespace sktr
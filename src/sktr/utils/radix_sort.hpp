@@ -0,0 +1,54 @@
+#pragma once
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+/*
+ * 按元素的64位key成员从小到大排序，稳定
+ *
+ * LSD基数排序，每趟8位。先一次遍历统计所有8个字节的直方图，
+ * 所有元素在某个字节上相同时跳过这一趟，key的高位常常只有几种取值。
+ * scratch是排序用的临时空间，跨帧复用可以避免分配
+ */
+template <typename T>
+void RadixSortByKey(std::vector<T>& items, std::vector<T>& scratch) {
+  const size_t count = items.size();
+  if (count < 2) {
+    return;
+  }
+  scratch.resize(count);
+
+  std::array<std::array<uint32_t, 256>, 8> histograms{};
+  for (const auto& item : items) {
+    for (int pass = 0; pass < 8; pass++) {
+      histograms[pass][(item.key >> (pass * 8)) & 0xFF]++;
+    }
+  }
+
+  T* src = items.data();
+  T* dst = scratch.data();
+  for (int pass = 0; pass < 8; pass++) {
+    auto& histogram = histograms[pass];
+    const int shift = pass * 8;
+    if (histogram[(src[0].key >> shift) & 0xFF] == count) {
+      continue;
+    }
+    uint32_t offset = 0;
+    for (auto& bucket : histogram) {
+      uint32_t size = bucket;
+      bucket = offset;
+      offset += size;
+    }
+    for (size_t i = 0; i < count; i++) {
+      dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  // 奇数趟时结果在scratch中
+  if (src != items.data()) {
+    items.swap(scratch);
+  }
+}
+
+}  // namespace sktr
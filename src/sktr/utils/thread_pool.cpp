@@ -0,0 +1,72 @@
+#include "thread_pool.hpp"
+
+namespace sktr {
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+  if (threadCount == 0) {
+    threadCount = HardwareThreads();
+  }
+  if (threadCount <= 1) {
+    return;
+  }
+  workers_.reserve(threadCount);
+  for (uint32_t i = 0; i < threadCount; i++) {
+    workers_.emplace_back([this] { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  taskCv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      taskCv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (stop_ && tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_--;
+    }
+    doneCv_.notify_all();
+  }
+}
+
+void ThreadPool::ParallelFor(uint32_t count,
+                             const std::function<void(uint32_t)>& func) {
+  if (workers_.empty() || count <= 1) {
+    for (uint32_t i = 0; i < count; i++) {
+      func(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t i = 0; i < count; i++) {
+      tasks_.push_back([&func, i] { func(i); });
+    }
+    pending_ += count;
+  }
+  taskCv_.notify_all();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  doneCv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+}  // namespace sktr
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "sktr/pch.hpp"
+
+namespace sktr {
+
+// 固定数量worker的线程池，只用于加载阶段的数据并行
+class ThreadPool final {
+ public:
+  // threadCount为0时使用全部硬件线程，为1时不创建线程直接在调用线程上执行
+  explicit ThreadPool(uint32_t threadCount = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  uint32_t ThreadCount() const {
+    return std::max<uint32_t>(1, static_cast<uint32_t>(workers_.size()));
+  }
+
+  // 对[0, count)的每个下标调用一次func，阻塞直到全部完成
+  void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+  static uint32_t HardwareThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable taskCv_;
+  std::condition_variable doneCv_;
+  uint32_t pending_ = 0;
+  bool stop_ = false;
+
+  void workerLoop();
+};
+
+}  // namespace sktr
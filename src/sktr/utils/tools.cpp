@@ -24,21 +24,17 @@ std::string ReadWholeFile(const std::string& filename) {
 
 uint32_t QueryMemoryTypeIndex(uint32_t memoryTypeBits,
                               vk::MemoryPropertyFlags propertyFlags) {
-  std::optional<uint32_t> typeIndex;
-  // 寻找内存类型
-  auto properties = Context::GetInstance().phyDevice.getMemoryProperties();
+  // 寻找包含所有属性的内存类型
+  const auto& properties = Context::GetInstance().memoryProperties;
 
-  for (int i = 0; i < properties.memoryTypeCount; i++) {
-    if ((1 << i) & memoryTypeBits &&
-        properties.memoryTypes[i].propertyFlags & propertyFlags) {
-      typeIndex = i;
-      break;
+  for (uint32_t i = 0; i < properties.memoryTypeCount; i++) {
+    if ((1u << i) & memoryTypeBits &&
+        (properties.memoryTypes[i].propertyFlags & propertyFlags) ==
+            propertyFlags) {
+      return i;
     }
   }
-  if (!typeIndex.has_value()) {
-    std::cout << "MemoryInfo.index not find" << std::endl;
-  }
-  return typeIndex.value();
+  throw std::runtime_error("failed to find suitable memory type!");
 }
 
 vk::Format findSupportedFormat(const std::vector<vk::Format>& candidates,
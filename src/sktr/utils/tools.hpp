@@ -30,8 +30,8 @@ void RemoveNosupportedElems(std::vector<T>& elems,
 std::string ReadWholeFile(const std::string& filename);
 
 /**
- * @brief
- * @note
+ * @brief  第一个包含flags中所有属性的内存类型
+ * @note   没有时抛出异常。按用途选择时使用MemoryTypePolicy
  * @param  bits: requirement type bits
  * @param  flags: memory property flags
  * @retval